@@ -8,9 +8,11 @@
 #endif
 #include "global.h"
 #include "glcd.h"
+#include "ks0108.h"
 #include "monomain.h"
 #ifdef EMULIN
 #include "emulator/controller.h"
+#include "emulator/profile.h"
 #endif
 #include "anim.h"
 
@@ -416,15 +418,22 @@ void animClockDraw(u08 mode)
     mcTickerSnooze = almTickerSnooze;
   }
 
-  // Have the clock initialize or update itself
+  // Have the clock initialize or update itself in an lcd frame
   if (clockDriver->clockId != CHRON_NONE)
   {
+    glcdBeginFrame();
     glcdColorSetFg();
     if (mode == DRAW_CYCLE)
     {
       // Update clock and sync old date/time to current for next comparison
+#ifdef EMULIN
+      profCycleBegin();
+#endif
       animAlarmSwitchCheck();
       clockDriver->cycle();
+#ifdef EMULIN
+      profCycleLcd();
+#endif
       if (mcClockTimeEvent == MC_TRUE)
         animDateTimeCopy();
 
@@ -456,6 +465,11 @@ void animClockDraw(u08 mode)
       mcClockInit = MC_TRUE;
       clockDriver->init(mode);
     }
+    glcdEndFrame();
+#ifdef EMULIN
+    if (mode == DRAW_CYCLE)
+      profCycleEnd();
+#endif
   }
   else
   {
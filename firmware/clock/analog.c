@@ -3,11 +3,11 @@
 // Title    : Animation code for MONOCHRON analog clock
 //*****************************************************************************
 
-#include <math.h>
 #include "../global.h"
 #include "../glcd.h"
 #include "../anim.h"
 #include "../monomain.h"
+#include "../trig.h"
 #include "analog.h"
 
 // Specifics for analog clock main dial
@@ -22,12 +22,12 @@
 #define ANA_SEC_LEG_RADIUS		(ANA_RADIUS - 7.0)
 #define ANA_MIN_LEG_RADIUS		8
 #define ANA_HOUR_LEG_RADIUS		5
-#define ANA_SEC_STEPS			60.0
-#define ANA_MIN_STEPS			60.0
-#define ANA_HOUR_STEPS			12.0
-#define ANA_SEC_LEG_RADIAL_OFFSET	(0.1)
-#define ANA_MIN_LEG_RADIAL_OFFSET	(2.0 * M_PI / 2.5)
-#define ANA_HOUR_LEG_RADIAL_OFFSET	(2.0 * M_PI / 2.5)
+#define ANA_SEC_STEPS			60
+#define ANA_MIN_STEPS			60
+#define ANA_HOUR_STEPS			12
+#define ANA_SEC_LEG_ANGLE_OFFSET	1043	// 0.1 radial
+#define ANA_MIN_LEG_ANGLE_OFFSET	TRIG_ANGLE(2, 5)
+#define ANA_HOUR_LEG_ANGLE_OFFSET	TRIG_ANGLE(2, 5)
 
 // Specifics for alarm and date element areas
 #define ANA_ALARM_X_START		118
@@ -73,8 +73,8 @@ extern volatile uint8_t mcU8Util3;
 
 // Local function prototypes
 static void analogAlarmAreaUpdate(void);
-static u08 analogElementCalc(s08 position[], s08 positionNew[], float radial,
-  float radialOffset, u08 arrowRadius, u08 legRadius, u08 legsCheck);
+static u08 analogElementCalc(s08 position[], s08 positionNew[], u16 angle,
+  u16 angleOffset, u08 arrowRadius, u08 legRadius, u08 legsCheck);
 static void analogElementDraw(s08 position[]);
 static void analogElementSync(s08 position[], s08 positionNew[]);
 static void analogInit(u08 mode);
@@ -120,7 +120,7 @@ void analogCycle(void)
   }
 
   // Local data
-  float radElement;
+  u16 angleElement;
   s08 posSecNew[6], posMinNew[6], posHourNew[6];
   u08 secElementChanged = MC_FALSE;
   u08 minElementChanged = MC_FALSE;
@@ -135,27 +135,27 @@ void analogCycle(void)
     if (ANA_SEC_MOVE == 0)
     {
       // Move at time event (once per second or init)
-      radElement = (2.0 * M_PI / ANA_SEC_STEPS) * (float)mcClockNewTS;
+      angleElement = TRIG_ANGLE(mcClockNewTS, ANA_SEC_STEPS);
     }
     else
     {
       // Move when leg position changes
-      radElement = (2.0 * M_PI / ANA_SEC_STEPS) * (float)mcClockNewTS +
-        (2.0 * M_PI / ANA_SEC_STEPS / (1000.0 / ANIM_TICK_CYCLE_MS + 0.5)) *
-        mcU8Util2;
+      angleElement = TRIG_ANGLE(mcClockNewTS, ANA_SEC_STEPS) +
+        (u16)(TRIG_ANGLE_FULL / ANA_SEC_STEPS /
+        (1000.0 / ANIM_TICK_CYCLE_MS + 0.5) + 0.5) * mcU8Util2;
     }
 
     if (ANA_SEC_TYPE == 0)
     {
       // Needle indicator
-      secElementChanged = analogElementCalc(posSec, posSecNew, radElement,
-        0.0, ANA_SEC_RADIUS_LINE, 0, 2);
+      secElementChanged = analogElementCalc(posSec, posSecNew, angleElement,
+        0, ANA_SEC_RADIUS_LINE, 0, 2);
     }
     else
     {
       // Floating arrow indicator
-      secElementChanged = analogElementCalc(posSec, posSecNew, radElement,
-        ANA_SEC_LEG_RADIAL_OFFSET, ANA_SEC_RADIUS_ARROW, ANA_SEC_LEG_RADIUS, 6);
+      secElementChanged = analogElementCalc(posSec, posSecNew, angleElement,
+        ANA_SEC_LEG_ANGLE_OFFSET, ANA_SEC_RADIUS_ARROW, ANA_SEC_LEG_RADIUS, 6);
     }
   }
 
@@ -165,16 +165,16 @@ void analogCycle(void)
     if (ANA_MIN_MOVE == 0)
     {
       // Move once per minute
-      radElement = (2.0 * M_PI / ANA_MIN_STEPS) * (float)mcClockNewTM;
+      angleElement = TRIG_ANGLE(mcClockNewTM, ANA_MIN_STEPS);
     }
     else
     {
       // Move when tip position changes
-      radElement = (2.0 * M_PI / ANA_MIN_STEPS) * (float)mcClockNewTM  +
-        (2.0 * M_PI / ANA_SEC_STEPS / ANA_MIN_STEPS) * (float)mcClockNewTS;
+      angleElement = TRIG_ANGLE(mcClockNewTM, ANA_MIN_STEPS) +
+        TRIG_ANGLE(mcClockNewTS, ANA_SEC_STEPS * ANA_MIN_STEPS);
     }
-    minElementChanged = analogElementCalc(posMin, posMinNew, radElement,
-      ANA_MIN_LEG_RADIAL_OFFSET, ANA_MIN_RADIUS, ANA_MIN_LEG_RADIUS, 2);
+    minElementChanged = analogElementCalc(posMin, posMinNew, angleElement,
+      ANA_MIN_LEG_ANGLE_OFFSET, ANA_MIN_RADIUS, ANA_MIN_LEG_RADIUS, 2);
 
     // Calculate (potential) changes in hour arrow. In normal operation only
     // change the hour arrow if the minute arrow moves as well.
@@ -182,10 +182,10 @@ void analogCycle(void)
     if (minElementChanged == MC_TRUE || mcClockOldTH != mcClockNewTH ||
         mcClockInit == MC_TRUE)
     {
-      radElement = (2.0 * M_PI / ANA_HOUR_STEPS) * (float)(mcClockNewTH % 12) +
-        (2.0 * M_PI / ANA_MIN_STEPS / ANA_HOUR_STEPS) * (float)mcClockNewTM;
-      hourElementChanged = analogElementCalc(posHour, posHourNew, radElement,
-        ANA_HOUR_LEG_RADIAL_OFFSET, ANA_HOUR_RADIUS, ANA_HOUR_LEG_RADIUS, 6);
+      angleElement = TRIG_ANGLE(mcClockNewTH % 12, ANA_HOUR_STEPS) +
+        TRIG_ANGLE(mcClockNewTM, ANA_MIN_STEPS * ANA_HOUR_STEPS);
+      hourElementChanged = analogElementCalc(posHour, posHourNew, angleElement,
+        ANA_HOUR_LEG_ANGLE_OFFSET, ANA_HOUR_RADIUS, ANA_HOUR_LEG_RADIUS, 6);
     }
   }
 
@@ -287,16 +287,16 @@ static void analogAlarmAreaUpdate(void)
     {
       // Show alarm time in small clock
       s08 dxM, dyM, dxH, dyH;
-      float radM, radH;
+      u16 angleM, angleH;
 
       // Prepare the analog alarm clock
-      radM = (2.0 * M_PI / ANA_MIN_STEPS) * (float)mcAlarmM;
-      dxM = (s08)(sin(radM) * ANA_ALARM_MIN_RADIUS);
-      dyM = (s08)(-cos(radM) * ANA_ALARM_MIN_RADIUS);
-      radH = (2.0 * M_PI / ANA_HOUR_STEPS) * (float)(mcAlarmH % 12) +
-        (2.0 * M_PI / ANA_MIN_STEPS / ANA_HOUR_STEPS) * (float)mcAlarmM;
-      dxH = (s08)(sin(radH) * ANA_ALARM_HOUR_RADIUS);
-      dyH = (s08)(-cos(radH) * ANA_ALARM_HOUR_RADIUS);
+      angleM = TRIG_ANGLE(mcAlarmM, ANA_MIN_STEPS);
+      dxM = trigSinMul(angleM, ANA_ALARM_MIN_RADIUS);
+      dyM = -trigCosMul(angleM, ANA_ALARM_MIN_RADIUS);
+      angleH = TRIG_ANGLE(mcAlarmH % 12, ANA_HOUR_STEPS) +
+        TRIG_ANGLE(mcAlarmM, ANA_MIN_STEPS * ANA_HOUR_STEPS);
+      dxH = trigSinMul(angleH, ANA_ALARM_HOUR_RADIUS);
+      dyH = -trigCosMul(angleH, ANA_ALARM_HOUR_RADIUS);
 
       // Show the alarm time
       glcdCircle2(ANA_ALARM_X_START, ANA_ALARM_Y_START, ANA_ALARM_RADIUS,
@@ -334,18 +334,18 @@ static void analogAlarmAreaUpdate(void)
 //
 // Calculate the position of a needle or three points of an analog clock arrow
 //
-static u08 analogElementCalc(s08 position[], s08 positionNew[], float radial,
-  float radialOffset, u08 arrowRadius, u08 legRadius, u08 legsCheck)
+static u08 analogElementCalc(s08 position[], s08 positionNew[], u16 angle,
+  u16 angleOffset, u08 arrowRadius, u08 legRadius, u08 legsCheck)
 {
   u08 i;
 
   // Calculate the new position of a needle or each of the three arrow points
-  positionNew[0] = (s08)(sin(radial) * arrowRadius) + ANA_X_START;
-  positionNew[1] = (s08)(-cos(radial) * arrowRadius) + ANA_Y_START;
-  positionNew[2] = (s08)(sin(radial + radialOffset) * legRadius) + ANA_X_START;
-  positionNew[3] = (s08)(-cos(radial + radialOffset) * legRadius) + ANA_Y_START;
-  positionNew[4] = (s08)(sin(radial - radialOffset) * legRadius) + ANA_X_START;
-  positionNew[5] = (s08)(-cos(radial - radialOffset) * legRadius) + ANA_Y_START;
+  positionNew[0] = trigSinMul(angle, arrowRadius) + ANA_X_START;
+  positionNew[1] = -trigCosMul(angle, arrowRadius) + ANA_Y_START;
+  positionNew[2] = trigSinMul(angle + angleOffset, legRadius) + ANA_X_START;
+  positionNew[3] = -trigCosMul(angle + angleOffset, legRadius) + ANA_Y_START;
+  positionNew[4] = trigSinMul(angle - angleOffset, legRadius) + ANA_X_START;
+  positionNew[5] = -trigCosMul(angle - angleOffset, legRadius) + ANA_Y_START;
 
   // Provide info if the needle or arrow has changed position
   for (i = 0; i < legsCheck; i++)
@@ -417,8 +417,10 @@ static void analogInit(u08 mode)
     for (i = 0; i < 12; i++)
     {
       // The 5-minute markers
-      dxDot = (s08)(sin(2.0 * M_PI / 12.0 * i) * ANA_DOT_RADIUS);
-      dyDot = (s08)(-cos(2.0 * M_PI / 12.0 * i) * ANA_DOT_RADIUS);
+      dxDot = TRIG_Q88_INT(trigSinMul(TRIG_ANGLE(i, 12),
+        TRIG_Q88(ANA_DOT_RADIUS)));
+      dyDot = TRIG_Q88_INT(-trigCosMul(TRIG_ANGLE(i, 12),
+        TRIG_Q88(ANA_DOT_RADIUS)));
       glcdDot(ANA_X_START + dxDot, ANA_Y_START + dyDot);
 
       // The additional 15-minute markers
@@ -9,6 +9,7 @@
 // https://www.jwz.org/xdaliclock
 // https://github.com/CaitSith2/monochron/tree/MultiChron/firmware
 
+#include <string.h>
 #include "../global.h"
 #include "../glcd.h"
 #include "../anim.h"
@@ -373,70 +374,93 @@ static void daliTrans(void)
 //
 // Function: daliTransDigit
 //
-// For a single clock digit generate and draw a single transition bitmap
+// For a single clock digit generate and draw a single transition bitmap.
+// As only part of a digit changes between consecutive transition steps, only
+// the changed digit bitmap bytes compared to the previous transition step are
+// drawn. The initial transition step draws all digit bitmap bytes.
 //
 static void daliTransDigit(u08 x, u08 oldVal, u08 newVal)
 {
-  u08 lineOld[DALI_DIGITS], lineNew[DALI_DIGITS], i, j, line;
+  u08 lineOld[DALI_DIGITS], lineNew[DALI_DIGITS], i, j, k, line;
   u08 segLineOld, segLineNew;
   u08 segMain;
   u08 segOld[2], segNew[2];
-  u08 bitmap[DALI_DIGIT_HEIGHT / 8 * DALI_DIGIT_WIDTH] = {0};
-  u08 y = DALI_DISP_DIGIT_Y_LINE;
+  u08 bitmap[2][DALI_DIGIT_WIDTH];
+  u08 steps = (genStep == 0 ? 1 : 2);
+  u08 addrSet;
+  u08 y;
   uint16_t segMerge[2];
 
-  // For each vertical line determine a horizontal transition line
-  for (line = 0; line < DALI_DIGIT_HEIGHT; line++)
+  // Generate the digit bitmap per 8 vertical lines for the current and the
+  // previous transition step
+  for (y = 0; y < DALI_DIGIT_HEIGHT / 8; y++)
   {
-    // Get the font info for the old and new digit
-    if (oldVal == MAX_U08)
-    {
-      lineOld[0] = lineOld[1] = lineOld[2] = lineOld[3] = 0;
-      segLineOld = 2;
-    }
-    else
-    {
-      daliFontLineRead(oldVal, line, lineOld, &segLineOld);
-    }
-    daliFontLineRead(newVal, line, lineNew, &segLineNew);
-    segMain = MAX(segLineOld, segLineNew);
+    memset(bitmap, 0, sizeof(bitmap));
 
-    // Merge the segments from the old and new digit
-    for (i = 0; i < segMain; i++)
+    // For each vertical line determine a horizontal transition line
+    for (line = y * 8; line < y * 8 + 8; line++)
     {
-      // Merge the segments of a single old and new digit line
-      daliLineToSegment(i, lineOld, segOld);
-      daliLineToSegment(i, lineNew, segNew);
-      for (j = 0; j < 2; j++)
+      // Get the font info for the old and new digit
+      if (oldVal == MAX_U08)
+      {
+        lineOld[0] = lineOld[1] = lineOld[2] = lineOld[3] = 0;
+        segLineOld = 2;
+      }
+      else
       {
-        segMerge[j] = (segNew[j] - segOld[j]) * genStep + DALI_GEN_CYCLES / 2;
-        segMerge[j] = (segMerge[j] / DALI_GEN_CYCLES + segOld[j]) & 0xff;
+        daliFontLineRead(oldVal, line, lineOld, &segLineOld);
       }
+      daliFontLineRead(newVal, line, lineNew, &segLineNew);
+      segMain = MAX(segLineOld, segLineNew);
 
-      // Save the merged segments in the final merge digit bitmap
-      while (segMerge[0] < segMerge[1])
+      // Merge the segments from the old and new digit
+      for (i = 0; i < segMain; i++)
       {
-        bitmap[segMerge[0] + (line / 8) * DALI_DIGIT_WIDTH] |= _BV(line % 8);
-        segMerge[0]++;
+        // Merge the segments of a single old and new digit line for the
+        // current and previous transition step, and save the merged segments
+        // in the merge digit bitmaps
+        daliLineToSegment(i, lineOld, segOld);
+        daliLineToSegment(i, lineNew, segNew);
+        for (k = 0; k < steps; k++)
+        {
+          for (j = 0; j < 2; j++)
+          {
+            segMerge[j] = (segNew[j] - segOld[j]) * (genStep - k) +
+              DALI_GEN_CYCLES / 2;
+            segMerge[j] = (segMerge[j] / DALI_GEN_CYCLES + segOld[j]) & 0xff;
+          }
+          while (segMerge[0] < segMerge[1])
+          {
+            bitmap[k][segMerge[0]] |= _BV(line % 8);
+            segMerge[0]++;
+          }
+        }
       }
     }
-  }
 
-  // Draw the merged 28x64 font digit bitmap
-  for (i = 0; i < DALI_DIGIT_HEIGHT / 8 * DALI_DIGIT_WIDTH; i++)
-  {
-    if (i % DALI_DIGIT_WIDTH == 0)
+    // Draw the changed bitmap bytes of the merged 28x64 font digit bitmap
+    addrSet = MC_FALSE;
+    for (i = 0; i < DALI_DIGIT_WIDTH; i++)
     {
-      // Set cursor at start of new y-line
-      glcdSetAddress(x, y);
-      y++;
+      if (steps == 2 && bitmap[0][i] == bitmap[1][i])
+      {
+        // Unchanged bitmap byte so skip it
+        addrSet = MC_FALSE;
+        continue;
+      }
+      if (addrSet == MC_FALSE)
+      {
+        // Set cursor at changed bitmap byte
+        glcdSetAddress(x + i, DALI_DISP_DIGIT_Y_LINE + y);
+        addrSet = MC_TRUE;
+      }
+      // Write bitmap byte
+      j = bitmap[0][i];
+      if (mcFgColor == GLCD_OFF)
+        glcdDataWrite(~j);
+      else
+        glcdDataWrite(j);
     }
-    // Write bitmap byte
-    j = bitmap[i];
-    if (mcFgColor == GLCD_OFF)
-      glcdDataWrite(~j);
-    else
-      glcdDataWrite(j);
   }
 }
 
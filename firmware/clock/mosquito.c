@@ -8,6 +8,8 @@
 #include "../glcd.h"
 #include "../anim.h"
 #include "../ks0108conf.h"
+#include "../sprite.h"
+#include "../trig.h"
 #include "mosquito.h"
 
 // Info on hr/min/sec elements of mosquito clock
@@ -27,6 +29,11 @@
 #define MOS_HOUR_X_WIDTH	15
 #define MOS_TIME_Y_WIDTH	15
 
+// Max sprite width and sprite height of a time element. The sprite holds the
+// element value on top of the element text, both with a border.
+#define MOS_SPRITE_W_MAX	17
+#define MOS_SPRITE_H		15
+
 // Element speed and angle
 #define MOS_ELEMENT_SPEED	1.5
 #define MOS_DIRECTION_ANGLE_MIN	10
@@ -51,6 +58,8 @@ typedef struct
   float dy;		// The y delta per move step
   s08 textOffset;	// The relative x starting point of element text
   char *text;		// The element text (hour/min/sec)
+  u08 spriteId;		// The sprite id of the element
+  uint16_t bitmap[MOS_SPRITE_W_MAX]; // The sprite bitmap of the element
 } timeElement_t;
 
 // Monochron environment variables
@@ -100,7 +109,10 @@ static timeElement_t elementHour;
 static void mosquitoDirectionSet(void);
 static void mosquitoElementDirectionSet(timeElement_t *element);
 static void mosquitoElementDraw(timeElement_t *element, u08 value);
-static void mosquitoElementMovePrep(timeElement_t *element);
+static void mosquitoElementMove(timeElement_t *element);
+static void mosquitoElementRegister(timeElement_t *element, u08 value,
+  u08 z);
+static u08 mosquitoElementRender(timeElement_t *element, u08 value);
 
 //
 // Function: mosquitoCycle
@@ -132,28 +144,28 @@ void mosquitoCycle(void)
     if (elementSec.startDelay > 0)
       elementSec.startDelay--;
     else
-      mosquitoElementMovePrep(&elementSec);
+      mosquitoElementMove(&elementSec);
 
     if (elementMin.startDelay > 0)
       elementMin.startDelay--;
     else
-      mosquitoElementMovePrep(&elementMin);
+      mosquitoElementMove(&elementMin);
 
     if (elementHour.startDelay > 0)
       elementHour.startDelay--;
     else
-      mosquitoElementMovePrep(&elementHour);
+      mosquitoElementMove(&elementHour);
   }
 
-  // Redraw all time elements regardless whether changed or not to
-  // countereffect distorted elements that are overlapped by others
-  if ((mcCycleCounter & 1) == 1 || mcClockTimeEvent == MC_TRUE ||
-      mcClockInit == MC_TRUE)
+  // Update the time element values. The sprite engine takes care of elements
+  // that overlap one another.
+  if (mcClockTimeEvent == MC_TRUE)
   {
     mosquitoElementDraw(&elementSec, mcClockNewTS);
     mosquitoElementDraw(&elementMin, mcClockNewTM);
     mosquitoElementDraw(&elementHour, mcClockNewTH);
   }
+  spriteFlush();
 }
 
 //
@@ -173,6 +185,14 @@ void mosquitoInit(u08 mode)
   elementMin = elementMinInit;
   elementHour = elementHourInit;
 
+  // Register the time element sprites where hour is on top and sec is at the
+  // bottom
+  spriteReset();
+  mosquitoElementRegister(&elementSec, mcClockNewTS, 0);
+  mosquitoElementRegister(&elementMin, mcClockNewTM, 1);
+  mosquitoElementRegister(&elementHour, mcClockNewTH, 2);
+  spriteFlush();
+
   // Init the initial direction of each element
   mosquitoDirectionSet();
 }
@@ -196,7 +216,6 @@ static void mosquitoDirectionSet(void)
 //
 static void mosquitoElementDirectionSet(timeElement_t *element)
 {
-  float elementRad;
   u16 angle;
 
   // Generate a random number of most likely abysmal quality
@@ -208,53 +227,32 @@ static void mosquitoElementDirectionSet(timeElement_t *element)
     MOS_DIRECTION_ANGLE_MIN;
 
   // New direction for the time element by putting angle in a quadrant
-  elementRad = (float)(angle + 90 * (((mosRandVal >> 3) + angle) % 4)) /
-    180L * M_PI;
-  element->dx = sin(elementRad) * MOS_ELEMENT_SPEED;
-  element->dy = -cos(elementRad) * MOS_ELEMENT_SPEED;
+  angle = TRIG_ANGLE(angle + 90 * (((mosRandVal >> 3) + angle) % 4), 360);
+  element->dx = trigSinMul(angle, TRIG_Q88(MOS_ELEMENT_SPEED)) / 256.0;
+  element->dy = -trigCosMul(angle, TRIG_Q88(MOS_ELEMENT_SPEED)) / 256.0;
 }
 
 //
 // Function: mosquitoElementDraw
 //
-// Draw time element in mosquito clock
+// Update the value of a time element in mosquito clock
 //
 static void mosquitoElementDraw(timeElement_t *element, u08 value)
 {
-  char msg[3];
-  u08 pxDone;
-
-  animValToStr(value, msg);
-
-  // Draw element value with border around element value
-  glcdPutStr2(element->posX, element->posY, FONT_5X7M, msg);
-  glcdColorSetBg();
-  glcdRectangle(element->posX - 1, element->posY - 1, 13, 9);
-  glcdColorSetFg();
-
-  // Draw element text with border around element text
-  pxDone = glcdPutStr2(element->posX + element->textOffset,
-    element->posY + MOS_TXT_Y_OFFSET, FONT_5X5P, element->text);
-  glcdColorSetBg();
-  glcdRectangle(element->posX + element->textOffset - 1,
-    element->posY + MOS_TXT_Y_OFFSET - 1, pxDone + 1, 7);
-  glcdColorSetFg();
+  mosquitoElementRender(element, value);
+  spriteBitmapSet(element->spriteId, element->bitmap);
 }
 
 //
-// Function: mosquitoElementMovePrep
+// Function: mosquitoElementMove
 //
-// Set new position of element in mosquito clock and remove stuff that won't be
-// overwritten by the element redraw
+// Set new position of element in mosquito clock. The sprite engine restores
+// the lcd area that is no longer covered by the element.
 //
-static void mosquitoElementMovePrep(timeElement_t *element)
+static void mosquitoElementMove(timeElement_t *element)
 {
-  s08 dx, dy;
-  u08 posX = element->posX;
-  u08 posY = element->posY;
-  u08 width = element->width;
   s08 textOffset = element->textOffset;
-  u08 textPosX = posX + textOffset;
+  u08 width = element->width;
   float mathPosXNew = element->mathPosX + element->dx;
   float mathPosYNew = element->mathPosY + element->dy;
 
@@ -284,42 +282,58 @@ static void mosquitoElementMovePrep(timeElement_t *element)
     element->dy = -element->dy;
   }
 
-  // Clear parts that are to be removed upon redraw
-  dx = (s08)mathPosXNew - (s08)posX;
-  dy = (s08)mathPosYNew - (s08)posY;
-
-  glcdColorSetBg();
-  if (dx > 1)
-  {
-    // Clear left side of element value and text
-    glcdFillRectangle(posX, posY, (u08)(dx - 1), 7);
-    glcdFillRectangle(textPosX, posY + 8, (u08)(dx - 1), 5);
-  }
-  else if (dx < -1)
-  {
-    // Clear right side of element value and text
-    glcdFillRectangle((u08)(posX + 12 + dx), posY, (u08)(-dx - 1), 7);
-    glcdFillRectangle((u08)(textPosX + width + dx + 1), posY + 8,
-      (u08)(-dx - 1), 5);
-  }
-  if (dy > 1)
-  {
-    // Clear top side of element value and text
-    glcdFillRectangle(posX, posY, 11, (u08)(dy - 1));
-    glcdFillRectangle(textPosX, posY + 8, width, (u08)(dy - 1));
-  }
-  else if (dy < -1)
-  {
-    // Clear bottom side of element value and text
-    glcdFillRectangle(posX, posY + 8 + dy, 11, (u08)(-dy - 1));
-    glcdFillRectangle(textPosX, (u08)(posY + 13 - (-dy - 1)), width,
-      (u08)(-dy - 1));
-  }
-  glcdColorSetFg();
-
-  // Sync new position of element
+  // Sync new position of element and its sprite
   element->posX = (u08)mathPosXNew;
   element->posY = (u08)mathPosYNew;
   element->mathPosX = mathPosXNew;
   element->mathPosY = mathPosYNew;
+  spriteMove(element->spriteId, element->posX + textOffset - 1,
+    element->posY - 1);
+}
+
+//
+// Function: mosquitoElementRegister
+//
+// Register the sprite of a time element in mosquito clock
+//
+static void mosquitoElementRegister(timeElement_t *element, u08 value, u08 z)
+{
+  u08 width;
+
+  width = mosquitoElementRender(element, value);
+  element->spriteId = spriteRegister(element->posX + element->textOffset - 1,
+    element->posY - 1, width, MOS_SPRITE_H, z, ELM_WORD, DATA_RAM,
+    element->bitmap);
+}
+
+//
+// Function: mosquitoElementRender
+//
+// Render the value and text of a time element in its sprite bitmap and return
+// the sprite width. The value and text each get a border in the background
+// color.
+//
+static u08 mosquitoElementRender(timeElement_t *element, u08 value)
+{
+  char msg[3];
+  u08 columns[MOS_SPRITE_W_MAX];
+  u08 valueX = 1 - element->textOffset;
+  u08 width;
+  u08 i;
+
+  animValToStr(value, msg);
+  for (i = 0; i < MOS_SPRITE_W_MAX; i++)
+    element->bitmap[i] = 0;
+
+  // Element value in sprite pixel rows 1..7
+  width = glcdGetColumnsStr(FONT_5X7M, msg, columns);
+  for (i = 0; i < width; i++)
+    element->bitmap[valueX + i] = (uint16_t)columns[i] << 1;
+
+  // Element text in sprite pixel rows 9..13
+  width = glcdGetColumnsStr(FONT_5X5P, element->text, columns);
+  for (i = 0; i < width; i++)
+    element->bitmap[i + 1] |= (uint16_t)columns[i] << 9;
+
+  return MAX(valueX + 12, width + 1);
 }
@@ -71,6 +71,14 @@
 // - When all tests are completed exit the current suite and continue with the
 //   next suite, or restart at the first suite.
 //
+// In the emulator the test suites can also be run non-interactively using
+// the mchron batch mode (mchron -b perf[:<suite>]). In batch mode all button
+// presses are scripted: every (selected) test suite is entered, each of its
+// tests is run once, and for every test the glcd/controller statistics and
+// the wall clock test time are written as csv or json records to an output
+// file. As such, the results of glcd code changes can be compared against a
+// stored baseline.
+//
 // WARNING: The code in this module bypasses the defined Monochron clock plugin
 // framework for the greater good of providing a proper user interface and
 // obtaining proper test results.
@@ -80,6 +88,7 @@
 
 #ifdef EMULIN
 #include <stdio.h>
+#include <string.h>
 #endif
 #include <math.h>
 #include "../global.h"
@@ -177,6 +186,9 @@ extern volatile uint8_t rtcTimeEvent;
 extern volatile uint8_t btnPressed;
 
 // Generic test utility function prototypes
+#ifdef EMULIN
+static void perfBatchWrite(u08 interruptTest);
+#endif
 static u08 perfButtonGet(void);
 static u08 perfButtonWait(u08 type);
 static void perfLongValToStr(long value, char valString[]);
@@ -212,6 +224,64 @@ static char *textLine;
 // Time counter for glcdLine-01
 static u16 secCount;
 
+#ifdef EMULIN
+// Batch mode runtime environment
+static u08 perfBatchActive = MC_FALSE;	// Are we running in batch mode
+static char *perfBatchSuite = NULL;	// Selected test suite (NULL = all)
+static FILE *perfBatchFp = NULL;	// Test result output file
+static u08 perfBatchFormat;		// Test result output format
+static int perfBatchTests;		// Number of test results written
+static struct timeval perfBatchTvStart;	// Wall clock test start time
+#endif
+
+#ifdef EMULIN
+//
+// Function: perfBatch
+//
+// Run the (selected) performance test suites once in batch mode and write the
+// test results to the output file.
+// Return: MC_TRUE (success) or MC_FALSE (no test suite was run).
+//
+u08 perfBatch(char *suite, FILE *fp, u08 format)
+{
+  // Init batch mode
+  perfBatchActive = MC_TRUE;
+  perfBatchSuite = suite;
+  perfBatchFp = fp;
+  perfBatchFormat = format;
+  perfBatchTests = 0;
+
+  // Write the header of the test results
+  if (format == PERF_FORMAT_CSV)
+    fprintf(fp, "suite,test,status,loops,draws,wallUsec,"
+      "glcdDataWrite,glcdDataRead,glcdAddressSet,glcdCtrlSet,"
+      "ctrlWriteReq,ctrlWriteCnf,ctrlReadReq,ctrlReadCnf,"
+      "ctrlXReq,ctrlXCnf,ctrlYReq,ctrlYCnf,"
+      "ctrlDisplayReq,ctrlDisplayCnf,ctrlStartLineReq,ctrlStartLineCnf\n");
+  else
+    fprintf(fp, "[");
+
+  // Run the test suites
+  glcdClearScreen();
+  perfInit(DRAW_INIT_FULL);
+  perfCycle();
+
+  // Write the trailer of the test results
+  if (format == PERF_FORMAT_JSON)
+    fprintf(fp, "\n]\n");
+  fflush(fp);
+
+  // Return to interactive mode
+  perfBatchActive = MC_FALSE;
+  perfBatchSuite = NULL;
+  perfBatchFp = NULL;
+
+  if (perfBatchTests == 0)
+    return MC_FALSE;
+  return MC_TRUE;
+}
+#endif
+
 //
 // Function: perfCycle
 //
@@ -222,10 +292,14 @@ void perfCycle(void)
 #ifdef EMULIN
   int myKbMode = KB_MODE_LINE;
 
-  // In emulator switch to keyboard scan mode if needed
-  myKbMode = kbModeGet();
-  if (myKbMode == KB_MODE_LINE)
-    kbModeSet(KB_MODE_SCAN);
+  // In emulator switch to keyboard scan mode if needed (not in batch mode as
+  // it does not use the keyboard)
+  if (perfBatchActive == MC_FALSE)
+  {
+    myKbMode = kbModeGet();
+    if (myKbMode == KB_MODE_LINE)
+      kbModeSet(KB_MODE_SCAN);
+  }
 #endif
 
   // Repeat forever
@@ -251,6 +325,11 @@ void perfCycle(void)
       break;
     if (perfTestBitmap() == MC_TRUE)
       break;
+#ifdef EMULIN
+    // In batch mode the test suites are run only once
+    if (perfBatchActive == MC_TRUE)
+      break;
+#endif
   }
 
 #ifdef EMULIN
@@ -259,7 +338,7 @@ void perfCycle(void)
   glcdPutStr2(1, 58, FONT_5X5P, "quit performance test");
 
   // Return to line mode if needed
-  if (myKbMode == KB_MODE_LINE)
+  if (perfBatchActive == MC_FALSE && myKbMode == KB_MODE_LINE)
     kbModeSet(KB_MODE_LINE);
 #endif
 }
@@ -276,7 +355,8 @@ void perfInit(u08 mode)
   // Give welcome screen
   glcdPutStr2(1, 1, FONT_5X5P, "monochron glcd performance test");
 #ifdef EMULIN
-  printf("\nTo exit performance test clock press 'q' on any main test suite prompt\n\n");
+  if (perfBatchActive == MC_FALSE)
+    printf("\nTo exit performance test clock press 'q' on any main test suite prompt\n\n");
 #endif
 
   // Wait for button press
@@ -1754,6 +1834,71 @@ static u08 perfTestRectangle(void)
   return MC_FALSE;
 }
 
+#ifdef EMULIN
+//
+// Function: perfBatchWrite
+//
+// Write the test results of a batch mode test to the output file
+//
+static void perfBatchWrite(u08 interruptTest)
+{
+  ctrlGlcdStats_t glcdStats;
+  ctrlStats_t ctrlStats;
+  struct timeval tvNow;
+  char *status;
+  long long wallUsec;
+
+  // Get the test wall clock time and glcd/controller statistics
+  gettimeofday(&tvNow, NULL);
+  wallUsec = TIMEDIFF_USEC(tvNow, perfBatchTvStart);
+  ctrlStatsGet(&glcdStats, &ctrlStats);
+  if (interruptTest == MC_FALSE)
+    status = "completed";
+  else
+    status = "aborted";
+
+  // Write the test results record
+  if (perfBatchFormat == PERF_FORMAT_CSV)
+  {
+    fprintf(perfBatchFp, "%s,%d,%s,%u,%ld,%lld,", testStats.text,
+      testStats.testId, status, testStats.loopsDone, testStats.elementsDrawn,
+      wallUsec);
+    fprintf(perfBatchFp, "%lld,%lld,%lld,%lld,", glcdStats.dataWrite,
+      glcdStats.dataRead, glcdStats.addressSet, glcdStats.ctrlSet);
+    fprintf(perfBatchFp, "%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lld,",
+      ctrlStats.writeReq, ctrlStats.writeCnf, ctrlStats.readReq,
+      ctrlStats.readCnf, ctrlStats.xReq, ctrlStats.xCnf, ctrlStats.yReq,
+      ctrlStats.yCnf);
+    fprintf(perfBatchFp, "%lld,%lld,%lld,%lld\n", ctrlStats.displayReq,
+      ctrlStats.displayCnf, ctrlStats.startLineReq, ctrlStats.startLineCnf);
+  }
+  else
+  {
+    if (perfBatchTests > 0)
+      fprintf(perfBatchFp, ",");
+    fprintf(perfBatchFp, "\n  {\"suite\": \"%s\", \"test\": %d, "
+      "\"status\": \"%s\", \"loops\": %u, \"draws\": %ld, "
+      "\"wallUsec\": %lld,\n", testStats.text, testStats.testId, status,
+      testStats.loopsDone, testStats.elementsDrawn, wallUsec);
+    fprintf(perfBatchFp, "   \"glcd\": {\"dataWrite\": %lld, "
+      "\"dataRead\": %lld, \"addressSet\": %lld, \"ctrlSet\": %lld},\n",
+      glcdStats.dataWrite, glcdStats.dataRead, glcdStats.addressSet,
+      glcdStats.ctrlSet);
+    fprintf(perfBatchFp, "   \"ctrl\": {\"writeReq\": %lld, "
+      "\"writeCnf\": %lld, \"readReq\": %lld, \"readCnf\": %lld, "
+      "\"xReq\": %lld, \"xCnf\": %lld, \"yReq\": %lld, \"yCnf\": %lld, ",
+      ctrlStats.writeReq, ctrlStats.writeCnf, ctrlStats.readReq,
+      ctrlStats.readCnf, ctrlStats.xReq, ctrlStats.xCnf, ctrlStats.yReq,
+      ctrlStats.yCnf);
+    fprintf(perfBatchFp, "\"displayReq\": %lld, \"displayCnf\": %lld, "
+      "\"startLineReq\": %lld, \"startLineCnf\": %lld}}",
+      ctrlStats.displayReq, ctrlStats.displayCnf, ctrlStats.startLineReq,
+      ctrlStats.startLineCnf);
+  }
+  perfBatchTests++;
+}
+#endif
+
 //
 // Function: perfButtonGet
 //
@@ -1769,7 +1914,9 @@ static u08 perfButtonGet(void)
   btnPressed = BTN_NONE;
   return button;
 #else
-  // Accept any keypress when pressed
+  // Accept any keypress when pressed (a batch test is never interrupted)
+  if (perfBatchActive == MC_TRUE)
+    return 0;
   return (u08)kbKeypressScan(MC_FALSE);
 #endif
 }
@@ -1806,6 +1953,15 @@ static u08 perfButtonWait(u08 type)
   button = btnPressed;
   btnPressed = BTN_NONE;
 #else
+  // In batch mode enter a test suite and start a test, but end a test after
+  // its first run
+  if (perfBatchActive == MC_TRUE)
+  {
+    if (type == PERF_WAIT_RESTART_END)
+      return BTN_MENU;
+    return BTN_PLUS;
+  }
+
   // Get +,s,m,q, others default to MENU button
   char ch = waitKeypress(MC_FALSE);
   if (ch >= 'A' && ch <= 'Z')
@@ -1869,6 +2025,13 @@ static u08 perfSuiteWelcome(char *label)
   length = glcdPutStr2(1, 1, FONT_5X5P, "Test suite: ");
   glcdPutStr2(length + 1, 1, FONT_5X5P, label);
 
+#ifdef EMULIN
+  // In batch mode skip a test suite that is not selected
+  if (perfBatchActive == MC_TRUE && perfBatchSuite != NULL &&
+      strcmp(label, perfBatchSuite) != 0)
+    return BTN_MENU;
+#endif
+
   // Wait for button press: continue or skip all tests
   // + = continue
   // s/m = skip
@@ -1885,7 +2048,8 @@ static void perfTestBegin(void)
 {
 #ifdef EMULIN
   // In case we're using glut, give the lcd device some time to catch up
-  _delay_ms(250);
+  if (perfBatchActive == MC_FALSE)
+    _delay_ms(250);
   // Reset glcd/controller statistics
   ctrlStatsReset(CTRL_STATS_GLCD | CTRL_STATS_CTRL);
 #endif
@@ -1904,7 +2068,8 @@ static void perfTestBegin(void)
 #ifndef EMULIN
   while (rtcTimeEvent == MC_FALSE);
 #else
-  while (rtcTimeEvent == MC_FALSE)
+  // No need to sync in batch mode as it measures wall clock time
+  while (rtcTimeEvent == MC_FALSE && perfBatchActive == MC_FALSE)
   {
     _delay_ms(25);
     monoTimer();
@@ -1915,6 +2080,9 @@ static void perfTestBegin(void)
   testStats.startSec = rtcDateTimeNext.timeSec;
   testStats.startMin = rtcDateTimeNext.timeMin;
   testStats.startHour = rtcDateTimeNext.timeHour;
+#ifdef EMULIN
+  gettimeofday(&perfBatchTvStart, NULL);
+#endif
 }
 
 //
@@ -1938,16 +2106,24 @@ static u08 perfTestEnd(u08 interruptTest)
   testStats.endHour = rtcDateTimeNext.timeHour;
 
 #ifdef EMULIN
-  // In case we're using glut, give the lcd device some time to catch up
-  _delay_ms(250);
-
-  // Give test end result and glcd/controller statistics
-  printf("test   : %s - %02d\n", testStats.text, testStats.testId);
-  if (interruptTest == MC_FALSE)
-    printf("status : %s\n", "completed");
+  if (perfBatchActive == MC_TRUE)
+  {
+    // Write test results to the batch output file
+    perfBatchWrite(interruptTest);
+  }
   else
-    printf("status : %s\n", "aborted");
-  ctrlStatsPrint(CTRL_STATS_GLCD | CTRL_STATS_CTRL);
+  {
+    // In case we're using glut, give the lcd device some time to catch up
+    _delay_ms(250);
+
+    // Give test end result and glcd/controller statistics
+    printf("test   : %s - %02d\n", testStats.text, testStats.testId);
+    if (interruptTest == MC_FALSE)
+      printf("status : %s\n", "completed");
+    else
+      printf("status : %s\n", "aborted");
+    ctrlStatsPrint(CTRL_STATS_GLCD | CTRL_STATS_CTRL);
+  }
 #endif
 
   // Give test statistics screen
@@ -6,9 +6,21 @@
 #ifndef PERFTEST_H
 #define PERFTEST_H
 
+#ifdef EMULIN
+#include <stdio.h>
+#endif
 #include "../avrlibtypes.h"
 
+#ifdef EMULIN
+// The batch mode test result output formats
+#define PERF_FORMAT_CSV		0
+#define PERF_FORMAT_JSON	1
+#endif
+
 // Performance test suite
+#ifdef EMULIN
+u08 perfBatch(char *suite, FILE *fp, u08 format);
+#endif
 void perfCycle(void);
 void perfInit(u08 mode);
 #endif
@@ -3,10 +3,10 @@
 // Title    : Animation code for MONOCHRON pie chart clock
 //*****************************************************************************
 
-#include <math.h>
 #include "../global.h"
 #include "../glcd.h"
 #include "../anim.h"
+#include "../trig.h"
 #include "spotfire.h"
 #include "piechart.h"
 
@@ -17,9 +17,8 @@
 #define PIE_Y_START		36
 #define PIE_RADIUS		15
 #define PIE_LINE_RADIUS		(PIE_RADIUS - 0.5)
-#define PIE_LINE_RADIAL_STEPS	60.0
-#define PIE_LINE_RADIAL_START	0.0
-#define PIE_LINE_RADIAL_SIZE	(2.0 * M_PI)
+#define PIE_LINE_ANGLE_STEPS	60
+#define PIE_LINE_ANGLE_START	0
 #define PIE_VALUE_X_OFFSET	-3
 #define PIE_VALUE_Y_OFFSET	-2
 #define PIE_VALUE_RADIUS	(PIE_RADIUS - 5.5)
@@ -202,9 +201,9 @@ static void pieArcPoint(s08 deltaX, s08 deltaY)
 static void pieLineUpdate(u08 x, u08 oldVal, u08 newVal)
 {
   s08 oldLineDx, newLineDx, oldLineDy, newLineDy;
-  float arcLineOld, arcLineNew;
+  u16 arcLineOld, arcLineNew;
   s08 oldValDx, newValDx, oldValDy, newValDy;
-  float arcValOld, arcValNew;
+  u16 arcValOld, arcValNew;
   char pieValue[3];
 
   // See if we need to update the time element
@@ -212,26 +211,26 @@ static void pieLineUpdate(u08 x, u08 oldVal, u08 newVal)
     return;
 
   // Calculate changes in pie line
-  arcLineOld = PIE_LINE_RADIAL_SIZE / PIE_LINE_RADIAL_STEPS * oldVal +
-    PIE_LINE_RADIAL_START;
-  oldLineDx = (s08)(sin(arcLineOld) * PIE_LINE_RADIUS);
-  oldLineDy = (s08)(-cos(arcLineOld) * PIE_LINE_RADIUS);
-  arcLineNew = PIE_LINE_RADIAL_SIZE / PIE_LINE_RADIAL_STEPS * newVal +
-    PIE_LINE_RADIAL_START;
-  newLineDx = (s08)(sin(arcLineNew) * PIE_LINE_RADIUS);
-  newLineDy = (s08)(-cos(arcLineNew) * PIE_LINE_RADIUS);
+  arcLineOld = TRIG_ANGLE(oldVal, PIE_LINE_ANGLE_STEPS) +
+    PIE_LINE_ANGLE_START;
+  oldLineDx = TRIG_Q88_INT(trigSinMul(arcLineOld, TRIG_Q88(PIE_LINE_RADIUS)));
+  oldLineDy = TRIG_Q88_INT(-trigCosMul(arcLineOld, TRIG_Q88(PIE_LINE_RADIUS)));
+  arcLineNew = TRIG_ANGLE(newVal, PIE_LINE_ANGLE_STEPS) +
+    PIE_LINE_ANGLE_START;
+  newLineDx = TRIG_Q88_INT(trigSinMul(arcLineNew, TRIG_Q88(PIE_LINE_RADIUS)));
+  newLineDy = TRIG_Q88_INT(-trigCosMul(arcLineNew, TRIG_Q88(PIE_LINE_RADIUS)));
 
   // Calculate changes in pie value
-  arcValOld = (arcLineOld - PIE_LINE_RADIAL_START) / 2.0 +
-    PIE_LINE_RADIAL_START;
-  oldValDx = (s08)(sin(arcValOld) * PIE_VALUE_RADIUS);
-  oldValDy =
-    (s08)(-cos(arcValOld) * PIE_VALUE_RADIUS * PIE_VALUE_ELLIPS_Y);
-  arcValNew = (arcLineNew - PIE_LINE_RADIAL_START) / 2.0 +
-    PIE_LINE_RADIAL_START;
-  newValDx = (s08)(sin(arcValNew) * PIE_VALUE_RADIUS);
-  newValDy =
-    (s08)(-cos(arcValNew) * PIE_VALUE_RADIUS * PIE_VALUE_ELLIPS_Y);
+  arcValOld = (u16)(arcLineOld - PIE_LINE_ANGLE_START) / 2 +
+    PIE_LINE_ANGLE_START;
+  oldValDx = TRIG_Q88_INT(trigSinMul(arcValOld, TRIG_Q88(PIE_VALUE_RADIUS)));
+  oldValDy = TRIG_Q88_INT(-trigCosMul(arcValOld,
+    TRIG_Q88(PIE_VALUE_RADIUS * PIE_VALUE_ELLIPS_Y)));
+  arcValNew = (u16)(arcLineNew - PIE_LINE_ANGLE_START) / 2 +
+    PIE_LINE_ANGLE_START;
+  newValDx = TRIG_Q88_INT(trigSinMul(arcValNew, TRIG_Q88(PIE_VALUE_RADIUS)));
+  newValDy = TRIG_Q88_INT(-trigCosMul(arcValNew,
+    TRIG_Q88(PIE_VALUE_RADIUS * PIE_VALUE_ELLIPS_Y)));
 
   // Remove old pie line
   glcdColorSetBg();
@@ -245,7 +244,7 @@ static void pieLineUpdate(u08 x, u08 oldVal, u08 newVal)
   // Clear the circle outline if needed
   if (mcClockInit == MC_TRUE)
   {
-    arcLineOld = PIE_LINE_RADIAL_START;
+    arcLineOld = PIE_LINE_ANGLE_START;
   }
   else if (newVal < oldVal)
   {
@@ -254,15 +253,15 @@ static void pieLineUpdate(u08 x, u08 oldVal, u08 newVal)
     glcdCircle2(x, PIE_Y_START, PIE_RADIUS, CIRCLE_FULL);
     glcdColorSetFg();
     glcdCircle2(x, PIE_Y_START, PIE_RADIUS, CIRCLE_THIRD);
-    arcLineOld = PIE_LINE_RADIAL_START;
+    arcLineOld = PIE_LINE_ANGLE_START;
   }
 
   // Repaint the 0-value line since removing the old needle and pie value may
   // cause it to (partly) disappear
   glcdColorSetFg();
-  glcdLine(x, PIE_Y_START,
-    x + (s08)(sin(PIE_LINE_RADIAL_START) * (PIE_RADIUS + 0.5)),
-    PIE_Y_START + (s08)(-cos(PIE_LINE_RADIAL_START) * (PIE_RADIUS + 0.5)));
+  glcdLine(x, PIE_Y_START, x + TRIG_Q88_INT(trigSinMul(PIE_LINE_ANGLE_START,
+    TRIG_Q88(PIE_RADIUS + 0.5))), PIE_Y_START + TRIG_Q88_INT(-trigCosMul(
+    PIE_LINE_ANGLE_START, TRIG_Q88(PIE_RADIUS + 0.5))));
 
   // Add new pie line
   glcdLine(x, PIE_Y_START, x + newLineDx, PIE_Y_START + newLineDy);
@@ -278,11 +277,11 @@ static void pieLineUpdate(u08 x, u08 oldVal, u08 newVal)
 
   // Update the global pie arc info that is used to draw the arc
   centerX = x;
-  startX = (s08)(sin(arcLineOld) * (PIE_RADIUS + 0.5));
-  startY = (s08)(-cos(arcLineOld) * (PIE_RADIUS + 0.5));
-  startQ = (u08)(arcLineOld * 4 / PIE_LINE_RADIAL_SIZE);
-  endX = (s08)(sin(arcLineNew) * (PIE_RADIUS + 0.5));
-  endY = (s08)(-cos(arcLineNew) * (PIE_RADIUS + 0.5));
-  endQ = (u08)(arcLineNew * 4 / PIE_LINE_RADIAL_SIZE);
+  startX = TRIG_Q88_INT(trigSinMul(arcLineOld, TRIG_Q88(PIE_RADIUS + 0.5)));
+  startY = TRIG_Q88_INT(-trigCosMul(arcLineOld, TRIG_Q88(PIE_RADIUS + 0.5)));
+  startQ = (u08)(arcLineOld >> 14);
+  endX = TRIG_Q88_INT(trigSinMul(arcLineNew, TRIG_Q88(PIE_RADIUS + 0.5)));
+  endY = TRIG_Q88_INT(-trigCosMul(arcLineNew, TRIG_Q88(PIE_RADIUS + 0.5)));
+  endQ = (u08)(arcLineNew >> 14);
   pieArc();
 }
@@ -4,12 +4,15 @@
 //*****************************************************************************
 
 #include <math.h>
+#include <string.h>
 #include "../global.h"
 #include "../glcd.h"
 #include "../anim.h"
 #include "../ks0108.h"
 #include "../ks0108conf.h"
 #include "../monomain.h"
+#include "../sprite.h"
+#include "../trig.h"
 #include "pong.h"
 
 // The TRAJ_LEN is influenced by both the ball speed and the minimum angle.
@@ -26,6 +29,7 @@
 #define BALL_SPEED_MAX		5
 #define BALL_ANGLE_MIN		40
 #define BALL_WIDLEN		2	// Square ball width and height
+#define BALL_X_MAX		0x7fff	// Max Q8.8 ball x position
 #define TRAJ_LEN		38
 
 // Create a new ball motion angle and encode ball hitting top/bottom bar
@@ -100,11 +104,10 @@ extern volatile uint8_t mcClockTimeEvent;
 extern volatile uint8_t mcFgColor;
 extern volatile uint8_t mcMchronClock;
 extern clockDriver_t *mcClockPool;
-// mcU8Util1 = flashing state of the paddles during alarm/snooze
 // mcU8Util2 = new score mode
 // mcU8Util3 = current score mode
 // mcU8Util4 = score display timeout timer
-extern volatile uint8_t mcU8Util1, mcU8Util2, mcU8Util3, mcU8Util4;
+extern volatile uint8_t mcU8Util2, mcU8Util3, mcU8Util4;
 
 // The score digit font character set describes seven segment bits per digit.
 // Per bit segment in a font byte (MSB..LSB):
@@ -123,6 +126,18 @@ static const unsigned char __attribute__ ((progmem)) scoreFont[] =
 #endif
 };
 
+// The sprite frames of the ball and the paddles. A paddle has a filled frame
+// for regular game play and an open frame for flashing while alarming.
+static const uint8_t __attribute__ ((progmem)) ballSprite[] =
+{
+  0x0f, 0x0f, 0x0f, 0x0f
+};
+static const uint16_t __attribute__ ((progmem)) paddleSprite[] =
+{
+  0x0fff, 0x0fff, 0x0fff,
+  0x0fff, 0x0801, 0x0fff
+};
+
 // The stored ball trajectory and its metadata
 static u08 trajX[TRAJ_LEN];	// The ball trajectory x positions
 static u08 trajY[TRAJ_LEN];	// The ball trajectory y positions
@@ -137,9 +152,12 @@ static u08 ballAngle;		// Next trajectory: ball angle retain or new
 
 // Left and right paddle information
 static s08 rightPaddleY, leftPaddleY;
-static s08 oldLeftPaddleY, oldRightPaddleY;
 static u08 almDisplayState;
 
+// The sprite ids of the ball and the paddles
+static u08 ballId;
+static u08 leftPaddleId, rightPaddleId;
+
 // Score, time and play pause
 static u08 scoreLeft, scoreRight;
 static u08 scoreRedraw;
@@ -155,19 +173,53 @@ static u16 pongRandBase = M_PI * M_PI * 1000;
 static const float pongRandSeed = 3.9147258617;
 static u16 pongRandVal = 0x5a3c;
 
+#ifdef EMULIN
+// The emulator can check the fixed-point ball model against the float ball
+// model it replaced. For this it calculates ball trajectories with both models
+// from an identical saved trajectory state.
+typedef struct _pongModel_t
+{
+  u08 trajX[TRAJ_LEN];		// The ball trajectory x positions
+  u08 trajY[TRAJ_LEN];		// The ball trajectory y positions
+  u08 ticksPlay;		// Play ticks of complete trajectory
+  u08 tickNow;			// Current trajectory position being played
+  s08 paddle;			// Target trajectory paddle (left or right)
+  s08 paddleY;			// Target y position of paddle in trajectory
+  u08 paddleTick;		// Play tick for the ball to reach the paddle
+  s08 ballDirX;			// Next trajectory: ball moving left or right
+  s08 ballDirY;			// Next trajectory: ball moving up or down
+  u08 ballAngle;		// Next trajectory: ball angle retain or new
+  u08 trajId;			// First or subsequent trajectory
+  u16 randBase;			// Random value base
+  u16 randVal;			// Random value
+} pongModel_t;
+
+// Calculate ball trajectories with the float ball model
+static u08 pongModelFloat = MC_FALSE;
+#endif
+
 // Local function prototypes
 static u08 pongBallIntersect(u08 x1, u08 y1, u08 x2, u08 y2, u08 w2, u08 h2);
+static u08 pongBallSim(u08 avoidPaddle, u08 *bounceY, u08 *ballEndY);
 static void pongBallTraject(void);
-static void pongBallVector(float *ballDx, float *ballDy);
-static float pongBarBounce(float y, float *ballDy, u08 *hitBar);
-static void pongDrawBall(u08 remove);
+static void pongBallVector(s16 *ballDx, s16 *ballDy);
+static s16 pongBarBounce(s16 y, s16 *ballDy, u08 *hitBar);
+static s16 pongDivFloor(s32 n, s16 d);
+static void pongDrawBall(void);
 static void pongDrawBigDigit(u08 x, u08 value, u08 high);
-static void pongDrawPaddle(s08 x, s08 oldY, s08 newY);
+static void pongDrawPaddle(u08 id, u08 x, s08 y);
 static void pongDrawScore(void);
 static void pongDrawMidLine(void);
 static void pongGameStep(void);
 static s08 pongPaddleMove(s08 y);
 static u16 pongRandGet(u08 type);
+#ifdef EMULIN
+static u08 pongBallSimFloat(u08 avoidPaddle, u08 *bounceY, u08 *ballEndY);
+static void pongBallVectorFloat(float *ballDx, float *ballDy);
+static float pongBarBounceFloat(float y, float *ballDy, u08 *hitBar);
+static void pongModelLoad(pongModel_t *model);
+static void pongModelSave(pongModel_t *model);
+#endif
 
 //
 // Function: pongButton
@@ -254,9 +306,9 @@ void pongCycle(void)
   // Draw the ball
   if (countdown == 0)
   {
-    // Regular game play so the ball moved from a to b. Draw ball and redraw
+    // Regular game play so the ball moved from a to b. Move ball and redraw
     // middle line when intersected by the old ball.
-    pongDrawBall(MC_TRUE);
+    pongDrawBall();
     if (pongBallIntersect(trajX[tickNow - 1], trajY[tickNow - 1],
         GLCD_XPIXELS / 2 - MIDLINE_W, 0, MIDLINE_W, GLCD_YPIXELS))
       pongDrawMidLine();
@@ -281,14 +333,13 @@ void pongCycle(void)
       (trajY[tickNow] + GLCD_YPIXELS / 2 + BALL_WIDLEN) % GLCD_YPIXELS);
 #endif
 
-  // Move the paddles and save paddle alarm state for next cycle
-  pongDrawPaddle(PADDLE_LEFT_X, oldLeftPaddleY, leftPaddleY);
-  pongDrawPaddle(PADDLE_RIGHT_X, oldRightPaddleY, rightPaddleY);
-  mcU8Util1 = almDisplayState;
+  // Move the paddles
+  pongDrawPaddle(leftPaddleId, PADDLE_LEFT_X, leftPaddleY);
+  pongDrawPaddle(rightPaddleId, PADDLE_RIGHT_X, rightPaddleY);
 
-  // Draw score and redraw ball in case it got removed by the score draw
+  // Draw score and then draw the ball and paddle sprites on top of it
   pongDrawScore();
-  pongDrawBall(MC_FALSE);
+  spriteFlush();
 
   // Beep when the ball hits a paddle, end of game (=score) or hit a bar
   // (top/bottom). Play audio only when there's no audible alarm.
@@ -315,6 +366,9 @@ void pongInit(u08 mode)
   // Get the clockId to determine whether to play audio
   clockId = mcClockPool[mcMchronClock].clockId;
 
+  // Clear the sprites of a previous pong clock
+  spriteReset();
+
   // Draw (optional) top+bottom bar and dotted vertical line in middle
 #ifndef PONG_ATARI
   glcdFillRectangle(0, 0, GLCD_XPIXELS, BAR_H);
@@ -327,7 +381,7 @@ void pongInit(u08 mode)
   mcU8Util3 = SCORE_MODE_INIT;
   mcU8Util4 = 0;
   minuteChanged = hourChanged = MC_FALSE;
-  oldLeftPaddleY = oldRightPaddleY = leftPaddleY = rightPaddleY = 25;
+  leftPaddleY = rightPaddleY = 25;
 
   // Init calculating first ball trajectory
   trajId = 0;
@@ -342,6 +396,18 @@ void pongInit(u08 mode)
   ballAngle = ANGLE_NEW;
   trajX[0] = GLCD_XPIXELS / 2 - BALL_WIDLEN;
   trajY[0] = GLCD_YPIXELS / 2 - BALL_WIDLEN;
+
+  // Register the paddle and ball sprites where the ball is on top
+  leftPaddleId = spriteRegister(PADDLE_LEFT_X, leftPaddleY, PADDLE_W,
+    PADDLE_H, 0, ELM_WORD, DATA_PMEM, (void *)paddleSprite);
+  rightPaddleId = spriteRegister(PADDLE_RIGHT_X, rightPaddleY, PADDLE_W,
+    PADDLE_H, 0, ELM_WORD, DATA_PMEM, (void *)paddleSprite);
+  ballId = spriteRegister(trajX[0], trajY[0], BALL_WIDLEN * 2,
+    BALL_WIDLEN * 2, 1, ELM_BYTE, DATA_PMEM, (void *)ballSprite);
+#ifdef PONG_ATARI
+  spriteVisibleSet(ballId, SPRITE_HIDE);
+#endif
+  spriteFlush();
 }
 
 //
@@ -361,94 +427,83 @@ static u08 pongBallIntersect(u08 x1, u08 y1, u08 x2, u08 y2, u08 w2, u08 h2)
 }
 
 //
-// Function: pongBallTraject
+// Function: pongBallSim
 //
-// Calculate a full ball trajectory from the current ball position (at a paddle
-// bounce or start position) towards the far end (next paddle bounce or start
-// position). The stored trajectory will then be played in subsequent gameplay
-// ticks.
+// Simulate the ball motion in Q8.8 fixed point from the current ball position
+// until it hits the target paddle or leaves the play field, and store it in
+// the ball trajectory. Return the number of trajectory steps, and the ball y
+// position at the paddle and the first ball y position behind the paddle.
 //
-static void pongBallTraject(void)
+static u08 pongBallSim(u08 avoidPaddle, u08 *bounceY, u08 *ballEndY)
 {
-  float ballX, ballY;
-  float oldBallX, oldBallY;
-  float dx, dy;
-  float ballDx, ballDy;
+  s16 ballX, ballY;
+  s16 oldBallX = 0, oldBallY = 0;
+  s16 dx, dy;
+  s16 ballDx, ballDy;
   u08 tix = 0;
   u08 paddleColl = COLL_NONE;
-  u08 bounceY;
-  u08 keepoutTop, keepoutBot, ballEndY;
-  u08 avoidPaddle;
   u08 hitBar;
 
-  // Signal first and subsequent calculated trajectories
-  if (trajId < 2)
-    trajId++;
-
   // Start trajectory at the last ball position and get ball motion vectors
-  ballX = trajX[0] = trajX[ticksPlay];
-  ballY = trajY[0] = trajY[ticksPlay];
+  trajX[0] = trajX[ticksPlay];
+  trajY[0] = trajY[ticksPlay];
+  ballX = TRIG_Q88(trajX[0]);
+  ballY = TRIG_Q88(trajY[0]);
   pongBallVector(&ballDx, &ballDy);
 
-  // Configure target paddle and if we must avoid a ball paddle bounce
-  if (ballDirX == 1)
-  {
-    paddle = PADDLE_RIGHT;
-    avoidPaddle = hourChanged;
-  }
-  else
-  {
-    paddle = PADDLE_LEFT;
-    avoidPaddle = minuteChanged;
-  }
-
   // Add trajectory positions until we leave the play field or hit a paddle
-  ballEndY = bounceY = 0;
-  while ((s08)ballX >= 0 && (u08)ballX + BALL_WIDLEN * 2 < GLCD_XPIXELS)
+  *ballEndY = *bounceY = 0;
+  while (TRIG_Q88_INT(ballX) >= 0 &&
+      (u08)TRIG_Q88_INT(ballX) + BALL_WIDLEN * 2 < GLCD_XPIXELS)
   {
-    //DEBUG(putstring("SIM  ball=["); uart_put_dec(trajX[tix]));
-    //DEBUG(putstring(","); uart_put_dec(trajY[tix]); putstring("], tix="));
-    //DEBUG(uart_put_dec(tix); putstring_nl(""));
-
     // To determine the callout area get first ball position behind paddle
-    if (paddleColl == COLL_CONF && oldBallX < PADDLE_RIGHT_X + PADDLE_W &&
-        oldBallX + BALL_WIDLEN * 2 > PADDLE_LEFT_X)
-      ballEndY = ballY;
+    if (paddleColl == COLL_CONF &&
+        oldBallX < TRIG_Q88(PADDLE_RIGHT_X + PADDLE_W) &&
+        oldBallX > TRIG_Q88(PADDLE_LEFT_X - BALL_WIDLEN * 2))
+      *ballEndY = TRIG_Q88_INT(ballY);
 
-    // Base position for next ball trajectory entry
+    // Base position for next ball trajectory entry. When the ball leaves the
+    // play field on the right clip its x position to stay in Q8.8 range.
     tix++;
     oldBallX = ballX;
     oldBallY = ballY;
-    ballX = ballX + ballDx;
+    if (ballDx > 0 && ballX > BALL_X_MAX - ballDx)
+      ballX = BALL_X_MAX;
+    else
+      ballX = ballX + ballDx;
     ballY = ballY + ballDy;
 
     // Check collision with right or left paddle
-    if ((s08)ballX + BALL_WIDLEN * 2 >= PADDLE_RIGHT_X &&
+    if (TRIG_Q88_INT(ballX) + BALL_WIDLEN * 2 >= PADDLE_RIGHT_X &&
         paddleColl == COLL_NONE)
     {
       // Prepare to determine exact collision position with right paddle
       paddleColl = COLL_REQ;
-      dx = PADDLE_RIGHT_X - (oldBallX + BALL_WIDLEN * 2);
+      dx = TRIG_Q88(PADDLE_RIGHT_X - BALL_WIDLEN * 2) - oldBallX;
     }
-    else if ((s08)ballX <= PADDLE_LEFT_X + PADDLE_W && paddleColl == COLL_NONE)
+    else if (TRIG_Q88_INT(ballX) <= PADDLE_LEFT_X + PADDLE_W &&
+        paddleColl == COLL_NONE)
     {
       // Prepare to determine exact collision position with left paddle
       paddleColl = COLL_REQ;
-      dx = PADDLE_LEFT_X + PADDLE_W - oldBallX;
+      dx = TRIG_Q88(PADDLE_LEFT_X + PADDLE_W) - oldBallX;
     }
     if (paddleColl == COLL_REQ)
     {
-      // Determine the vertical bounce position and ball bounce tick
+      // Determine the vertical bounce position and ball bounce tick. The y
+      // offset is rounded down so the bounce position is the integer part of
+      // its exact value.
       paddleColl = COLL_CONF;
-      dy = (dx / ballDx) * ballDy;
-      bounceY = pongBarBounce(oldBallY + dy, 0, &hitBar);
+      dy = pongDivFloor((s32)dx * ballDy, ballDx);
+      *bounceY = TRIG_Q88_INT(pongBarBounce(oldBallY + dy, 0, &hitBar));
       paddleTick = tix;
       if (avoidPaddle == MC_FALSE)
       {
         // Set final ball position in bounce trajectory and bounce the ball x
         // direction in preparation for the next trajectory calculation
-        trajX[tix] = oldBallX + dx;
-        trajY[tix] = pongBarBounce(oldBallY + dy, &ballDy, &hitBar);
+        trajX[tix] = TRIG_Q88_INT(oldBallX + dx);
+        trajY[tix] =
+          TRIG_Q88_INT(pongBarBounce(oldBallY + dy, &ballDy, &hitBar));
         ballDirX = -ballDirX;
         ballAngle = ANGLE_NEW;
         break;
@@ -457,14 +512,56 @@ static void pongBallTraject(void)
 
     // Next ball position in trajectory
     ballY = pongBarBounce(ballY, &ballDy, &hitBar);
-    trajX[tix] = ballX;
-    trajY[tix] = ballY;
+    trajX[tix] = TRIG_Q88_INT(ballX);
+    trajY[tix] = TRIG_Q88_INT(ballY);
 
     // Mark a bar hit in the trajectory so we know when to beep
     if (hitBar == MC_TRUE)
       trajY[tix] = trajY[tix] + BAR_HIT;
   }
 
+  return tix;
+}
+
+//
+// Function: pongBallTraject
+//
+// Calculate a full ball trajectory from the current ball position (at a paddle
+// bounce or start position) towards the far end (next paddle bounce or start
+// position). The stored trajectory will then be played in subsequent gameplay
+// ticks.
+//
+static void pongBallTraject(void)
+{
+  u08 tix;
+  u08 bounceY;
+  u08 keepoutTop, keepoutBot, ballEndY;
+  u08 avoidPaddle;
+
+  // Signal first and subsequent calculated trajectories
+  if (trajId < 2)
+    trajId++;
+
+  // Configure target paddle and if we must avoid a ball paddle bounce
+  if (ballDirX == 1)
+  {
+    paddle = PADDLE_RIGHT;
+    avoidPaddle = hourChanged;
+  }
+  else
+  {
+    paddle = PADDLE_LEFT;
+    avoidPaddle = minuteChanged;
+  }
+
+  // Add trajectory positions until we leave the play field or hit a paddle
+#ifdef EMULIN
+  if (pongModelFloat == MC_TRUE)
+    tix = pongBallSimFloat(avoidPaddle, &bounceY, &ballEndY);
+  else
+#endif
+    tix = pongBallSim(avoidPaddle, &bounceY, &ballEndY);
+
   // Mark end of trajectory and set trajectory run to start a first tick
   ticksPlay = tix;
   tickNow = 0;
@@ -563,21 +660,21 @@ static void pongBallTraject(void)
 // Function: pongBallVector
 //
 // Get a random angle in range 0..pi/2 radials, excluding too steep angles, or
-// keep current angle. Use angle to create x and y ball motion vectors but
+// keep current angle. Use angle to create Q8.8 x and y ball motion vectors but
 // adjust them to the ball up/down and left/right direction indicators.
 //
-static void pongBallVector(float *ballDx, float *ballDy)
+static void pongBallVector(s16 *ballDx, s16 *ballDy)
 {
-  float angleRad;
+  u16 angle;
 
   if (ballAngle == ANGLE_NEW)
     ballAngle = pongRandGet(0) % (90 - BALL_ANGLE_MIN) + BALL_ANGLE_MIN;
-  angleRad = (float)ballAngle * M_PI / 180;
+  angle = TRIG_ANGLE(ballAngle, 360);
 
-  *ballDx = BALL_SPEED_MAX * sin(angleRad);
+  *ballDx = trigSinMul(angle, TRIG_Q88(BALL_SPEED_MAX));
   if (*ballDx * ballDirX < 0)
     *ballDx = -*ballDx;
-  *ballDy = BALL_SPEED_MAX * cos(angleRad);
+  *ballDy = trigCosMul(angle, TRIG_Q88(BALL_SPEED_MAX));
   if (*ballDy * ballDirY < 0)
     *ballDy = -*ballDy;
   //DEBUG(putstring("VECT angle=");uart_put_dec(ballAngle));
@@ -588,16 +685,18 @@ static void pongBallVector(float *ballDx, float *ballDy)
 // Function: pongBarBounce
 //
 // Bounce a ball against a top/bottom bar and flip its y direction on request.
-// Return the (corrected) ball y position.
+// Return the (corrected) Q8.8 ball y position.
 //
-static float pongBarBounce(float y, float *ballDy, u08 *hitBar)
+static s16 pongBarBounce(s16 y, s16 *ballDy, u08 *hitBar)
 {
+  s08 yInt = TRIG_Q88_INT(y);
+
   *hitBar = MC_FALSE;
   if (ballDy != 0)
   {
     // When bouncing at bottom or top bar flip y direction
-    if (((s08)y + BALL_WIDLEN * 2 >= GLCD_YPIXELS - BAR_H && ballDirY == 1) ||
-        ((s08)y <= BAR_H && ballDirY == -1))
+    if ((yInt + BALL_WIDLEN * 2 >= GLCD_YPIXELS - BAR_H && ballDirY == 1) ||
+        (yInt <= BAR_H && ballDirY == -1))
     {
       *ballDy = -*ballDy;
       ballDirY = -ballDirY;
@@ -606,37 +705,50 @@ static float pongBarBounce(float y, float *ballDy, u08 *hitBar)
   }
 
   // When ball is out of the vertical playfield correct y position
-  if ((s08)y + BALL_WIDLEN * 2 > GLCD_YPIXELS - BAR_H)
-    return GLCD_YPIXELS - BAR_H - BALL_WIDLEN * 2;
-  else if ((s08)y < BAR_H)
-    return BAR_H;
+  if (yInt + BALL_WIDLEN * 2 > GLCD_YPIXELS - BAR_H)
+    return TRIG_Q88(GLCD_YPIXELS - BAR_H - BALL_WIDLEN * 2);
+  else if (yInt < BAR_H)
+    return TRIG_Q88(BAR_H);
   else
     return y;
 }
 
 //
-// Function: pongDrawBall
+// Function: pongDivFloor
 //
-// Optionally remove the ball from its previous location and draw the ball at
-// its new location. Do not draw ball when we (re)start the game if we run in
-// ATARI legacy mode.
+// Divide two fixed-point values and round the result down
 //
-static void pongDrawBall(u08 remove)
+static s16 pongDivFloor(s32 n, s16 d)
 {
-  if (remove == MC_TRUE)
+  s32 q;
+
+  if (d < 0)
   {
-    glcdColorSetBg();
-    glcdFillRectangle(trajX[tickNow - 1], trajY[tickNow - 1], BALL_WIDLEN * 2,
-       BALL_WIDLEN * 2);
-    glcdColorSetFg();
+    n = -n;
+    d = -d;
   }
+  q = n / d;
+  if (n < 0 && q * d != n)
+    q--;
+  return (s16)q;
+}
+
+//
+// Function: pongDrawBall
+//
+// Move the ball sprite to its new location. The ball area that gets uncovered
+// is cleared right away while the ball itself is drawn by the sprite engine.
+// Do not show the ball when we (re)start the game if we run in ATARI legacy
+// mode.
+//
+static void pongDrawBall(void)
+{
+  spriteMove(ballId, trajX[tickNow], trajY[tickNow]);
 #ifdef PONG_ATARI
   if (countdown == 0 && (tickNow == paddleTick || tickNow != ticksPlay))
-    glcdFillRectangle(trajX[tickNow], trajY[tickNow], BALL_WIDLEN * 2,
-      BALL_WIDLEN * 2);
-#else
-  glcdFillRectangle(trajX[tickNow], trajY[tickNow], BALL_WIDLEN * 2,
-    BALL_WIDLEN * 2);
+    spriteVisibleSet(ballId, SPRITE_SHOW);
+  else
+    spriteVisibleSet(ballId, SPRITE_HIDE);
 #endif
 }
 
@@ -726,28 +838,15 @@ static void pongDrawMidLine(void)
 //
 // Function: pongDrawPaddle
 //
-// Draw a paddle
+// Move a paddle sprite and show it open while flashing during alarming
 //
-static void pongDrawPaddle(s08 x, s08 oldY, s08 newY)
+static void pongDrawPaddle(u08 id, u08 x, s08 y)
 {
-  // There are several options on redrawing a paddle (if needed anyway)
-  if (oldY != newY || mcClockInit == MC_TRUE)
-  {
-    // Clear old paddle and draw new open or filled new paddle
-    glcdColorSetBg();
-    glcdFillRectangle(x, oldY, PADDLE_W, PADDLE_H);
-    glcdColorSetFg();
-    if (almDisplayState == MC_TRUE)
-      glcdRectangle(x, newY, PADDLE_W, PADDLE_H);
-    else
-      glcdFillRectangle(x, newY, PADDLE_W, PADDLE_H);
-  }
-  else if (almDisplayState != mcU8Util1)
-  {
-    // Inverse centre of static paddle while alarming or end of alarm
-    glcdFillRectangle2(x + 1, newY + 1, 1, PADDLE_H - 2, ALIGN_AUTO,
-      FILL_INVERSE);
-  }
+  spriteMove(id, x, (u08)y);
+  if (almDisplayState == MC_TRUE)
+    spriteFrameSet(id, 1);
+  else
+    spriteFrameSet(id, 0);
 }
 
 //
@@ -868,17 +967,14 @@ static void pongGameStep(void)
   // Move to next position in ball trajectory
   tickNow++;
 
-  // Save old paddle position to determine if paddle must be redrawn, and move
-  // paddle just-in-time
+  // Move paddle just-in-time
   if (paddle == PADDLE_RIGHT)
   {
-    oldRightPaddleY = rightPaddleY;
     if (tickNow < paddleTick)
       rightPaddleY = pongPaddleMove(rightPaddleY);
   }
   else
   {
-    oldLeftPaddleY = leftPaddleY;
     if (tickNow < paddleTick)
       leftPaddleY = pongPaddleMove(leftPaddleY);
   }
@@ -929,3 +1025,269 @@ static u16 pongRandGet(u08 type)
   else
     return pongRandVal;
 }
+
+#ifdef EMULIN
+//
+// Function: pongBallSimFloat
+//
+// The float ball model that is replaced by the fixed-point ball model in
+// pongBallSim(). It is used as reference by pongModelCheck().
+//
+static u08 pongBallSimFloat(u08 avoidPaddle, u08 *bounceY, u08 *ballEndY)
+{
+  float ballX, ballY;
+  float oldBallX = 0, oldBallY = 0;
+  float dx, dy;
+  float ballDx, ballDy;
+  u08 tix = 0;
+  u08 paddleColl = COLL_NONE;
+  u08 hitBar;
+
+  // Start trajectory at the last ball position and get ball motion vectors
+  ballX = trajX[0] = trajX[ticksPlay];
+  ballY = trajY[0] = trajY[ticksPlay];
+  pongBallVectorFloat(&ballDx, &ballDy);
+
+  // Add trajectory positions until we leave the play field or hit a paddle
+  *ballEndY = *bounceY = 0;
+  while ((s08)ballX >= 0 && (u08)ballX + BALL_WIDLEN * 2 < GLCD_XPIXELS)
+  {
+    // To determine the callout area get first ball position behind paddle
+    if (paddleColl == COLL_CONF && oldBallX < PADDLE_RIGHT_X + PADDLE_W &&
+        oldBallX + BALL_WIDLEN * 2 > PADDLE_LEFT_X)
+      *ballEndY = ballY;
+
+    // Base position for next ball trajectory entry
+    tix++;
+    oldBallX = ballX;
+    oldBallY = ballY;
+    ballX = ballX + ballDx;
+    ballY = ballY + ballDy;
+
+    // Check collision with right or left paddle
+    if ((s08)ballX + BALL_WIDLEN * 2 >= PADDLE_RIGHT_X &&
+        paddleColl == COLL_NONE)
+    {
+      // Prepare to determine exact collision position with right paddle
+      paddleColl = COLL_REQ;
+      dx = PADDLE_RIGHT_X - (oldBallX + BALL_WIDLEN * 2);
+    }
+    else if ((s08)ballX <= PADDLE_LEFT_X + PADDLE_W && paddleColl == COLL_NONE)
+    {
+      // Prepare to determine exact collision position with left paddle
+      paddleColl = COLL_REQ;
+      dx = PADDLE_LEFT_X + PADDLE_W - oldBallX;
+    }
+    if (paddleColl == COLL_REQ)
+    {
+      // Determine the vertical bounce position and ball bounce tick
+      paddleColl = COLL_CONF;
+      dy = (dx / ballDx) * ballDy;
+      *bounceY = pongBarBounceFloat(oldBallY + dy, 0, &hitBar);
+      paddleTick = tix;
+      if (avoidPaddle == MC_FALSE)
+      {
+        // Set final ball position in bounce trajectory and bounce the ball x
+        // direction in preparation for the next trajectory calculation
+        trajX[tix] = oldBallX + dx;
+        trajY[tix] = pongBarBounceFloat(oldBallY + dy, &ballDy, &hitBar);
+        ballDirX = -ballDirX;
+        ballAngle = ANGLE_NEW;
+        break;
+      }
+    }
+
+    // Next ball position in trajectory
+    ballY = pongBarBounceFloat(ballY, &ballDy, &hitBar);
+    trajX[tix] = ballX;
+    trajY[tix] = ballY;
+
+    // Mark a bar hit in the trajectory so we know when to beep
+    if (hitBar == MC_TRUE)
+      trajY[tix] = trajY[tix] + BAR_HIT;
+  }
+
+  return tix;
+}
+
+//
+// Function: pongBallVectorFloat
+//
+// The float version of pongBallVector()
+//
+static void pongBallVectorFloat(float *ballDx, float *ballDy)
+{
+  u16 angle;
+
+  if (ballAngle == ANGLE_NEW)
+    ballAngle = pongRandGet(0) % (90 - BALL_ANGLE_MIN) + BALL_ANGLE_MIN;
+  angle = TRIG_ANGLE(ballAngle, 360);
+
+  *ballDx = trigSinMul(angle, TRIG_Q88(BALL_SPEED_MAX)) / 256.0;
+  if (*ballDx * ballDirX < 0)
+    *ballDx = -*ballDx;
+  *ballDy = trigCosMul(angle, TRIG_Q88(BALL_SPEED_MAX)) / 256.0;
+  if (*ballDy * ballDirY < 0)
+    *ballDy = -*ballDy;
+}
+
+//
+// Function: pongBarBounceFloat
+//
+// The float version of pongBarBounce()
+//
+static float pongBarBounceFloat(float y, float *ballDy, u08 *hitBar)
+{
+  *hitBar = MC_FALSE;
+  if (ballDy != 0)
+  {
+    // When bouncing at bottom or top bar flip y direction
+    if (((s08)y + BALL_WIDLEN * 2 >= GLCD_YPIXELS - BAR_H && ballDirY == 1) ||
+        ((s08)y <= BAR_H && ballDirY == -1))
+    {
+      *ballDy = -*ballDy;
+      ballDirY = -ballDirY;
+      *hitBar = MC_TRUE;
+    }
+  }
+
+  // When ball is out of the vertical playfield correct y position
+  if ((s08)y + BALL_WIDLEN * 2 > GLCD_YPIXELS - BAR_H)
+    return GLCD_YPIXELS - BAR_H - BALL_WIDLEN * 2;
+  else if ((s08)y < BAR_H)
+    return BAR_H;
+  else
+    return y;
+}
+
+//
+// Function: pongModelCheck
+//
+// Check that the fixed-point ball model plays the same game as the float ball
+// model. Starting from the ball serve position a series of chained ball
+// trajectories is calculated with both models, each from the same trajectory
+// state. In between trajectories a minute or hour change event and the random
+// generator inputs are set from a seeded pseudo-random generator, so a seed
+// always checks the same series. A trajectory differs when any of its ball
+// positions, paddle target or next ball motion differs. Its outcome differs
+// when the ball hit/miss, its play ticks or its end position differs.
+// The fixed-point trajectory is used as start of the next trajectory. When done
+// the pong clock state is restored.
+//
+void pongModelCheck(u32 seed, u32 serves, pongCheck_t *check)
+{
+  pongModel_t clockModel, startModel, floatModel, fixedModel;
+  u08 clockMinuteChanged = minuteChanged;
+  u08 clockHourChanged = hourChanged;
+  u08 clockCycleCounter = mcCycleCounter;
+  u08 clockNewTM = mcClockNewTM;
+  u32 random;
+  u32 i;
+
+  // Save the clock state and set the ball at its serve position
+  pongModelSave(&clockModel);
+  ticksPlay = 0;
+  trajX[0] = GLCD_XPIXELS / 2 - BALL_WIDLEN;
+  trajY[0] = GLCD_YPIXELS / 2 - BALL_WIDLEN;
+  ballDirX = ((seed >> 1) & 0x1) == 0 ? -1 : 1;
+  ballDirY = ((seed >> 2) & 0x1) == 0 ? -1 : 1;
+  ballAngle = ANGLE_NEW;
+  check->serves = 0;
+  check->misses = 0;
+  check->trajDiff = 0;
+  check->outcomeDiff = 0;
+
+  for (i = 0; i < serves; i++)
+  {
+    // Get the trajectory inputs where 1 in 4 trajectories has a time event
+    seed = seed * 1103515245 + 12345;
+    random = seed >> 8;
+    mcCycleCounter = (u08)random;
+    mcClockNewTM = (random >> 8) % 60;
+    minuteChanged = hourChanged = MC_FALSE;
+    if (((random >> 16) & 0x7) == 0)
+      minuteChanged = MC_TRUE;
+    else if (((random >> 16) & 0x7) == 1)
+      hourChanged = MC_TRUE;
+
+    // Calculate trajectory with the float and fixed-point ball model
+    pongModelSave(&startModel);
+    pongModelFloat = MC_TRUE;
+    pongBallTraject();
+    pongModelSave(&floatModel);
+    pongModelLoad(&startModel);
+    pongModelFloat = MC_FALSE;
+    pongBallTraject();
+    pongModelSave(&fixedModel);
+
+    // Compare the trajectories and their outcome
+    check->serves++;
+    if (ticksPlay != paddleTick)
+      check->misses++;
+    if (memcmp(&floatModel, &fixedModel, sizeof(pongModel_t)) != 0)
+      check->trajDiff++;
+    if (floatModel.ticksPlay != fixedModel.ticksPlay ||
+        floatModel.paddleTick != fixedModel.paddleTick ||
+        floatModel.paddleY != fixedModel.paddleY ||
+        floatModel.trajX[ticksPlay] != fixedModel.trajX[ticksPlay] ||
+        floatModel.trajY[ticksPlay] != fixedModel.trajY[ticksPlay])
+      check->outcomeDiff++;
+
+    // Like the clock does, clear a bar hit at the end of the trajectory
+    if (trajY[ticksPlay] >= BAR_HIT)
+      trajY[ticksPlay] = trajY[ticksPlay] - BAR_HIT;
+  }
+
+  // Restore the clock state
+  pongModelLoad(&clockModel);
+  minuteChanged = clockMinuteChanged;
+  hourChanged = clockHourChanged;
+  mcCycleCounter = clockCycleCounter;
+  mcClockNewTM = clockNewTM;
+}
+
+//
+// Function: pongModelLoad
+//
+// Restore a saved ball trajectory state
+//
+static void pongModelLoad(pongModel_t *model)
+{
+  memcpy(trajX, model->trajX, TRAJ_LEN);
+  memcpy(trajY, model->trajY, TRAJ_LEN);
+  ticksPlay = model->ticksPlay;
+  tickNow = model->tickNow;
+  paddle = model->paddle;
+  paddleY = model->paddleY;
+  paddleTick = model->paddleTick;
+  ballDirX = model->ballDirX;
+  ballDirY = model->ballDirY;
+  ballAngle = model->ballAngle;
+  trajId = model->trajId;
+  pongRandBase = model->randBase;
+  pongRandVal = model->randVal;
+}
+
+//
+// Function: pongModelSave
+//
+// Save the ball trajectory state
+//
+static void pongModelSave(pongModel_t *model)
+{
+  memset(model, 0, sizeof(pongModel_t));
+  memcpy(model->trajX, trajX, TRAJ_LEN);
+  memcpy(model->trajY, trajY, TRAJ_LEN);
+  model->ticksPlay = ticksPlay;
+  model->tickNow = tickNow;
+  model->paddle = paddle;
+  model->paddleY = paddleY;
+  model->paddleTick = paddleTick;
+  model->ballDirX = ballDirX;
+  model->ballDirY = ballDirY;
+  model->ballAngle = ballAngle;
+  model->trajId = trajId;
+  model->randBase = pongRandBase;
+  model->randVal = pongRandVal;
+}
+#endif
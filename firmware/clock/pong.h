@@ -12,4 +12,18 @@
 void pongButton(u08 pressedButton);
 void pongCycle(void);
 void pongInit(u08 mode);
+
+#ifdef EMULIN
+// The result of a check of the pong fixed-point versus float ball model
+typedef struct _pongCheck_t
+{
+  u32 serves;			// Number of checked ball trajectories
+  u32 misses;			// Number of trajectories with a paddle miss
+  u32 trajDiff;			// Number of different trajectories
+  u32 outcomeDiff;		// Number of different trajectory outcomes
+} pongCheck_t;
+
+// Check the pong ball model
+void pongModelCheck(u32 seed, u32 serves, pongCheck_t *check);
+#endif
 #endif
@@ -9,7 +9,7 @@
 #include "../avrlibtypes.h"
 
 // The number of clock cycles needed to create and display a QR
-#define QR_GEN_CYCLES	5
+#define QR_GEN_CYCLES	4
 
 // QR clock
 void qrCycle(void);
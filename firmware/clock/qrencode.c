@@ -27,6 +27,18 @@
 //   parameter, it has been removed from the interface. The function has been
 //   modified to use the #define instead. Again, this allows avr-gcc to
 //   generate faster and smaller code.
+// - The badness check of a mask holds the QR rows and (transposed) columns as
+//   bitmasks. Blocks, runs and finder patterns are detected using word-wide
+//   logic rather than inspecting each QR pixel separately, while resulting in
+//   the exact same badness value.
+// - Generating a QR is incremental on the previous QR. Only the ECC of the
+//   changed data codewords is calculated and applied on the previous ECC
+//   (Reed Solomon is linear), only the modules of changed codewords are
+//   toggled in the previous unmasked frame, and per mask only the badness of
+//   the rows and columns with toggled modules is re-calculated. For this the
+//   Reed Solomon generator polynomial is hardcoded and the otherwise unused
+//   part of qrframe holds the unmasked frame and per mask the badness of each
+//   row and column.
 // - The layout of the code has been modified so it adheres more to the coding
 //   standards used within Emuchron. Not really needed, but just a matter of
 //   Emuchron project coding taste.
@@ -61,10 +73,22 @@
 #define VERSION		2
 #define ECCLEVEL	1
 
+// Mask for a QR row or column held in a bitmask
+#define WDMASK		0x1ffffffUL
+
+// The number of data and ecc codewords
+#define CODEWORDS	(DATABLKW + ECCBLKWID)
+
+// Beyond the (masked) QR frame, qrframe holds the unmasked QR frame and per
+// mask the badness of each QR row and column. The end of strinbuf, that is
+// never used by the string to encode, holds the codewords of the QR.
+#define QRBASE		(&qrframe[WD * WDB])
+#define QRLINEBAD(m)	(&qrframe[2 * WD * WDB + (m) * 2 * WD])
+#define QRCODE		(&strinbuf[sizeof(strinbuf) - CODEWORDS])
+
 // Setup fixed QR environment: redundancy 1 (L), level 2 (25x25)
 unsigned char strinbuf[100];
 unsigned char qrframe[600];
-static unsigned char rlens[26];
 
 static const unsigned char framebase[] PROGMEM =
 {
@@ -161,6 +185,12 @@ static const unsigned fmtword[] PROGMEM =
   //0x1689, 0x13be, 0x1ce7, 0x19d0, 0x0762, 0x0255, 0x0d0c, 0x083b,     //H
 };
 
+// Reed Solomon generator polynomial (as logs) for the ecc codewords
+static const unsigned char genpoly[ECCBLKWID + 1] PROGMEM =
+{
+  0x2d,0x20,0x5e,0x40,0x46,0x76,0x3d,0x2e,0x43,0xfb,0x00
+};
+
 // Badness coefficients
 static const unsigned char N1 = 3;
 static const unsigned char N2 = 3;
@@ -172,17 +202,28 @@ static unsigned mindem;
 static unsigned char best;
 static unsigned char lastMask;
 
+// Incremental QR generation: whether the unmasked frame and codewords of a
+// previous QR are available, the masks tried on the current QR, the masks
+// with line badness of the previous QR, and the rows and columns that differ
+// from the previous QR (bit y for row y and bit WD - 1 - x for column x)
+static unsigned char framevalid;
+static unsigned char masktried;
+static unsigned char maskvalid;
+static uint32_t dirtyrows;
+static uint32_t dirtycols;
+
 // Local function prototypes
 static unsigned modnn(unsigned x);
-static void initrspoly(unsigned char *genpoly);
 static void appendrs(unsigned char *data, unsigned char dlen,
-  unsigned char *ecbuf, unsigned char eclen, unsigned char *genpoly);
+  unsigned char *ecbuf, unsigned char eclen);
 static void stringtoqr(void);
 static unsigned char ismasked(unsigned char x, unsigned char y);
 static void fillframe(void);
 static void applymask(unsigned char m);
-static unsigned badruns(unsigned char length);
-static int badcheck(void);
+static unsigned char bitcount(uint32_t bits);
+static uint32_t bitruns(uint32_t bits, unsigned char length);
+static unsigned badruns(uint32_t line);
+static int badcheck(unsigned char mask);
 static void addfmt(unsigned char masknum);
 
 //
@@ -197,10 +238,16 @@ void qrGenInit(void)
   best = 0;
   mindem = 30000;
 
-  // Init text to QR and QR frame
+  // Only masks tried on the previous QR can be re-scored incrementally
+  maskvalid = (framevalid ? masktried : 0);
+  masktried = 0;
+
+  // Init text to QR and QR frame, and keep its codewords and unmasked frame
   stringtoqr();
   fillframe();
-  memcpy(strinbuf, qrframe, WD * WDB);
+  memcpy(QRCODE, strinbuf, CODEWORDS);
+  memcpy(QRBASE, qrframe, WD * WDB);
+  framevalid = 1;
 }
 
 //
@@ -215,7 +262,7 @@ void qrMaskTry(unsigned char mask)
 
   // When not the first mask reset filled frame
   if (lastMask != 255)
-    memcpy(qrframe, strinbuf, WD * WDB);
+    memcpy(qrframe, QRBASE, WD * WDB);
 
   // Set the last tried mask for this run
   lastMask = mask;
@@ -224,7 +271,7 @@ void qrMaskTry(unsigned char mask)
   applymask(mask);
 
   // Get black-white imbalance and see if mask is (for now) the best
-  badness = badcheck();
+  badness = badcheck(mask);
   if (badness < mindem)
   {
     mindem = badness;
@@ -243,7 +290,7 @@ unsigned char qrMaskApply(void)
   // filled frame and redo the best mask
   if (best != lastMask)
   {
-    memcpy(qrframe, strinbuf, WD * WDB);
+    memcpy(qrframe, QRBASE, WD * WDB);
     applymask(best);
   }
 
@@ -265,25 +312,8 @@ static unsigned modnn(unsigned x)
   return x;
 }
 
-static void initrspoly(unsigned char *genpoly)
-{
-  unsigned char i, j;
-
-  genpoly[0] = 1;
-  for (i = 0; i < ECCBLKWID; i++)
-  {
-    genpoly[i + 1] = 1;
-    for (j = i; j > 0; j--)
-      genpoly[j] = genpoly[j] ?
-        genpoly[j - 1] ^ gexp(modnn(glog(genpoly[j]) + i)) : genpoly[j - 1];
-    genpoly[0] = gexp(modnn(glog(genpoly[0]) + i));
-  }
-  for (i = 0; i <= ECCBLKWID; i++)
-    genpoly[i] = glog(genpoly[i]);  // Use logs for genpoly[]
-}
-
 static void appendrs(unsigned char *data, unsigned char dlen,
-  unsigned char *ecbuf, unsigned char eclen, unsigned char *genpoly)
+  unsigned char *ecbuf, unsigned char eclen)
 {
   unsigned char i, j, fb;
 
@@ -294,13 +324,14 @@ static void appendrs(unsigned char *data, unsigned char dlen,
     if (fb != 255)  // fb term is non-zero
     {
       for (j = 1; j < eclen; j++)
-        ecbuf[j-1] = ecbuf[j] ^ gexp(modnn(fb + genpoly[eclen - j]));
+        ecbuf[j-1] = ecbuf[j] ^
+          gexp(modnn(fb + __LPM(&genpoly[eclen - j])));
     }
     else
     {
       memmove(ecbuf, ecbuf + 1, eclen - 1);
     }
-    ecbuf[eclen - 1] = fb == 255 ? 0 : gexp(modnn(fb + genpoly[0]));
+    ecbuf[eclen - 1] = fb == 255 ? 0 : gexp(modnn(fb + __LPM(&genpoly[0])));
   }
 }
 
@@ -355,19 +386,32 @@ static void stringtoqr(void)
   // Calculate and append ECC
   unsigned char *ecc = &strinbuf[max];
   unsigned char *dat = strinbuf;
-  initrspoly(qrframe);
-
-  for (i = 0; i < NECCBLK1; i++)
+  if (framevalid)
   {
-    appendrs(dat, DATABLKW, ecc, ECCBLKWID, qrframe);
-    dat += DATABLKW;
-    ecc += ECCBLKWID;
+    // Reed Solomon is linear, so get the ECC of the changed data codewords
+    // only, skipping the unchanged leading ones, and apply it on the ECC of
+    // the previous QR (its single data block)
+    for (i = 0; i < DATABLKW; i++)
+      qrframe[i] = strinbuf[i] ^ QRCODE[i];
+    for (i = 0; i < DATABLKW && qrframe[i] == 0; i++);
+    appendrs(&qrframe[i], DATABLKW - i, ecc, ECCBLKWID);
+    for (i = 0; i < ECCBLKWID; i++)
+      ecc[i] ^= QRCODE[DATABLKW + i];
   }
-  for (i = 0; i < NECCBLK2; i++)
+  else
   {
-    appendrs(dat, DATABLKW + 1, ecc, ECCBLKWID, qrframe);
-    dat += DATABLKW + 1;
-    ecc += ECCBLKWID;
+    for (i = 0; i < NECCBLK1; i++)
+    {
+      appendrs(dat, DATABLKW, ecc, ECCBLKWID);
+      dat += DATABLKW;
+      ecc += ECCBLKWID;
+    }
+    for (i = 0; i < NECCBLK2; i++)
+    {
+      appendrs(dat, DATABLKW + 1, ecc, ECCBLKWID);
+      dat += DATABLKW + 1;
+      ecc += ECCBLKWID;
+    }
   }
 
   unsigned j;
@@ -412,7 +456,13 @@ static void fillframe(void)
   unsigned char d, j;
   unsigned char x, y, ffdecy, ffgohv;
 
-  memcpy_P(qrframe, framebase, WDB * WD);
+  // For a previous QR only toggle the modules of its changed codewords
+  dirtyrows = 0;
+  dirtycols = 0;
+  if (framevalid)
+    memcpy(qrframe, QRBASE, WD * WDB);
+  else
+    memcpy_P(qrframe, framebase, WDB * WD);
   x = y = WD - 1;
   ffdecy = 1;  // Up, minus
   ffgohv = 1;
@@ -421,6 +471,8 @@ static void fillframe(void)
   for (i = 0; i < ((DATABLKW + ECCBLKWID) * (NECCBLK1 + NECCBLK2) + NECCBLK2); i++)
   {
     d = strinbuf[i];
+    if (framevalid)
+      d ^= QRCODE[i];
     for (j = 0; j < 8; j++, d <<= 1)
     {
       if (i || j)
@@ -475,7 +527,16 @@ static void fillframe(void)
       }
       if (0x80 & d)
       {
-        SETQRBIT(x, y);
+        if (framevalid)
+        {
+          TOGQRBIT(x, y);
+          dirtyrows |= (uint32_t)1 << y;
+          dirtycols |= (uint32_t)1 << (WD - 1 - x);
+        }
+        else
+        {
+          SETQRBIT(x, y);
+        }
       }
     }
   }
@@ -589,71 +650,127 @@ static void applymask(unsigned char m)
   }
 }
 
-static unsigned badruns(unsigned char length)
+static unsigned char bitcount(uint32_t bits)
 {
-  unsigned char i;
-  unsigned runsbad = 0;
-  for (i = 0; i <= length; i++)
-    if (rlens[i] >= 5)
-      runsbad += N1 + rlens[i] - 5;
-  // BwBBBwB
-  for (i = 3; i < length - 1; i += 2)
+  unsigned char count = 0;
+  while (bits)
   {
-    if (rlens[i - 2] == rlens[i + 2] &&
-        rlens[i + 2] == rlens[i - 1] &&
-        rlens[i - 1] == rlens[i + 1] &&
-        rlens[i - 1] * 3 == rlens[i] &&
-        // White around the black pattern? Not part of spec.
-        (rlens[i - 3] == 0   // Beginning
-          || i + 3 > length  // Wnd
-          || rlens[i - 3] * 3 >= rlens[i] * 4
-          || rlens[i + 3] * 3 >= rlens[i] * 4))
-    {
-      runsbad += N3;
-    }
+    bits &= bits - 1;
+    count++;
+  }
+  return count;
+}
+
+// Mark the bits where a run of (at least) length set bits starts
+static uint32_t bitruns(uint32_t bits, unsigned char length)
+{
+  unsigned char span = 1;
+  while (span * 2 <= length)
+  {
+    bits &= bits >> span;
+    span *= 2;
+  }
+  return bits & (bits >> (length - span));
+}
+
+// Badness of the runs in a row or column with bit 0 at the edge of the QR
+static unsigned badruns(uint32_t line)
+{
+  uint32_t blank = ~line & WDMASK;
+  uint32_t bits, pad, end;
+  unsigned runsbad;
+  unsigned char k;
+
+  // Runs of 5 or more same color bits
+  bits = bitruns(line, 5) | bitruns(blank, 5);
+  runsbad = bitcount(bits) + (N1 - 1) * bitcount(bits & ~(bits << 1));
+
+  // BwBBBwB in 1:1:3:1:1 ratio with white bits or edge around it, and either
+  // touching an edge or having a white run of 4 blocks on one side.
+  // When there is no center black run there is none for a larger ratio either.
+  for (k = 1; k * 7 <= WD; k++)
+  {
+    bits = bitruns(line, 3 * k) >> (2 * k);
+    if (bits == 0)
+      break;
+    bits = bits & bitruns(line, k) & (bitruns(blank, k) >> k) &
+      (bitruns(blank, k) >> (5 * k)) & (bitruns(line, k) >> (6 * k));
+    end = (uint32_t)1 << (WD - 7 * k);
+    bits = bits & ((blank << 1) | 1) & ((blank >> (7 * k)) | end);
+    pad = bitruns(blank, 4 * k);
+    bits = bits & (((pad << (4 * k)) | 1) | ((pad >> (7 * k)) | end));
+    runsbad += bitcount(bits) * N3;
   }
   return runsbad;
 }
 
-static int badcheck(void)
+// Note: The badness of a row (including its blocks of same color with the
+// next row) and of a column is assumed to fit in a byte
+static int badcheck(unsigned char mask)
 {
-  unsigned char x, y, h, b, b1;
+  unsigned char *linebad = QRLINEBAD(mask);
+  uint32_t cols[WD];
+  uint32_t row, last = 0, bits, rowsel, colsel;
+  unsigned char x, y, blocks;
   unsigned thisbad = 0;
-  int bw = 0;
+  unsigned black = 0;
+  int bw;
 
-  // Blocks of same color.
-  for (y = 0; y < WD - 1; y++)
+  // Select the rows and columns to score. For a mask tried on the previous
+  // QR these are the rows and columns with toggled modules, where a toggled
+  // row also affects the blocks of same color with the row above it.
+  if (maskvalid & (1 << mask))
   {
-    for (x = 0; x < WD - 1; x++)
-    {
-      if ((QRBIT(x, y) && QRBIT(x + 1, y) &&
-           QRBIT(x, y + 1) && QRBIT(x + 1, y + 1))   // All black
-          ||
-          !(QRBIT(x, y) || QRBIT(x + 1, y) ||
-            QRBIT(x, y + 1) || QRBIT(x + 1, y + 1))) // All white
-      {
-        thisbad += N2;
-      }
-    }
+    rowsel = dirtyrows | (dirtyrows >> 1);
+    colsel = dirtycols;
+  }
+  else
+  {
+    rowsel = WDMASK;
+    colsel = WDMASK;
   }
+  masktried |= (1 << mask);
 
-  // X runs
+  memset(cols, 0, sizeof(cols));
   for (y = 0; y < WD; y++)
   {
-    rlens[0] = 0;
-    for (h = b = x = 0; x < WD; x++)
+    // Get the row as a bitmask and add it to the selected transposed columns
+    row = ((uint32_t)qrframe[y * WDB] << 17) |
+      ((uint32_t)qrframe[y * WDB + 1] << 9) |
+      ((uint32_t)qrframe[y * WDB + 2] << 1) | (qrframe[y * WDB + 3] >> 7);
+    for (x = 0, bits = colsel; bits != 0; x++, bits >>= 1)
+      if (bits & 1)
+        cols[x] = (cols[x] << 1) | ((row >> x) & 1);
+    black += bitcount(row);
+
+    // X runs of the previous row and its blocks of same color with this row
+    if (y > 0)
     {
-      if ((b1 = QRBIT(x, y)) == b)
-        rlens[h]++;
-      else
-        rlens[++h] = 1;
-      b = b1;
-      bw += b ? 1 : -1;
+      if (rowsel & 1)
+      {
+        bits = row & last;
+        blocks = bitcount(bits & (bits >> 1));
+        bits = ~(row | last) & WDMASK;
+        blocks += bitcount(bits & (bits >> 1));
+        linebad[y - 1] = badruns(last) + blocks * N2;
+      }
+      rowsel >>= 1;
     }
-    thisbad += badruns(h);
+    last = row;
   }
+  if (rowsel & 1)
+    linebad[WD - 1] = badruns(last);
+
+  // Y runs
+  for (x = 0, bits = colsel; bits != 0; x++, bits >>= 1)
+    if (bits & 1)
+      linebad[WD + x] = badruns(cols[x]);
+
+  for (x = 0; x < 2 * WD; x++)
+    thisbad += linebad[x];
 
   // Black/white imbalance
+  bw = 2 * black - WD * WD;
   if (bw < 0)
     bw = -bw;
 
@@ -664,21 +781,6 @@ static int badcheck(void)
   while (big > WD * WD)
     big -= WD * WD, count++;
   thisbad += count * N4;
-
-  // Y runs
-  for (x = 0; x < WD; x++)
-  {
-    rlens[0] = 0;
-    for (h = b = y = 0; y < WD; y++)
-    {
-      if ((b1 = QRBIT(x, y)) == b)
-        rlens[h]++;
-      else
-        rlens[++h] = 1;
-      b = b1;
-    }
-    thisbad += badruns(h);
-  }
   return thisbad;
 }
 
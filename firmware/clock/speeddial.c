@@ -3,10 +3,10 @@
 // Title    : Animation code for MONOCHRON speed dial clock
 //*****************************************************************************
 
-#include <math.h>
 #include "../global.h"
 #include "../glcd.h"
 #include "../anim.h"
+#include "../trig.h"
 #include "spotfire.h"
 #include "speeddial.h"
 
@@ -20,9 +20,12 @@
 #define SPEED_VALUE_Y_OFFSET	6
 #define SPEED_MARK_RADIUS	(SPEED_RADIUS - 1.6)
 #define SPEED_NDL_RADIUS	(SPEED_RADIUS - 1.6)
-#define SPEED_NDL_RADIAL_STEPS	60.0
-#define SPEED_NDL_RADIAL_START	(-0.75 * M_PI)
-#define SPEED_NDL_RADIAL_SIZE	(1.50 * M_PI)
+#define SPEED_NDL_ANGLE_STEPS	60
+#define SPEED_NDL_ANGLE_START	TRIG_ANGLE(5, 8)
+
+// The needle angle of a value in a dial of 0.75 circle
+#define SPEED_NDL_ANGLE(v, steps) \
+  (SPEED_NDL_ANGLE_START + TRIG_ANGLE(3 * (v), 4 * (steps)))
 
 // Monochron environment variables
 extern volatile uint8_t mcClockOldTS, mcClockOldTM, mcClockOldTH;
@@ -92,7 +95,7 @@ void spotSpeedDialInit(u08 mode)
 static void spotSpeedNeedleUpdate(u08 x, u08 oldVal, u08 newVal)
 {
   s08 oldDx, newDx, oldDy, newDy;
-  float tmp;
+  u16 angle;
   char needleValue[3];
 
   // See if we need to update the needle
@@ -100,18 +103,12 @@ static void spotSpeedNeedleUpdate(u08 x, u08 oldVal, u08 newVal)
     return;
 
   // Calculate changes in needle
-  tmp = sin(SPEED_NDL_RADIAL_SIZE / SPEED_NDL_RADIAL_STEPS * oldVal +
-    SPEED_NDL_RADIAL_START);
-  oldDx = (s08)(tmp * SPEED_NDL_RADIUS);
-  tmp = -cos(SPEED_NDL_RADIAL_SIZE / SPEED_NDL_RADIAL_STEPS * oldVal +
-    SPEED_NDL_RADIAL_START);
-  oldDy = (s08)(tmp * SPEED_NDL_RADIUS);
-  tmp = sin(SPEED_NDL_RADIAL_SIZE / SPEED_NDL_RADIAL_STEPS * newVal +
-    SPEED_NDL_RADIAL_START);
-  newDx = (s08)(tmp * SPEED_NDL_RADIUS);
-  tmp = -cos(SPEED_NDL_RADIAL_SIZE / SPEED_NDL_RADIAL_STEPS * newVal +
-    SPEED_NDL_RADIAL_START);
-  newDy = (s08)(tmp * SPEED_NDL_RADIUS);
+  angle = SPEED_NDL_ANGLE(oldVal, SPEED_NDL_ANGLE_STEPS);
+  oldDx = TRIG_Q88_INT(trigSinMul(angle, TRIG_Q88(SPEED_NDL_RADIUS)));
+  oldDy = TRIG_Q88_INT(-trigCosMul(angle, TRIG_Q88(SPEED_NDL_RADIUS)));
+  angle = SPEED_NDL_ANGLE(newVal, SPEED_NDL_ANGLE_STEPS);
+  newDx = TRIG_Q88_INT(trigSinMul(angle, TRIG_Q88(SPEED_NDL_RADIUS)));
+  newDy = TRIG_Q88_INT(-trigCosMul(angle, TRIG_Q88(SPEED_NDL_RADIUS)));
 
   // Only work on the needle when it has changed
   if (oldDx != newDx || oldDy != newDy || mcClockInit == MC_TRUE)
@@ -143,12 +140,11 @@ static void spotSpeedNeedleUpdate(u08 x, u08 oldVal, u08 newVal)
 static void spotSpeedDialMarkerUpdate(u08 x, u08 marker)
 {
   s08 dx, dy;
-  float tmp;
+  u16 angle;
 
   // Paint 10-minute marker in speed dial
-  tmp = sin(SPEED_NDL_RADIAL_SIZE / 6.0 * marker + SPEED_NDL_RADIAL_START);
-  dx = (s08)(tmp * SPEED_MARK_RADIUS);
-  tmp = -cos(SPEED_NDL_RADIAL_SIZE / 6.0 * marker + SPEED_NDL_RADIAL_START);
-  dy = (s08)(tmp * SPEED_MARK_RADIUS);
+  angle = SPEED_NDL_ANGLE(marker, 6);
+  dx = TRIG_Q88_INT(trigSinMul(angle, TRIG_Q88(SPEED_MARK_RADIUS)));
+  dy = TRIG_Q88_INT(-trigCosMul(angle, TRIG_Q88(SPEED_MARK_RADIUS)));
   glcdDot(x + dx, SPEED_Y_START + dy);
 }
@@ -3,25 +3,23 @@
 // Title    : Animation code for MONOCHRON spider plot clock
 //*****************************************************************************
 
-#include <math.h>
 #include "../global.h"
 #include "../glcd.h"
 #include "../anim.h"
+#include "../trig.h"
 #include "spotfire.h"
 #include "spiderplot.h"
 
 // Specifics for spider plot clock
-#define SQRT2			(sqrt(2.0))
-#define SINPI3			(sin(M_PI / 3.0))
-#define COSPI3			(cos(M_PI / 3.0))
+#define ANGLEPI3		TRIG_ANGLE(1, 6)
 #define SPDR_AXIS_SEC		0
 #define SPDR_AXIS_MIN		1
 #define SPDR_AXIS_HOUR		2
 #define SPDR_X_START		52
 #define SPDR_Y_START		39
 #define SPDR_RADIUS		22
-#define SPDR_AXIS_MS_STEPS	60.0
-#define SPDR_AXIS_H_STEPS	24.0
+#define SPDR_AXIS_MS_STEPS	60
+#define SPDR_AXIS_H_STEPS	24
 #define SPDR_SEC_VAL_X_START	79
 #define SPDR_SEC_VAL_Y_START	33
 #define SPDR_MIN_VAL_X_START	16
@@ -95,10 +93,10 @@ void spotSpiderPlotCycle(void)
   if (mcClockNewTS != mcClockOldTS && mcClockNewTM == mcClockOldTM &&
     mcClockNewTH == mcClockOldTH && mcClockInit == MC_FALSE)
   {
-    if ((u08)((float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) /
-        SPDR_AXIS_MS_STEPS * mcClockOldTS) ==
-        (u08)((float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) /
-        SPDR_AXIS_MS_STEPS * mcClockNewTS))
+    if ((SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * mcClockOldTS /
+        SPDR_AXIS_MS_STEPS ==
+        (SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * mcClockNewTS /
+        SPDR_AXIS_MS_STEPS)
       return;
   }
 
@@ -121,12 +119,10 @@ void spotSpiderPlotCycle(void)
   // Repaint the dotted inner circles at logical position 20 and 40 in case
   // they got distorted by updating the connector and axis lines
   glcdCircle2(SPDR_X_START, SPDR_Y_START,
-    (u08)((float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / 3.0 +
-      SPDR_AXIS_VAL_BEGIN),
+    (SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / 3 + SPDR_AXIS_VAL_BEGIN,
     CIRCLE_THIRD);
   glcdCircle2(SPDR_X_START, SPDR_Y_START,
-    (u08)((float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / 3.0 * 2.0 +
-      SPDR_AXIS_VAL_BEGIN),
+    (SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * 2 / 3 + SPDR_AXIS_VAL_BEGIN,
     CIRCLE_HALF_E);
 }
 
@@ -168,47 +164,47 @@ void spotSpiderPlotInit(u08 mode)
 static void spotSpiderAxisConnUpdate(u08 axisStart, u08 valStart, u08 valEnd)
 {
   s08 startX, startY, endX, endY;
-  float tmp;
+  s16 tmp;
 
-  // Get the x/y position of the axisStart value
+  // Get the x/y position of the axisStart value. The axis value is in Q8.8.
   if (axisStart == SPDR_AXIS_HOUR)
-    tmp = (float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / SPDR_AXIS_H_STEPS *
-      valStart + SPDR_AXIS_VAL_BEGIN;
+    tmp = (s32)TRIG_Q88(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * valStart /
+      SPDR_AXIS_H_STEPS + TRIG_Q88(SPDR_AXIS_VAL_BEGIN);
   else
-    tmp = (float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / SPDR_AXIS_MS_STEPS *
-      valStart + SPDR_AXIS_VAL_BEGIN;
+    tmp = (s32)TRIG_Q88(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * valStart /
+      SPDR_AXIS_MS_STEPS + TRIG_Q88(SPDR_AXIS_VAL_BEGIN);
   if (axisStart == SPDR_AXIS_SEC)
   {
-    startX = SPDR_X_START + (u08)(tmp);
+    startX = SPDR_X_START + TRIG_Q88_INT(tmp);
     startY = SPDR_Y_START;
   }
   else
   {
-    startX = SPDR_X_START - (u08)(tmp * COSPI3);
+    startX = SPDR_X_START - TRIG_Q88_INT(trigCosMul(ANGLEPI3, tmp));
     if (axisStart == SPDR_AXIS_MIN)
-      startY = SPDR_Y_START + (u08)(tmp * SINPI3);
+      startY = SPDR_Y_START + TRIG_Q88_INT(trigSinMul(ANGLEPI3, tmp));
     else
-      startY = SPDR_Y_START - (u08)(tmp * SINPI3);
+      startY = SPDR_Y_START - TRIG_Q88_INT(trigSinMul(ANGLEPI3, tmp));
   }
   // Get the x/y position of the axisEnd value (derived from axisStart)
   if (axisStart == SPDR_AXIS_MIN)
-    tmp = (float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / SPDR_AXIS_H_STEPS *
-      valEnd + SPDR_AXIS_VAL_BEGIN;
+    tmp = (s32)TRIG_Q88(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * valEnd /
+      SPDR_AXIS_H_STEPS + TRIG_Q88(SPDR_AXIS_VAL_BEGIN);
   else
-    tmp = (float)(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) / SPDR_AXIS_MS_STEPS *
-      valEnd + SPDR_AXIS_VAL_BEGIN;
+    tmp = (s32)TRIG_Q88(SPDR_AXIS_VAL_END - SPDR_AXIS_VAL_BEGIN) * valEnd /
+      SPDR_AXIS_MS_STEPS + TRIG_Q88(SPDR_AXIS_VAL_BEGIN);
   if (axisStart == SPDR_AXIS_HOUR)
   {
-    endX = SPDR_X_START + (u08)(tmp);
+    endX = SPDR_X_START + TRIG_Q88_INT(tmp);
     endY = SPDR_Y_START;
   }
   else
   {
-    endX = SPDR_X_START - (u08)(tmp * COSPI3);
+    endX = SPDR_X_START - TRIG_Q88_INT(trigCosMul(ANGLEPI3, tmp));
     if (axisStart == SPDR_AXIS_SEC)
-      endY = SPDR_Y_START + (u08)(tmp * SINPI3);
+      endY = SPDR_Y_START + TRIG_Q88_INT(trigSinMul(ANGLEPI3, tmp));
     else
-      endY = SPDR_Y_START - (u08)(tmp * SINPI3);
+      endY = SPDR_Y_START - TRIG_Q88_INT(trigSinMul(ANGLEPI3, tmp));
   }
 
   // Draw the connector line.
@@ -222,11 +218,11 @@ static void spotSpiderAxisConnUpdate(u08 axisStart, u08 valStart, u08 valEnd)
 
   // Draw the axis line
   if (axisStart == SPDR_AXIS_HOUR)
-    glcdLine(startX, startY, SPDR_X_START - (u08)(SPDR_RADIUS * COSPI3),
-      SPDR_Y_START - (u08)(SPDR_RADIUS * SINPI3));
+    glcdLine(startX, startY, SPDR_X_START - trigCosMul(ANGLEPI3, SPDR_RADIUS),
+      SPDR_Y_START - trigSinMul(ANGLEPI3, SPDR_RADIUS));
   else if (axisStart == SPDR_AXIS_MIN)
-    glcdLine(startX, startY, SPDR_X_START - (u08)(SPDR_RADIUS * COSPI3),
-      SPDR_Y_START + (u08)(SPDR_RADIUS * SINPI3));
+    glcdLine(startX, startY, SPDR_X_START - trigCosMul(ANGLEPI3, SPDR_RADIUS),
+      SPDR_Y_START + trigSinMul(ANGLEPI3, SPDR_RADIUS));
   else
     glcdLine(startX, startY, SPDR_X_START + SPDR_RADIUS, startY);
 }
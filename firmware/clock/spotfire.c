@@ -27,6 +27,8 @@
 #define FP_RF_Y_OFFSET	6
 #define FP_RF_WIDTH	FP_RS_WIDTH + 4
 #define FP_RF_HEIGHT	FP_RS_HEIGHT + 6
+#define FP_RS_COUNT	3
+#define FP_RS_NONE	255
 
 // Specifics for the menu bar layout
 #define MBAR_TXT_LEFT	0
@@ -47,7 +49,6 @@ typedef struct
 } menuBarDriver_t;
 
 // Monochron environment variables
-extern volatile uint8_t mcClockOldTS, mcClockOldTM, mcClockOldTH;
 extern volatile uint8_t mcClockNewTS, mcClockNewTM, mcClockNewTH;
 extern volatile uint8_t mcClockNewDD, mcClockNewDM;
 extern volatile uint8_t mcClockInit;
@@ -77,9 +78,16 @@ static menuBarDriver_t menuBarDriver[] =
 // Contains the current message of the Spotfire menu bar
 static u08 menuBarId;
 
+// Contains the end x position of the visualization title bar label and the
+// current location marker x position of the hour, min and sec range slider.
+// As the title bar and filter panel are kept when switching between Spotfire
+// clocks using a partial init, these are used to draw only what has changed.
+static u08 titleEnd;
+static u08 sliderXPos[FP_RS_COUNT];
+
 // Local function prototypes
 static void spotMenuBarUpdate(void);
-static void spotRangeSliderUpdate(u08 y, u08 maxVal, u08 oldVal, u08 newVal);
+static void spotRangeSliderUpdate(u08 slider, u08 maxVal, u08 newVal);
 
 //
 // Function: spotAxisInit
@@ -160,32 +168,33 @@ void spotBarUpdate(u08 x, u08 width, u08 oldVal, u08 newVal, s08 valXOffset,
   newBarHeight =
     (u08)((SPOT_BAR_HEIGHT_MAX / (float)SPOT_BAR_VAL_STEPS) * newVal + 0.5);
 
-  // If there are no changes in barheight there's no need to repaint the bar
-  if (oldBarHeight != newBarHeight || mcClockInit == MC_TRUE)
-  {
-    // Paint new bar
-    if (fillType == FILL_BLANK)
-    {
-      // A FILL_BLANK is in fact drawing the outline of the bar first and
-      // then fill it with blank
-      glcdRectangle(x, SPOT_BAR_Y_START - newBarHeight, width,
-        newBarHeight + 1);
-      if (newBarHeight > 1)
-        glcdFillRectangle2(x + 1, SPOT_BAR_Y_START - newBarHeight + 1,
-          width - 2, newBarHeight - 1, ALIGN_TOP, fillType);
-    }
-    else
-    {
-      glcdFillRectangle2(x, SPOT_BAR_Y_START - newBarHeight, width,
-        newBarHeight + 1, ALIGN_BOTTOM, fillType);
-    }
-  }
-
   // Add the bar value (depending on bar value font size)
   animValToStr(newVal, barValue);
   glcdPutStr2(x + valXOffset, SPOT_BAR_Y_START - newBarHeight +
     SPOT_BAR_VAL_Y_OFFSET, FONT_5X7M, barValue);
 
+  // If there are no changes in barheight there's no need to repaint the bar
+  // nor to clear the area around the bar value
+  if (oldBarHeight == newBarHeight && mcClockInit == MC_FALSE)
+    return;
+
+  // Paint new bar
+  if (fillType == FILL_BLANK)
+  {
+    // A FILL_BLANK is in fact drawing the outline of the bar first and then
+    // fill it with blank
+    glcdRectangle(x, SPOT_BAR_Y_START - newBarHeight, width,
+      newBarHeight + 1);
+    if (newBarHeight > 1)
+      glcdFillRectangle2(x + 1, SPOT_BAR_Y_START - newBarHeight + 1,
+        width - 2, newBarHeight - 1, ALIGN_TOP, fillType);
+  }
+  else
+  {
+    glcdFillRectangle2(x, SPOT_BAR_Y_START - newBarHeight, width,
+      newBarHeight + 1, ALIGN_BOTTOM, fillType);
+  }
+
   // Clear the first line between the bar and the bar value
   glcdColorSetBg();
   glcdFillRectangle(x, SPOT_BAR_Y_START - newBarHeight - 1, width, 1);
@@ -217,21 +226,23 @@ void spotCommonInit(char *label, u08 mode)
   // Either clear everything or only the chart area
   if (mode == DRAW_INIT_PARTIAL)
   {
-    u08 pxDone;
+    u08 pxEnd;
 
     // Partial init: clear only the chart area
     glcdColorSetBg();
     glcdFillRectangle(0, 16, 100, 48);
     glcdColorSetFg();
 
-    // Visualization title bar
-    pxDone = glcdPutStr2(2, 9, FONT_5X5P, label);
-    if (pxDone + 2 < AD_X_START)
+    // Visualization title bar where only the remainder of a longer previous
+    // label needs to be cleared
+    pxEnd = glcdPutStr2(2, 9, FONT_5X5P, label) + 2;
+    if (pxEnd < titleEnd)
     {
       glcdColorSetBg();
-      glcdFillRectangle(pxDone + 2, 9, AD_X_START - pxDone - 2, 5);
+      glcdFillRectangle(pxEnd, 9, titleEnd - pxEnd, 5);
       glcdColorSetFg();
     }
+    titleEnd = pxEnd;
   }
   else
   {
@@ -247,7 +258,7 @@ void spotCommonInit(char *label, u08 mode)
     spotMenuBarUpdate();
 
     // Init the visualization title bar label
-    glcdPutStr2(2, 9, FONT_5X5P, label);
+    titleEnd = glcdPutStr2(2, 9, FONT_5X5P, label) + 2;
 
     // Filter panel label
     glcdPutStr2(104, 9, FONT_5X5P, "FILTERS");
@@ -271,6 +282,7 @@ void spotCommonInit(char *label, u08 mode)
       glcdFillRectangle(FP_X_START + FP_RS_X_OFFSET,
         FP_Y_START + i * FP_Y_OFFSET_SIZE + FP_RS_Y_OFFSET, FP_RS_WIDTH,
         FP_RS_HEIGHT);
+      sliderXPos[i] = FP_RS_NONE;
     }
   }
 }
@@ -294,12 +306,9 @@ u08 spotCommonUpdate(void)
   spotMenuBarUpdate();
 
   // Update the filter panel range sliders (if needed)
-  spotRangeSliderUpdate(FP_Y_START + 2 * FP_Y_OFFSET_SIZE, FP_SEC_MAX,
-    mcClockOldTS, mcClockNewTS);
-  spotRangeSliderUpdate(FP_Y_START + FP_Y_OFFSET_SIZE, FP_MIN_MAX,
-    mcClockOldTM, mcClockNewTM);
-  spotRangeSliderUpdate(FP_Y_START, FP_HOUR_MAX, mcClockOldTH,
-    mcClockNewTH);
+  spotRangeSliderUpdate(2, FP_SEC_MAX, mcClockNewTS);
+  spotRangeSliderUpdate(1, FP_MIN_MAX, mcClockNewTM);
+  spotRangeSliderUpdate(0, FP_HOUR_MAX, mcClockNewTH);
 
   return MC_TRUE;
 }
@@ -368,32 +377,30 @@ static void spotMenuBarUpdate(void)
 //
 // Function: spotRangeSliderUpdate
 //
-// Update a single filter panel range slider
+// Update a single filter panel range slider. Only the pixels of the old and new
+// location marker that are not on the range slider bar are updated.
 //
-static void spotRangeSliderUpdate(u08 y, u08 maxVal, u08 oldVal, u08 newVal)
+static void spotRangeSliderUpdate(u08 slider, u08 maxVal, u08 newVal)
 {
-  u08 sliderXPosOld;
   u08 sliderXPosNew;
+  u08 x = FP_X_START + FP_RS_X_OFFSET;
+  u08 y = FP_Y_START + slider * FP_Y_OFFSET_SIZE + FP_RS_Y_OFFSET;
 
-  // Skip if there's nothing to do
-  if (oldVal == newVal && mcClockInit == MC_FALSE)
-    return;
-
-  // Get xpos of old and new marker
-  sliderXPosOld = (u08)(((FP_RS_WIDTH - 2) / (float) maxVal) * oldVal + 0.5);
+  // Get xpos of new marker and skip if it's already there
   sliderXPosNew = (u08)(((FP_RS_WIDTH - 2) / (float) maxVal) * newVal + 0.5);
+  if (sliderXPos[slider] == sliderXPosNew)
+    return;
 
-  // Only update if there's a need to
-  if (sliderXPosOld != sliderXPosNew || mcClockInit == MC_TRUE)
+  // Clear old range slider location marker above and below the slider bar
+  if (sliderXPos[slider] != FP_RS_NONE)
   {
-    // Clear range slider location marker area
     glcdColorSetBg();
-    glcdRectangle(FP_X_START + FP_RS_X_OFFSET - 1, y + FP_RS_Y_OFFSET - 1,
-      FP_RS_WIDTH + 2, FP_RS_HEIGHT + 2);
+    glcdFillRectangle(x + sliderXPos[slider], y - 1, 2, 1);
+    glcdFillRectangle(x + sliderXPos[slider], y + FP_RS_HEIGHT, 2, 1);
     glcdColorSetFg();
-
-    // Add new range slider location markers
-    glcdFillRectangle(FP_X_START + FP_RS_X_OFFSET + sliderXPosNew,
-      y + FP_RS_Y_OFFSET - 1, 2, FP_RS_HEIGHT + 2);
   }
+
+  // Add new range slider location marker
+  glcdFillRectangle(x + sliderXPosNew, y - 1, 2, FP_RS_HEIGHT + 2);
+  sliderXPos[slider] = sliderXPosNew;
 }
@@ -232,6 +232,7 @@ static void cfgMenuAlarmShow(void)
   uint8_t i;
 
   DEBUGP("Display alarm menu");
+  glcdBeginFrame();
   glcdSetAddress(1, 0);
   glcdColorSetFg();
   glcdPutStr("Alarm Setup Menu");
@@ -253,6 +254,7 @@ static void cfgMenuAlarmShow(void)
   glcdSetAddress(CFG_MENU_INDENT, 5);
   glcdPutStr("Select Alarm:     ");
   glcdPrintNumber(almAlarmSelect + 1);
+  glcdEndFrame();
 }
 
 //
@@ -335,6 +337,8 @@ static void cfgMenuMainShow(char *line1, char *line2)
 {
   DEBUGP("Display menu");
 
+  // Repaint the menu off-screen so only the changed bytes end up on the lcd
+  glcdBeginFrame();
   glcdColorSetFg();
   glcdFillRectangle2(0, 0, 1, 64, ALIGN_AUTO, FILL_BLANK);
   glcdFillRectangle2(127, 0, 1, 64, ALIGN_AUTO, FILL_BLANK);
@@ -354,6 +358,7 @@ static void cfgMenuMainShow(char *line1, char *line2)
   glcdPrintNumber(OCR2B >> OCR2B_BITSHIFT);
 #endif
   cfgPrintInstruct1(line1, line2);
+  glcdEndFrame();
 }
 
 //
@@ -12,6 +12,8 @@
 #include "../ks0108.h"
 #include "../ks0108conf.h"
 #include "mchronutil.h"
+#include "export.h"
+#include "profile.h"
 #include "controller.h"
 
 //
@@ -176,32 +178,6 @@
 // Definition of a structure holding the lcd image data for a controller
 typedef u08 ctrlImage_t[GLCD_CONTROLLER_XPIXELS][GLCD_CONTROLLER_YPAGES];
 
-// Definition of a structure holding the glcd interface statistics counters
-typedef struct _ctrlGlcdStats_t
-{
-  long long dataRead;			// Bytes read from lcd
-  long long dataWrite;			// Bytes written to lcd
-  long long addressSet;			// Cursor address set in lcd
-  long long ctrlSet;			// Set lcd controller
-} ctrlGlcdStats_t;
-
-// Definition of a structure holding the controller statistics counters
-typedef struct _ctrlStats_t
-{
-  long long displayReq;			// Display commands received
-  long long displayCnf;			// Display cmds leading to lcd update
-  long long startLineReq;		// Startline commands received
-  long long startLineCnf;		// Startline cmds leading to lcd update
-  long long xReq;			// Cursor x commands received
-  long long xCnf;			// Cursor x cmds leading to x update
-  long long yReq;			// Cursor y commands received
-  long long yCnf;			// Cursor y cmds leading to y update
-  long long readReq;			// Lcd read requests received
-  long long readCnf;			// Lcd read reqs leading to actual read
-  long long writeReq;			// Lcd write requests received
-  long long writeCnf;			// Lcd write reqs leading to lcd update
-} ctrlStats_t;
-
 // Definition of a structure holding the stubbed controller hardware registers
 typedef struct _ctrlRegister_t
 {
@@ -408,6 +384,9 @@ void ctrlExecute(u08 method)
   ctrlController_t *ctrlController = &ctrlControllers[controller];
   u08 state = ctrlController->state;
 
+  // Keep the controller emulation out of the profiled clock logic time
+  profEmuBegin();
+
   // Create a controller finite state machine event using the action data
   if (method == CTRL_METHOD_READ)
   {
@@ -483,6 +462,8 @@ void ctrlExecute(u08 method)
     GLCD_DATAL_PIN &= 0xf0;
     GLCD_DATAL_PIN |= (ctrlController->ctrlRegister.dataRead & 0x0f);
   }
+
+  profEmuEnd();
 }
 
 //
@@ -674,6 +655,22 @@ static u08 ctrlEventGet(u08 data, u08 *command, u08 *payload)
   }
 }
 
+//
+// Function: ctrlFrameAccess
+//
+// Register a glcd byte read or write or a cursor address set in the off-screen
+// frame buffer
+//
+void ctrlFrameAccess(u08 method)
+{
+  if (method == CTRL_METHOD_READ)
+    ctrlGlcdStats.frameRead++;
+  else if (method == CTRL_METHOD_WRITE)
+    ctrlGlcdStats.frameWrite++;
+  else
+    ctrlGlcdStats.frameAddress++;
+}
+
 //
 // Function: ctrlGlcdPixConfirm
 //
@@ -782,10 +779,11 @@ u08 ctrlInit(ctrlDeviceArgs_t *ctrlDeviceArgs)
 //
 // Function: ctrlCleanup
 //
-// Shut down the lcd display in stub device(s)
+// Shut down an active lcd frame export and the lcd display in stub device(s)
 //
 void ctrlCleanup(void)
 {
+  exportStop();
   if (useNcurses == MC_TRUE)
     lcdNcurCleanup();
   if (useGlut == MC_TRUE)
@@ -825,7 +823,8 @@ void ctrlLcdBacklightSet(u08 brightness)
 //
 // Function: ctrlLcdFlush
 //
-// Flush the lcd display in stub device
+// Flush the lcd display in stub device and hand the lcd frame over to an
+// active lcd frame export
 //
 void ctrlLcdFlush(void)
 {
@@ -833,6 +832,7 @@ void ctrlLcdFlush(void)
     lcdGlutFlush();
   if (useNcurses == MC_TRUE)
     lcdNcurFlush();
+  exportFrameAdd();
 }
 
 //
@@ -869,6 +869,54 @@ void ctrlLcdGlutSizeSet(char axis, u16 size)
     lcdGlutSizeSet((unsigned char)axis, (unsigned int)size);
 }
 
+//
+// Function: ctrlLcdImageGet
+//
+// Get the lcd image of the controllers as displayed. This applies the display
+// start line of each controller, and a controller with its display switched
+// off shows a blank image.
+//
+void ctrlLcdImageGet(ctrlLcdImage_t lcdImage)
+{
+  u08 i, x, y;
+  u08 line;
+  ctrlController_t *ctrlController;
+  ctrlRegister_t *ctrlRegister;
+  u08 (*image)[GLCD_CONTROLLER_YPAGES];
+
+  for (i = 0; i < GLCD_NUM_CONTROLLERS; i++)
+  {
+    ctrlController = &ctrlControllers[i];
+    ctrlRegister = &ctrlController->ctrlRegister;
+    image = &lcdImage[i * GLCD_CONTROLLER_XPIXELS];
+    if (ctrlRegister->display == 0)
+    {
+      // Display is switched off
+      memset(image, 0, sizeof(ctrlImage_t));
+    }
+    else if (ctrlRegister->startLine == 0)
+    {
+      // The lcd image is displayed as-is
+      memcpy(image, ctrlController->ctrlImage, sizeof(ctrlImage_t));
+    }
+    else
+    {
+      // Shift the lcd image lines using the display start line
+      memset(image, 0, sizeof(ctrlImage_t));
+      for (x = 0; x < GLCD_CONTROLLER_XPIXELS; x++)
+      {
+        for (y = 0; y < GLCD_CONTROLLER_YPIXELS; y++)
+        {
+          line = (y + ctrlRegister->startLine) & GLCD_CONTROLLER_YPIXMASK;
+          if ((ctrlController->ctrlImage[x][line >> 3] &
+              (0x1 << (line & 0x7))) != 0)
+            image[x][y >> 3] |= (0x1 << (y & 0x7));
+        }
+      }
+    }
+  }
+}
+
 //
 // Function: ctrlLcdNcurGrSet
 //
@@ -934,6 +982,42 @@ void ctrlRegPrint(void)
   }
 }
 
+//
+// Function: ctrlStatsGet
+//
+// Get the aggregated statistics of the high level glcd interface and the
+// aggregated statistics of all lcd controllers combined
+//
+void ctrlStatsGet(ctrlGlcdStats_t *glcdStats, ctrlStats_t *ctrlStats)
+{
+  u08 i;
+  ctrlStats_t *ctrlStatsCtrl;
+
+  // Get the glcd interface statistics
+  *glcdStats = ctrlGlcdStats;
+
+  // Add up the statistics of the controllers
+  memset(ctrlStats, 0, sizeof(ctrlStats_t));
+  for (i = 0; i < GLCD_NUM_CONTROLLERS; i++)
+  {
+    ctrlStatsCtrl = &ctrlControllers[i].ctrlStats;
+    ctrlStats->displayReq = ctrlStats->displayReq + ctrlStatsCtrl->displayReq;
+    ctrlStats->displayCnf = ctrlStats->displayCnf + ctrlStatsCtrl->displayCnf;
+    ctrlStats->startLineReq = ctrlStats->startLineReq +
+      ctrlStatsCtrl->startLineReq;
+    ctrlStats->startLineCnf = ctrlStats->startLineCnf +
+      ctrlStatsCtrl->startLineCnf;
+    ctrlStats->xReq = ctrlStats->xReq + ctrlStatsCtrl->xReq;
+    ctrlStats->xCnf = ctrlStats->xCnf + ctrlStatsCtrl->xCnf;
+    ctrlStats->yReq = ctrlStats->yReq + ctrlStatsCtrl->yReq;
+    ctrlStats->yCnf = ctrlStats->yCnf + ctrlStatsCtrl->yCnf;
+    ctrlStats->readReq = ctrlStats->readReq + ctrlStatsCtrl->readReq;
+    ctrlStats->readCnf = ctrlStats->readCnf + ctrlStatsCtrl->readCnf;
+    ctrlStats->writeReq = ctrlStats->writeReq + ctrlStatsCtrl->writeReq;
+    ctrlStats->writeCnf = ctrlStats->writeCnf + ctrlStatsCtrl->writeCnf;
+  }
+}
+
 //
 // Function: ctrlStatsPrint
 //
@@ -953,8 +1037,9 @@ void ctrlStatsPrint(u08 type)
     printf("glcd   : dataWrite=%llu, dataRead=%llu, addressSet=%llu\n",
       ctrlGlcdStats.dataWrite, ctrlGlcdStats.dataRead,
       ctrlGlcdStats.addressSet);
-    printf("       : ctrlSet=%llu\n",
-      ctrlGlcdStats.ctrlSet);
+    printf("       : ctrlSet=%llu, frameWrite=%llu, frameRead=%llu, "
+      "frameAddress=%llu\n", ctrlGlcdStats.ctrlSet, ctrlGlcdStats.frameWrite,
+      ctrlGlcdStats.frameRead, ctrlGlcdStats.frameAddress);
   }
   if ((type & CTRL_STATS_GLCD_CYCLE) != CTRL_STATS_NULL)
   {
@@ -963,8 +1048,12 @@ void ctrlStatsPrint(u08 type)
       ctrlGlcdStats.dataWrite - ctrlGlcdStatsCopy.dataWrite,
       ctrlGlcdStats.dataRead - ctrlGlcdStatsCopy.dataRead,
       ctrlGlcdStats.addressSet - ctrlGlcdStatsCopy.addressSet);
-    printf("       : ctrlSet=%llu\n",
-      ctrlGlcdStats.ctrlSet - ctrlGlcdStatsCopy.ctrlSet);
+    printf("       : ctrlSet=%llu, frameWrite=%llu, frameRead=%llu, "
+      "frameAddress=%llu\n",
+      ctrlGlcdStats.ctrlSet - ctrlGlcdStatsCopy.ctrlSet,
+      ctrlGlcdStats.frameWrite - ctrlGlcdStatsCopy.frameWrite,
+      ctrlGlcdStats.frameRead - ctrlGlcdStatsCopy.frameRead,
+      ctrlGlcdStats.frameAddress - ctrlGlcdStatsCopy.frameAddress);
   }
 
   // Report controller statistics
@@ -7,6 +7,7 @@
 #define CONTROLLER_H
 
 #include "../avrlibtypes.h"
+#include "../ks0108conf.h"
 #include "lcdglut.h"
 #include "lcdncurses.h"
 
@@ -50,6 +51,39 @@ typedef struct _ctrlDeviceArgs_t
   lcdGlutInitArgs_t lcdGlutInitArgs;	// Init args for glut lcd device
 } ctrlDeviceArgs_t;
 
+// Definition of a structure holding the lcd image of all controllers as
+// displayed, using the controller lcd byte layout
+typedef u08 ctrlLcdImage_t[GLCD_XPIXELS][GLCD_CONTROLLER_YPAGES];
+
+// Definition of a structure holding the glcd interface statistics counters
+typedef struct _ctrlGlcdStats_t
+{
+  long long dataRead;			// Bytes read from lcd
+  long long dataWrite;			// Bytes written to lcd
+  long long addressSet;			// Cursor address set in lcd
+  long long ctrlSet;			// Set lcd controller
+  long long frameRead;			// Bytes read from frame buffer
+  long long frameWrite;			// Bytes written to frame buffer
+  long long frameAddress;		// Cursor address set in frame buffer
+} ctrlGlcdStats_t;
+
+// Definition of a structure holding the controller statistics counters
+typedef struct _ctrlStats_t
+{
+  long long displayReq;			// Display commands received
+  long long displayCnf;			// Display cmds leading to lcd update
+  long long startLineReq;		// Startline commands received
+  long long startLineCnf;		// Startline cmds leading to lcd update
+  long long xReq;			// Cursor x commands received
+  long long xCnf;			// Cursor x cmds leading to x update
+  long long yReq;			// Cursor y commands received
+  long long yCnf;			// Cursor y cmds leading to y update
+  long long readReq;			// Lcd read requests received
+  long long readCnf;			// Lcd read reqs leading to actual read
+  long long writeReq;			// Lcd write requests received
+  long long writeCnf;			// Lcd write reqs leading to lcd update
+} ctrlStats_t;
+
 // Controller device support methods
 void ctrlCleanup(void);
 u08 ctrlInit(ctrlDeviceArgs_t *ctrlDeviceArgs);
@@ -57,12 +91,14 @@ u08 ctrlInit(ctrlDeviceArgs_t *ctrlDeviceArgs);
 // Controller and device status and statistics methods
 u08 ctrlDeviceActive(u08 device);
 void ctrlRegPrint(void);
+void ctrlStatsGet(ctrlGlcdStats_t *glcdStats, ctrlStats_t *ctrlStats);
 void ctrlStatsPrint(u08 type);
 void ctrlStatsReset(u08 type);
 
 // Controller data pin/port utility methods
 void ctrlBusyState(void);
 void ctrlControlSet(void);
+void ctrlFrameAccess(u08 method);
 void ctrlPortDataSet(u08 data);
 
 // Controller device emulator methods
@@ -81,5 +117,6 @@ void ctrlLcdFlush(void);
 void ctrlLcdGlutGrSet(u08 bezel, u08 grid);
 void ctrlLcdGlutHlSet(u08 highlight, u08 x, u08 y);
 void ctrlLcdGlutSizeSet(char axis, u16 size);
+void ctrlLcdImageGet(ctrlLcdImage_t lcdImage);
 void ctrlLcdNcurGrSet(u08 backlight);
 #endif
@@ -0,0 +1,463 @@
+//*****************************************************************************
+// Filename : 'export.c'
+// Title    : Lcd frame export to image files for emuchron emulator
+//*****************************************************************************
+
+// Everything we need for running this thing in Linux
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+// Monochron and emuchron defines
+#include "../global.h"
+#include "controller.h"
+#include "mchronutil.h"
+#include "render.h"
+#include "stub.h"
+#include "export.h"
+
+//
+// The lcd frame export writes each lcd frame flushed to the lcd devices to
+// disk, either as a sequence of pbm image files or as a single animated gif
+// image file.
+// A flushed lcd frame that is identical to the previous one is not exported.
+// In an animated gif the time between two exported frames, as obtained from
+// the emulator (virtual) monotonic clock, is used as frame delay. This makes
+// the frame delays follow the clock cycle timing, also when time warp is
+// active. As a gif frame delay is in 1/100 sec, a frame that is superseded
+// within the same 1/100 sec is not written to the animated gif.
+//
+// The lcd frames are handed over to a writer thread using a bounded frame
+// queue. When time warp is active there is no real-time deadline to meet, so
+// the emulator waits for the writer thread when the queue is full, and every
+// lcd frame is exported. In real-time mode the emulator never blocks on disk
+// i/o, and when the queue is full the lcd frame is dropped. For an animated
+// gif a dropped frame results in a longer frame delay of the frame that
+// precedes it.
+//
+
+// The max number of lcd frames in the frame queue
+#define EXPORT_QUEUE_LEN	64
+
+// The gif lzw minimum code size and max number of codes
+#define GIF_CODE_MIN		2
+#define GIF_CODES		4096
+
+// Definition of a structure holding an exported lcd frame
+typedef struct _exportFrame_t
+{
+  ctrlLcdImage_t image;			// Lcd frame image
+  struct timespec ts;			// Emulator time of lcd frame flush
+} exportFrame_t;
+
+// Definition of a structure holding the gif lzw code output data
+typedef struct _exportGifOut_t
+{
+  FILE *fp;				// Gif output file
+  u32 bits;				// Pending output code bits
+  u08 bitCount;				// Number of pending output code bits
+  u08 block[255];			// Gif data sub-block
+  u08 blockLen;				// Gif data sub-block length
+} exportGifOut_t;
+
+// The active export format, output file (gif) or file name prefix (pbm) and
+// the writer thread
+static u08 exportFormat = EXPORT_NONE;
+static char *exportName = NULL;
+static FILE *exportFp = NULL;
+static pthread_t threadExport;
+
+// The bounded lcd frame queue, its mutex and condition variables for a frame
+// being added or taken, and the writer thread stop request
+static exportFrame_t exportQueue[EXPORT_QUEUE_LEN];
+static int queueStart = 0;
+static int queueLen = 0;
+static u08 exportStopReq = MC_FALSE;
+static pthread_mutex_t mutexQueue = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condQueue = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t condQueueSpace = PTHREAD_COND_INITIALIZER;
+
+// Emulator side frame data and statistics
+static ctrlLcdImage_t exportLast;
+static u08 exportLastValid = MC_FALSE;
+static long exportFrames = 0;
+static long exportDropped = 0;
+
+// Writer thread side frame data and statistics
+static exportFrame_t exportPending;
+static u08 exportPendingValid = MC_FALSE;
+static struct timespec exportTsStart;
+static struct timespec exportTsEnd;
+static long exportWritten = 0;
+static long exportFailed = 0;
+
+// Local function prototypes
+static void exportFrameWrite(exportFrame_t *exportFrame);
+static u16 exportGifCsGet(struct timespec *ts);
+static void exportGifCodePut(exportGifOut_t *out, u16 code, u08 size);
+static void exportGifFrameWrite(exportFrame_t *exportFrame, u16 delay);
+static void exportGifLzw(exportGifOut_t *out, u08 *pixels, u16 count);
+static void *exportWriter(void *arg);
+
+//
+// Function: exportFrameAdd
+//
+// Add the lcd frame to the frame queue of the active export. An lcd frame
+// that is identical to the previous frame is ignored. When the frame queue is
+// full, wait for the writer thread when time warp is active or else drop the
+// lcd frame.
+//
+void exportFrameAdd(void)
+{
+  ctrlLcdImage_t image;
+  struct timespec ts;
+  exportFrame_t *exportFrame;
+
+  if (exportFormat == EXPORT_NONE)
+    return;
+
+  // Skip a frame that has not changed
+  ctrlLcdImageGet(image);
+  if (exportLastValid == MC_TRUE &&
+      memcmp(image, exportLast, sizeof(ctrlLcdImage_t)) == 0)
+    return;
+  stubClockGet(&ts);
+
+  // Add the frame to the frame queue. When the queue is full wait for room
+  // when time warp is active or else drop the frame. For a dropped frame, make
+  // sure the next flushed frame is exported.
+  pthread_mutex_lock(&mutexQueue);
+  if (stubTimeWarpGet() != TIME_WARP_REAL)
+  {
+    while (queueLen == EXPORT_QUEUE_LEN)
+      pthread_cond_wait(&condQueueSpace, &mutexQueue);
+  }
+  if (queueLen == EXPORT_QUEUE_LEN)
+  {
+    exportDropped++;
+    exportLastValid = MC_FALSE;
+  }
+  else
+  {
+    exportFrame = &exportQueue[(queueStart + queueLen) % EXPORT_QUEUE_LEN];
+    memcpy(exportFrame->image, image, sizeof(ctrlLcdImage_t));
+    exportFrame->ts = ts;
+    queueLen++;
+    exportFrames++;
+    memcpy(exportLast, image, sizeof(ctrlLcdImage_t));
+    exportLastValid = MC_TRUE;
+    pthread_cond_signal(&condQueue);
+  }
+  pthread_mutex_unlock(&mutexQueue);
+}
+
+//
+// Function: exportFrameWrite
+//
+// Write an lcd frame taken from the frame queue. For an animated gif the
+// frame delay is only known when the next frame arrives, so the frame is kept
+// pending and the previous pending frame is written instead.
+//
+static void exportFrameWrite(exportFrame_t *exportFrame)
+{
+  char *fileName;
+
+  if (exportFormat == EXPORT_PBM)
+  {
+    fileName = malloc(strlen(exportName) + 12);
+    sprintf(fileName, "%s-%06ld.pbm", exportName,
+      exportWritten + exportFailed);
+    if (renderFramePbmWrite(fileName, exportFrame->image) == MC_FALSE)
+      exportFailed++;
+    else
+      exportWritten++;
+    free(fileName);
+    return;
+  }
+
+  // A pending frame that is superseded within the same 1/100 sec would get a
+  // zero frame delay, so it is skipped
+  if (exportPendingValid == MC_FALSE)
+    exportTsStart = exportFrame->ts;
+  else if (exportGifCsGet(&exportFrame->ts) !=
+      exportGifCsGet(&exportPending.ts))
+    exportGifFrameWrite(&exportPending, exportGifCsGet(&exportFrame->ts) -
+      exportGifCsGet(&exportPending.ts));
+  exportPending = *exportFrame;
+  exportPendingValid = MC_TRUE;
+}
+
+//
+// Function: exportGifCodePut
+//
+// Add an lzw code to the gif data sub-blocks, lsb first
+//
+static void exportGifCodePut(exportGifOut_t *out, u16 code, u08 size)
+{
+  out->bits = out->bits | ((u32)code << out->bitCount);
+  out->bitCount = out->bitCount + size;
+  while (out->bitCount >= 8)
+  {
+    out->block[out->blockLen] = (u08)(out->bits & 0xff);
+    out->blockLen++;
+    out->bits = out->bits >> 8;
+    out->bitCount = out->bitCount - 8;
+    if (out->blockLen == sizeof(out->block))
+    {
+      fputc(out->blockLen, out->fp);
+      fwrite(out->block, 1, out->blockLen, out->fp);
+      out->blockLen = 0;
+    }
+  }
+}
+
+//
+// Function: exportGifCsGet
+//
+// Get the time in 1/100 sec since the first exported frame
+//
+static u16 exportGifCsGet(struct timespec *ts)
+{
+  long cs = (long)((TIMESPECDIFF_USEC(*ts, exportTsStart) + 5000) / 10000);
+
+  // A frame delay is 16-bit so wrap around like the delay itself
+  return (u16)(cs & 0xffff);
+}
+
+//
+// Function: exportGifFrameWrite
+//
+// Write an lcd frame with its delay (in 1/100 sec) as a gif image
+//
+static void exportGifFrameWrite(exportFrame_t *exportFrame, u16 delay)
+{
+  u08 pixels[GLCD_XPIXELS * GLCD_YPIXELS];
+  u08 x, y;
+  exportGifOut_t out;
+  const u08 gifControl[] = { 0x21, 0xf9, 0x04, 0x00,
+    (u08)(delay & 0xff), (u08)(delay >> 8), 0x00, 0x00 };
+  const u08 gifImage[] = { 0x2c, 0x00, 0x00, 0x00, 0x00,
+    GLCD_XPIXELS & 0xff, GLCD_XPIXELS >> 8,
+    GLCD_YPIXELS & 0xff, GLCD_YPIXELS >> 8, 0x00 };
+
+  // Map the lcd bytes onto gif pixels in row order
+  for (y = 0; y < GLCD_YPIXELS; y++)
+    for (x = 0; x < GLCD_XPIXELS; x++)
+      pixels[y * GLCD_XPIXELS + x] =
+        (exportFrame->image[x][y >> 3] >> (y & 0x7)) & 0x1;
+
+  // Write the graphic control extension with the frame delay, the image
+  // descriptor and the lzw encoded image data
+  fwrite(gifControl, 1, sizeof(gifControl), exportFp);
+  fwrite(gifImage, 1, sizeof(gifImage), exportFp);
+  fputc(GIF_CODE_MIN, exportFp);
+  out.fp = exportFp;
+  out.bits = 0;
+  out.bitCount = 0;
+  out.blockLen = 0;
+  exportGifLzw(&out, pixels, sizeof(pixels));
+  fputc(0x00, exportFp);
+  exportWritten++;
+}
+
+//
+// Function: exportGifLzw
+//
+// Lzw encode the gif image pixels. As an lcd pixel is either off or on, each
+// dictionary code can be followed by only two pixel values.
+//
+static void exportGifLzw(exportGifOut_t *out, u08 *pixels, u16 count)
+{
+  static u16 dict[GIF_CODES][2];
+  u16 codeClear = 1 << GIF_CODE_MIN;
+  u16 codeNext = codeClear + 2;
+  u16 code;
+  u16 i;
+  u08 size = GIF_CODE_MIN + 1;
+
+  memset(dict, 0, sizeof(dict));
+  exportGifCodePut(out, codeClear, size);
+  code = pixels[0];
+  for (i = 1; i < count; i++)
+  {
+    // Extend the current pixel string when it is in the dictionary
+    if (dict[code][pixels[i]] != 0)
+    {
+      code = dict[code][pixels[i]];
+      continue;
+    }
+
+    // Output the code of the pixel string and add the extended pixel string
+    // to the dictionary. When the dictionary is full start a new one.
+    exportGifCodePut(out, code, size);
+    if (codeNext < GIF_CODES)
+    {
+      if (codeNext == (1 << size))
+        size++;
+      dict[code][pixels[i]] = codeNext;
+      codeNext++;
+    }
+    else
+    {
+      exportGifCodePut(out, codeClear, size);
+      memset(dict, 0, sizeof(dict));
+      codeNext = codeClear + 2;
+      size = GIF_CODE_MIN + 1;
+    }
+    code = pixels[i];
+  }
+
+  // Output the last pixel string and the end of information code, and flush
+  // the remaining bits and data sub-block
+  exportGifCodePut(out, code, size);
+  exportGifCodePut(out, codeClear + 1, size);
+  if (out->bitCount > 0)
+    exportGifCodePut(out, 0, 8 - out->bitCount);
+  if (out->blockLen > 0)
+  {
+    fputc(out->blockLen, out->fp);
+    fwrite(out->block, 1, out->blockLen, out->fp);
+  }
+}
+
+//
+// Function: exportStart
+//
+// Start an lcd frame export. An active export is stopped first. The current
+// lcd frame is the first exported frame. On failure an error is reported and
+// no export is active.
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 exportStart(u08 format, char *fileName)
+{
+  // Gif header with a two color (white/black) global color table and a
+  // netscape application extension to loop the animation forever
+  const u08 gifHeader[] = { 'G', 'I', 'F', '8', '9', 'a',
+    GLCD_XPIXELS & 0xff, GLCD_XPIXELS >> 8,
+    GLCD_YPIXELS & 0xff, GLCD_YPIXELS >> 8, 0x80, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0x00, 0x00, 0x00,
+    0x21, 0xff, 0x0b, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+    0x03, 0x01, 0x00, 0x00, 0x00 };
+
+  exportStop();
+
+  // Open the animated gif file
+  if (format == EXPORT_GIF)
+  {
+    exportFp = fopen(fileName, "w");
+    if (exportFp == NULL)
+    {
+      printf("export : cannot create file \"%s\"\n", fileName);
+      return MC_FALSE;
+    }
+    fwrite(gifHeader, 1, sizeof(gifHeader), exportFp);
+  }
+  exportName = malloc(strlen(fileName) + 1);
+  strcpy(exportName, fileName);
+
+  // Init the frame queue and statistics, and start the writer thread
+  queueStart = 0;
+  queueLen = 0;
+  exportStopReq = MC_FALSE;
+  exportLastValid = MC_FALSE;
+  exportPendingValid = MC_FALSE;
+  exportFrames = 0;
+  exportDropped = 0;
+  exportWritten = 0;
+  exportFailed = 0;
+  exportFormat = format;
+  if (pthread_create(&threadExport, NULL, exportWriter, NULL) != 0)
+  {
+    printf("export : cannot start writer thread\n");
+    exportFormat = EXPORT_NONE;
+    if (format == EXPORT_GIF)
+    {
+      fclose(exportFp);
+      exportFp = NULL;
+    }
+    free(exportName);
+    exportName = NULL;
+    return MC_FALSE;
+  }
+
+  // Export the current lcd frame
+  exportFrameAdd();
+
+  return MC_TRUE;
+}
+
+//
+// Function: exportStop
+//
+// Stop the active lcd frame export after the writer thread has written all
+// frames in the frame queue
+//
+void exportStop(void)
+{
+  if (exportFormat == EXPORT_NONE)
+    return;
+
+  // Signal the writer thread to stop and wait for it to end
+  pthread_mutex_lock(&mutexQueue);
+  stubClockGet(&exportTsEnd);
+  exportStopReq = MC_TRUE;
+  pthread_cond_signal(&condQueue);
+  pthread_mutex_unlock(&mutexQueue);
+  pthread_join(threadExport, NULL);
+
+  // Complete the animated gif file
+  if (exportFormat == EXPORT_GIF)
+  {
+    fputc(0x3b, exportFp);
+    if (fclose(exportFp) != 0)
+      exportFailed++;
+    exportFp = NULL;
+  }
+
+  printf("export : frames=%ld, written=%ld, dropped=%ld, failed=%ld\n",
+    exportFrames, exportWritten, exportDropped, exportFailed);
+  free(exportName);
+  exportName = NULL;
+  exportFormat = EXPORT_NONE;
+}
+
+//
+// Function: exportWriter
+//
+// The writer thread that writes the lcd frames from the frame queue until
+// the export is stopped
+//
+static void *exportWriter(void *arg)
+{
+  exportFrame_t exportFrame;
+
+  while (MC_TRUE)
+  {
+    // Wait for a frame in the queue or a stop request
+    pthread_mutex_lock(&mutexQueue);
+    while (queueLen == 0 && exportStopReq == MC_FALSE)
+      pthread_cond_wait(&condQueue, &mutexQueue);
+    if (queueLen == 0)
+    {
+      pthread_mutex_unlock(&mutexQueue);
+      break;
+    }
+    exportFrame = exportQueue[queueStart];
+    queueStart = (queueStart + 1) % EXPORT_QUEUE_LEN;
+    queueLen--;
+    pthread_cond_signal(&condQueueSpace);
+    pthread_mutex_unlock(&mutexQueue);
+
+    // Write the frame outside the queue lock
+    exportFrameWrite(&exportFrame);
+  }
+
+  // Write the last pending gif frame, lasting until the export was stopped
+  if (exportFormat == EXPORT_GIF && exportPendingValid == MC_TRUE)
+    exportGifFrameWrite(&exportPending, exportGifCsGet(&exportTsEnd) -
+      exportGifCsGet(&exportPending.ts));
+
+  return NULL;
+}
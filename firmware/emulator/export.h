@@ -0,0 +1,22 @@
+//*****************************************************************************
+// Filename : 'export.h'
+// Title    : Defines for the emuchron emulator lcd frame export
+//*****************************************************************************
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "../avrlibtypes.h"
+
+// The lcd frame export formats
+#define EXPORT_NONE		0	// No active export
+#define EXPORT_PBM		1	// Sequence of pbm image files
+#define EXPORT_GIF		2	// Animated gif image file
+
+// Start and stop lcd frame export
+u08 exportStart(u08 format, char *fileName);
+void exportStop(void);
+
+// Add the lcd frame to the active lcd frame export
+void exportFrameAdd(void);
+#endif
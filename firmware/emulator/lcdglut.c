@@ -366,9 +366,10 @@ unsigned char lcdGlutInit(lcdGlutInitArgs_t *lcdGlutInitArgsSet)
 // Function: lcdGlutKeyboard
 //
 // Event handler for glut keyboard event.
-// Since a keyboard stroke has no function in our glut window briefly 'blink'
-// the screen to gently indicate that focus should be put on the mchron command
-// line terminal window.
+// While running a clock or Monochron emulator a keypress is forwarded to the
+// emulator as input. Otherwise, since a keyboard stroke has no function in our
+// glut window, briefly 'blink' the screen to gently indicate that focus should
+// be put on the mchron command line terminal window.
 //
 static void lcdGlutKeyboard(unsigned char key, int x, int y)
 {
@@ -378,6 +379,10 @@ static void lcdGlutKeyboard(unsigned char key, int x, int y)
   struct timeval tvNow;
   suseconds_t timeDiff;
 
+  // Forward the keypress to the emulator when it accepts glut window input
+  if (lcdGlutInitArgs.winKey(key) == MC_TRUE)
+    return;
+
   // Do not blink at every keyboard hit. When someone press-holds a key the
   // blinking will prevent regular updates from being drawn. Not good.
   // Only blink when a certain time has elapsed since the last blink or when a
@@ -14,6 +14,7 @@ typedef struct _lcdGlutInitArgs_t
   int sizeX;			// Glut window x size in px
   int sizeY;			// Glut window y size in px
   void (*winClose)(void);	// mchron callback upon glut window close
+  unsigned char (*winKey)(unsigned char); // mchron glut keypress callback
 } lcdGlutInitArgs_t;
 
 // Definition of a structure to communicate about a double-clicked pixel
@@ -9,7 +9,7 @@
 #include <string.h>
 #include <libgen.h>
 #include <math.h>
-#include <signal.h>
+#include <time.h>
 #include <sys/time.h>
 
 // Monochron and emuchron defines
@@ -23,8 +23,10 @@
 // mchrondict.h [firmware/emulator].
 #define CMD_STACK_DEPTH_MAX	8
 
-// The command stack keyboard scan interval (msec)
+// The command stack keyboard scan interval (msec) and the number of executed
+// commands between verifying whether the interval has passed
 #define CMD_STACK_SCAN_MSEC	100
+#define CMD_STACK_SCAN_CMDS	16
 
 // The command stack pop scope
 #define CMD_STACK_POP_ALL	0	// Pop all levels (clear stack)
@@ -96,9 +98,10 @@ u08 cmdEcho = CMD_ECHO_YES;
 // This is me
 extern const char *__progname;
 
-// System timer data for command list 100 msec keyboard scan
-static timer_t kbTimer;
-static u08 kbTimerTripped;
+// Monotonic clock deadline data for command list 100 msec keyboard scan
+static struct timespec kbScanNext;
+static u08 kbScanArmed = MC_FALSE;
+static u08 kbScanCmdCount = 0;
 
 // Command list stack and execution statistics
 static cmdStack_t cmdStack;
@@ -121,7 +124,7 @@ static u08 cmdListExecute(cmdLine_t **cmdProgCounter,
   cmdLine_t **cmdProgCtrIntr);
 static u08 cmdListFileLoad(char *argName, char *fileName);
 static u08 cmdListKeyboardLoad(cmdInput_t *cmdInput);
-static void cmdListRaiseScan(void);
+static u08 cmdListScanDue(void);
 // Program counter control block (pcb)
 static int cmdPcbLink(cmdLine_t **cmdPcbTail, cmdLine_t *cmdLine);
 static void cmdPcbOpen(cmdLine_t **cmdPcbTail, cmdLine_t *cmdLine);
@@ -835,9 +838,8 @@ static u08 cmdListExecute(cmdLine_t **cmdProgCounter,
     }
 
     // Verify if a command interrupt was requested
-    if (retVal == CMD_RET_OK && kbTimerTripped == MC_TRUE)
+    if (retVal == CMD_RET_OK && cmdListScanDue() == MC_TRUE)
     {
-      kbTimerTripped = MC_FALSE;
       ch = kbKeypressScan(MC_TRUE);
       if (ch == 'q')
       {
@@ -1100,14 +1102,30 @@ static u08 cmdListKeyboardLoad(cmdInput_t *cmdInput)
 }
 
 //
-// Function: cmdListRaiseScan
+// Function: cmdListScanDue
 //
-// Handler for the repeating 100 msec cmdlist execution keyboard scan timer
+// Verify if the 100 msec cmdlist execution keyboard scan interval has passed,
+// and if so set the deadline for the next keyboard scan. To keep its overhead
+// low the clock is only read once per a small number of executed commands.
 //
-static void cmdListRaiseScan(void)
+static u08 cmdListScanDue(void)
 {
-  if (kbTimerTripped == MC_FALSE)
-    kbTimerTripped = MC_TRUE;
+  struct timespec tsNow;
+
+  if (kbScanArmed == MC_FALSE)
+    return MC_FALSE;
+  kbScanCmdCount++;
+  if (kbScanCmdCount < CMD_STACK_SCAN_CMDS)
+    return MC_FALSE;
+  kbScanCmdCount = 0;
+
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &tsNow);
+  if (tsNow.tv_sec < kbScanNext.tv_sec || (tsNow.tv_sec == kbScanNext.tv_sec &&
+      tsNow.tv_nsec < kbScanNext.tv_nsec))
+    return MC_FALSE;
+  cmdStackTimerSet(LIST_TIMER_ARM);
+
+  return MC_TRUE;
 }
 
 //
@@ -1261,7 +1279,7 @@ u08 cmdStackActiveGet(void)
 void cmdStackCleanup(void)
 {
   cmdStackPop(CMD_STACK_POP_ALL);
-  timer_delete(kbTimer);
+  cmdStackTimerSet(LIST_TIMER_DISARM);
 }
 
 //
@@ -1271,7 +1289,6 @@ void cmdStackCleanup(void)
 //
 void cmdStackInit(void)
 {
-  struct sigevent sEvent;
   u08 i;
 
   // Init the command stack
@@ -1291,12 +1308,8 @@ void cmdStackInit(void)
   // Init stack statistics
   cmdStackStatsInit();
 
-  // Prepare a realtime timer generating signal SIGVTALRM with a handler (but
-  // only arm/disarm during stack activity)
-  sEvent.sigev_notify = SIGEV_SIGNAL;
-  sEvent.sigev_signo = SIGVTALRM;
-  sEvent.sigev_value.sival_ptr = cmdListRaiseScan;
-  timer_create(CLOCK_REALTIME, &sEvent, &kbTimer);
+  // The keyboard scan timer is only armed during stack activity
+  cmdStackTimerSet(LIST_TIMER_DISARM);
 }
 
 //
@@ -1826,29 +1839,29 @@ void cmdStackStatsSet(u08 enable)
 //
 // Function: cmdStackTimerSet
 //
-// Arm/disarm a repeating realtime 100 msec interval timer for scanning the
-// keyboard.
+// Arm/disarm a repeating 100 msec interval deadline on the monotonic clock for
+// scanning the keyboard. Unlike a signal based system timer it does not
+// interrupt system calls.
 //
 void cmdStackTimerSet(u08 action)
 {
-  struct itimerspec iTimer;
-
   if (action == LIST_TIMER_DISARM)
   {
-    // Have the timer disarmed
-    iTimer.it_value.tv_sec = 0;
-    iTimer.it_value.tv_nsec = 0;
+    // Have the deadline disarmed
+    kbScanArmed = MC_FALSE;
   }
   else // LIST_TIMER_ARM
   {
-    // Reset possible pending scan flag and set 100 msec timeout
-    kbTimerTripped = MC_FALSE;
-    iTimer.it_value.tv_sec = CMD_STACK_SCAN_MSEC / 1000;
-    iTimer.it_value.tv_nsec = (CMD_STACK_SCAN_MSEC % 1000) * 1E6;
+    // Set the deadline at 100 msec from now
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &kbScanNext);
+    kbScanNext.tv_sec = kbScanNext.tv_sec + CMD_STACK_SCAN_MSEC / 1000;
+    kbScanNext.tv_nsec = kbScanNext.tv_nsec +
+      (long)(CMD_STACK_SCAN_MSEC % 1000) * 1000000;
+    if (kbScanNext.tv_nsec >= 1000000000)
+    {
+      kbScanNext.tv_sec++;
+      kbScanNext.tv_nsec = kbScanNext.tv_nsec - 1000000000;
+    }
+    kbScanArmed = MC_TRUE;
   }
-
-  // Make it repeating and set timer
-  iTimer.it_interval.tv_sec = iTimer.it_value.tv_sec;
-  iTimer.it_interval.tv_nsec = iTimer.it_value.tv_nsec;
-  timer_settime(kbTimer, 0, &iTimer, NULL);
 }
@@ -5,6 +5,7 @@
 
 // Everything we need for running this thing in Linux
 #define _GNU_SOURCE
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,13 +20,19 @@
 #include "../ks0108conf.h"
 #include "../config.h"
 #include "../buttons.h"
+#include "../trig.h"
+#include "../clock/pong.h"
 
 // Emuchron defines and utilities
 #include "controller.h"
 #include "dictutil.h"
+#include "export.h"
 #include "expr.h"
 #include "listutil.h"
 #include "mchronutil.h"
+#include "profile.h"
+#include "reactor.h"
+#include "render.h"
 #include "scanutil.h"
 #include "varutil.h"
 #include "mchron.h"
@@ -80,7 +87,7 @@ uint8_t emuAlarmH = 22;
 uint8_t emuAlarmM = 9;
 
 // The timer used for the 'wte' and 'wts' commands
-static struct timeval tvTimer;
+static struct timespec tsTimer;
 
 // Graphics data buffers for use with graphics data and paint commands
 emuGrBuf_t emuGrBufs[GRAPHICS_BUFFERS];
@@ -126,6 +133,11 @@ int main(int argc, char *argv[])
   // non-standard exit
   emuSigSetup();
 
+  // Create the reactor for keyboard, glut window and timer events
+  success = reactorInit();
+  if (success == MC_FALSE)
+    return CMD_RET_ERROR;
+
   // Do command line processing
   success = emuArgcArgvGet(argc, argv, &emuArgcArgv);
   if (success == MC_FALSE)
@@ -198,61 +210,78 @@ int main(int argc, char *argv[])
   // Init mchron named variable buckets
   varInit();
 
-  // Init Monochron eeprom
-  stubEepReset();
+  // Init Monochron eeprom. A batch job always starts from a default eeprom
+  // so its results do not depend on the persistent eeprom.
+  if (emuArgcArgv.argBatch != 0)
+    stubEepReset();
+  else
+    stubEepInit();
   eepInit();
 
   // Init mchron wait expiry timer
-  waitTimerStart(&tvTimer);
+  waitTimerStart(&tsTimer);
 
-  // Init the command stack, command line input interface and command prompt
-  cmdStackInit();
-  cmdInputInit(&cmdInput, stdin, CMD_INPUT_READLINELIB);
-  prompt = emuCmdPromptInit();
+  // In batch mode run the batch job instead of the command shell
+  if (emuArgcArgv.argBatch != 0)
+  {
+    success = emuBatchRun(argv, &emuArgcArgv);
+  }
+  else
+  {
+    // Init the command stack, command line input interface and command prompt
+    cmdStackInit();
+    cmdInputInit(&cmdInput, stdin, CMD_INPUT_READLINELIB);
+    prompt = emuCmdPromptInit();
 
-  // All initialization is done!
-  printf("\nenter 'h' for help\n");
+    // All initialization is done!
+    printf("\nenter 'h' for help\n");
 
-  // We're in business: give prompt and process keyboard commands until the
-  // last proton in the universe has desintegrated (or use 'x' or ^D to exit)
+    // We're in business: give prompt and process keyboard commands until the
+    // last proton in the universe has desintegrated (or use 'x' or ^D to exit)
 
-  // Read and process input lines until done
-  emuCmdPromptSet(prompt);
-  cmdInputRead(prompt, &cmdInput);
-  while (cmdInput.input != NULL)
-  {
-    // Execute the command and either exit or read the next command
-    retVal = cmdExecute(&cmdInput);
-    if (retVal == CMD_RET_EXIT)
-      break;
+    // Read and process input lines until done
     emuCmdPromptSet(prompt);
     cmdInputRead(prompt, &cmdInput);
-  }
+    while (cmdInput.input != NULL)
+    {
+      // Execute the command and either exit or read the next command
+      retVal = cmdExecute(&cmdInput);
+      if (retVal == CMD_RET_EXIT)
+        break;
+      emuCmdPromptSet(prompt);
+      cmdInputRead(prompt, &cmdInput);
+    }
 
-  // Done: caused by 'x' or ^D
-  if (retVal != CMD_RET_EXIT)
-    printf("<ctrl>d - exit\n");
+    // Done: caused by 'x' or ^D
+    if (retVal != CMD_RET_EXIT)
+      printf("<ctrl>d - exit\n");
 
-  // Cleanup command prompt, read interface and command stack
-  emuCmdPromptCleanup(prompt);
-  cmdInputCleanup(&cmdInput);
-  cmdStackCleanup();
+    // Cleanup command prompt, read interface and command stack
+    emuCmdPromptCleanup(prompt);
+    cmdInputCleanup(&cmdInput);
+    cmdStackCleanup();
+  }
 
   // Shutdown gracefully by releasing the mchron clock pool, killing audio,
   // stopping the controller and lcd device(s), and cleaning up the named
-  // variables and graphics buffers
+  // variables, graphics buffers, event reactor and persistent eeprom
   emuClockPoolCleanup(emuClockPool);
   alarmSoundReset();
   ctrlCleanup();
   varReset();
   for (i = 0; i < GRAPHICS_BUFFERS; i++)
     grBufReset(&emuGrBufs[i]);
+  grBufCacheReset();
+  reactorCleanup();
+  stubEepCleanup();
 
   // Stop debug output
   DEBUGP("**** logging stopped");
   stubLogfileClose();
 
   // Goodbye
+  if (success == MC_FALSE)
+    return CMD_RET_ERROR;
   return CMD_RET_OK;
 }
 
@@ -312,12 +341,11 @@ u08 doClockFeed(cmdLine_t *cmdLine)
   if (myKbMode == KB_MODE_LINE)
     kbModeSet(KB_MODE_SCAN);
 
-  // Reset alarm and init functional clock time
+  // Init stub event handler used in main loop below, reset alarm and init
+  // functional clock time, and get first event
+  stubEventInit(startMode, MC_TRUE, EMU_CLOCK);
   alarmSoundReset();
   rtcMchronTimeInit();
-
-  // Init stub event handler used in main loop below and get first event
-  stubEventInit(startMode, MC_TRUE, EMU_CLOCK);
   ch = stubEventGet(MC_TRUE);
 
   // Run clock until 'q'
@@ -685,6 +713,32 @@ u08 doEepromWrite(cmdLine_t *cmdLine)
   return CMD_RET_OK;
 }
 
+//
+// Function: doExecEventRecord
+//
+// Record the event log of the next clock or Monochron emulator session
+//
+u08 doExecEventRecord(cmdLine_t *cmdLine)
+{
+  if (stubEventLogSet(EVLOG_RECORD, argString[1]) == MC_FALSE)
+    return CMD_RET_ERROR;
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: doExecEventReplay
+//
+// Replay the event log for the next clock or Monochron emulator session
+//
+u08 doExecEventReplay(cmdLine_t *cmdLine)
+{
+  if (stubEventLogSet(EVLOG_REPLAY, argString[1]) == MC_FALSE)
+    return CMD_RET_ERROR;
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doExecFile
 //
@@ -914,6 +968,69 @@ u08 doGrLoadFile(cmdLine_t *cmdLine)
   return CMD_RET_OK;
 }
 
+//
+// Function: doGrLoadFileAnim
+//
+// Load sprite animation frame graphics data in buffer from file
+//
+u08 doGrLoadFileAnim(cmdLine_t *cmdLine)
+{
+  u08 bufferId = TO_U08(argDouble[0]);
+  emuGrBuf_t *emuGrBuf = &emuGrBufs[bufferId];
+  u08 width = TO_U08(argDouble[1]);
+  u08 height = TO_U08(argDouble[2]);
+  char formatName;
+  u16 frames;
+  u08 retVal;
+
+  // The graphics data format depends on the sprite height
+  if (height <= 8)
+    formatName = 'b';
+  else if (height <= 16)
+    formatName = 'w';
+  else
+    formatName = 'd';
+
+  // Load the sprite data
+  retVal = grBufLoadFileAnim(cmdLine->cmdCommand->cmdArg[4].argName,
+    formatName, argString[1], emuGrBuf);
+  if (retVal != CMD_RET_OK)
+    return retVal;
+
+  // Validate data volume read from file
+  frames = emuGrBuf->bufElmCount / width;
+  if (emuGrBuf->bufElmCount % width != 0)
+  {
+    printf("file data incomplete: elements read = %d, elements expected = %d\n",
+      emuGrBuf->bufElmCount, width * ((int)frames + 1));
+    grBufReset(emuGrBuf);
+    return CMD_RET_ERROR;
+  }
+  if (frames > GRAPH_ANIM_FRAMES)
+  {
+    printf("file data exceeds %d frames: frames read = %d\n",
+      GRAPH_ANIM_FRAMES, (int)frames);
+    grBufReset(emuGrBuf);
+    return CMD_RET_ERROR;
+  }
+
+  // Change buffer type from raw to sprite and compress it into an animation
+  emuGrBuf->bufType = GRAPH_SPRITE;
+  emuGrBuf->bufSprWidth = width;
+  emuGrBuf->bufSprHeight = height;
+  emuGrBuf->bufSprFrames = frames;
+  retVal = grBufAnimCreate(cmdLine->cmdCommand->cmdArg[4].argName,
+    TO_U08(argDouble[3]), emuGrBuf);
+  if (retVal != CMD_RET_OK)
+    return retVal;
+
+  // Show animation buffer info
+  if (cmdEcho == CMD_ECHO_YES)
+    grBufInfoPrint(emuGrBuf);
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doGrLoadFileImg
 //
@@ -1055,6 +1172,12 @@ u08 doGrSaveFile(cmdLine_t *cmdLine)
       (int)bufferId);
     return CMD_RET_ERROR;
   }
+  if (emuGrBuf->bufType == GRAPH_ANIM)
+  {
+    printf("%s? %d: buffer contains animation data\n",
+      cmdLine->cmdCommand->cmdArg[0].argName, (int)bufferId);
+    return CMD_RET_ERROR;
+  }
 
   // Save the buffer data
   retVal = grBufSaveFile(cmdLine->cmdCommand->cmdArg[1].argName,
@@ -1063,6 +1186,34 @@ u08 doGrSaveFile(cmdLine_t *cmdLine)
   return retVal;
 }
 
+//
+// Function: doGrSaveFileBin
+//
+// Save graphics data from buffer in binary file
+//
+u08 doGrSaveFileBin(cmdLine_t *cmdLine)
+{
+  u08 bufferId = TO_U08(argDouble[0]);
+  emuGrBuf_t *emuGrBuf = &emuGrBufs[bufferId];
+
+  if (emuGrBuf->bufType == GRAPH_NULL)
+  {
+    printf("%s? %d: buffer is empty\n", cmdLine->cmdCommand->cmdArg[0].argName,
+      (int)bufferId);
+    return CMD_RET_ERROR;
+  }
+  if (emuGrBuf->bufType == GRAPH_ANIM)
+  {
+    printf("%s? %d: buffer contains animation data\n",
+      cmdLine->cmdCommand->cmdArg[0].argName, (int)bufferId);
+    return CMD_RET_ERROR;
+  }
+
+  // Save the buffer data
+  return grBufSaveFileBin(cmdLine->cmdCommand->cmdArg[1].argName,
+    argString[1], emuGrBuf);
+}
+
 //
 // Function: doHelp
 //
@@ -1332,6 +1483,110 @@ u08 doLcdErase(cmdLine_t *cmdLine)
   return CMD_RET_OK;
 }
 
+//
+// Function: doLcdFrameBufferSet
+//
+// Switch the lcd frame buffer on/off. As firmware has no frame buffer it is
+// off by default.
+//
+u08 doLcdFrameBufferSet(cmdLine_t *cmdLine)
+{
+  glcdFrameEnable(TO_U08(argDouble[0]));
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: doLcdFrameCompare
+//
+// Compare the lcd frame with a golden frame pbm file. When the golden frame
+// file does not exist it is created from the lcd frame. When the frame
+// differs from the golden frame a side-by-side pbm file is written.
+//
+u08 doLcdFrameCompare(cmdLine_t *cmdLine)
+{
+  ctrlLcdImage_t frame;
+  ctrlLcdImage_t golden;
+  renderDiff_t diff;
+  char *fileName = argString[1];
+  char *diffName;
+  u08 success;
+
+  // Create the golden frame when it does not exist yet
+  ctrlLcdImageGet(frame);
+  if (access(fileName, F_OK) != 0)
+  {
+    if (renderFramePbmWrite(fileName, frame) == MC_FALSE)
+    {
+      printf("%s? cannot create file \"%s\"\n",
+        cmdLine->cmdCommand->cmdArg[0].argName, fileName);
+      return CMD_RET_ERROR;
+    }
+    if (cmdEcho == CMD_ECHO_YES)
+      printf("golden frame created\n");
+    return CMD_RET_OK;
+  }
+
+  // Compare the frame with the golden frame
+  if (renderFramePbmRead(fileName, golden) == MC_FALSE)
+  {
+    printf("%s? invalid golden frame file \"%s\"\n",
+      cmdLine->cmdCommand->cmdArg[0].argName, fileName);
+    return CMD_RET_ERROR;
+  }
+  if (renderFrameDiff(golden, frame, &diff) == 0)
+  {
+    if (cmdEcho == CMD_ECHO_YES)
+      printf("frame ok\n");
+    return CMD_RET_OK;
+  }
+
+  // The frame differs: report and write the side-by-side frame difference
+  diffName = malloc(strlen(fileName) + 10);
+  sprintf(diffName, "%s.diff.pbm", fileName);
+  success = renderFrameDiffWrite(diffName, golden, frame);
+  printf("%s: frame diff: %d pixels, box (%d,%d)-(%d,%d)\n",
+    cmdLine->cmdCommand->cmdName, diff.pixels, diff.xMin, diff.yMin,
+    diff.xMax, diff.yMax);
+  if (success == MC_TRUE)
+    printf("%s: diff file: %s\n", cmdLine->cmdCommand->cmdName, diffName);
+  free(diffName);
+
+  return CMD_RET_ERROR;
+}
+
+//
+// Function: doLcdFrameExport
+//
+// Start exporting each flushed lcd frame to an animated gif file or a
+// sequence of pbm files
+//
+u08 doLcdFrameExport(cmdLine_t *cmdLine)
+{
+  u08 format;
+
+  if (argChar[0] == 'g')
+    format = EXPORT_GIF;
+  else
+    format = EXPORT_PBM;
+  if (exportStart(format, argString[1]) == MC_FALSE)
+    return CMD_RET_ERROR;
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: doLcdFrameExportStop
+//
+// Stop the lcd frame export
+//
+u08 doLcdFrameExportStop(cmdLine_t *cmdLine)
+{
+  exportStop();
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doLcdGlutEdit
 //
@@ -1340,7 +1595,7 @@ u08 doLcdErase(cmdLine_t *cmdLine)
 //
 u08 doLcdGlutEdit(cmdLine_t *cmdLine)
 {
-  static struct timeval tvTimer;
+  static struct timespec tsTimer;
   char ch = '\0';
   u08 x;
   u08 y;
@@ -1363,14 +1618,14 @@ u08 doLcdGlutEdit(cmdLine_t *cmdLine)
 
   // Prepare for keyboard scan and timer loop, and enable double-click events
   kbModeSet(KB_MODE_SCAN);
-  waitTimerStart(&tvTimer);
+  waitTimerStart(&tsTimer);
   ctrlGlcdPixEnable();
 
   // Process events in a timer loop until a 'q' has been pressed
   while (ch != 'q')
   {
     // Wait remaining time for cycle while detecting 'q' keypress
-    ch = waitTimerExpiry(&tvTimer, ANIM_TICK_CYCLE_MS, MC_TRUE, NULL);
+    ch = waitTimerExpiry(&tsTimer, ANIM_TICK_CYCLE_MS, MC_TRUE, NULL);
     if (ch == 'q')
       break;
 
@@ -1601,6 +1856,7 @@ u08 doLcdWrite(cmdLine_t *cmdLine)
   // Write data to controller lcd
   ctrlPortDataSet(TO_U08(argDouble[0]));
   ctrlExecute(CTRL_METHOD_WRITE);
+  glcdFrameReset();
   ctrlLcdFlush();
 
   return CMD_RET_OK;
@@ -1853,6 +2109,12 @@ u08 doPaintBuffer(cmdLine_t *cmdLine)
       cmdLine->cmdCommand->cmdArg[1].argName, (int)bufferId);
     return CMD_RET_ERROR;
   }
+  if (emuGrBuf->bufType == GRAPH_ANIM)
+  {
+    printf("%s? %d: buffer contains animation data\n",
+      cmdLine->cmdCommand->cmdArg[1].argName, (int)bufferId);
+    return CMD_RET_ERROR;
+  }
 
   // Draw section from buffer
   glcdBitmap(TO_U08(argDouble[1]), TO_U08(argDouble[2]), TO_U16(argDouble[3]),
@@ -1872,9 +2134,6 @@ u08 doPaintBufferImg(cmdLine_t *cmdLine)
 {
   u08 bufferId = TO_U08(argDouble[0]);
   emuGrBuf_t *emuGrBuf = &emuGrBufs[bufferId];
-  u08 i;
-  u08 height;
-  u08 frame = 0;
 
   // Do we refer to an image buffer
   if (emuGrBuf->bufType != GRAPH_IMAGE)
@@ -1884,20 +2143,8 @@ u08 doPaintBufferImg(cmdLine_t *cmdLine)
     return CMD_RET_ERROR;
   }
 
-  // Draw image frames from buffer
-  for (i = 0; i < emuGrBuf->bufImgHeight; i = i + height)
-  {
-    if (i + emuGrBuf->bufElmBitSize > emuGrBuf->bufImgHeight)
-      height = emuGrBuf->bufImgHeight - i;
-    else
-      height = emuGrBuf->bufElmBitSize;
-
-    // Draw image frame
-    glcdBitmap(TO_U08(argDouble[1]), TO_U08(argDouble[2]) + i,
-      frame * emuGrBuf->bufImgWidth, 0, emuGrBuf->bufImgWidth, height,
-      emuGrBuf->bufElmFormat, DATA_RAM, (void *)(emuGrBuf->bufData));
-    frame++;
-  }
+  // Draw image from buffer
+  grBufPaintLcd(TO_U08(argDouble[1]), TO_U08(argDouble[2]), 0, emuGrBuf);
   ctrlLcdFlush();
 
   return CMD_RET_OK;
@@ -1914,8 +2161,8 @@ u08 doPaintBufferSpr(cmdLine_t *cmdLine)
   emuGrBuf_t *emuGrBuf = &emuGrBufs[bufferId];
   u08 frame = TO_U08(argDouble[3]);
 
-  // Do we refer to a sprite buffer
-  if (emuGrBuf->bufType != GRAPH_SPRITE)
+  // Do we refer to a sprite or sprite animation buffer
+  if (emuGrBuf->bufType != GRAPH_SPRITE && emuGrBuf->bufType != GRAPH_ANIM)
   {
     printf("%s? %d: buffer does not contain sprite data\n",
       cmdLine->cmdCommand->cmdArg[1].argName, (int)bufferId);
@@ -1932,10 +2179,12 @@ u08 doPaintBufferSpr(cmdLine_t *cmdLine)
   }
 
   // Draw sprite
-  glcdBitmap(TO_U08(argDouble[1]), TO_U08(argDouble[2]),
-    frame * emuGrBuf->bufSprWidth, 0, emuGrBuf->bufSprWidth,
-    emuGrBuf->bufSprHeight, emuGrBuf->bufElmFormat, DATA_RAM,
-    (void *)(emuGrBuf->bufData));
+  if (emuGrBuf->bufType == GRAPH_ANIM)
+    grBufPaintAnim(TO_U08(argDouble[1]), TO_U08(argDouble[2]), frame,
+      emuGrBuf);
+  else
+    grBufPaintLcd(TO_U08(argDouble[1]), TO_U08(argDouble[2]), frame,
+      emuGrBuf);
   ctrlLcdFlush();
 
   return CMD_RET_OK;
@@ -2124,6 +2373,22 @@ u08 doPaintSetFg(cmdLine_t *cmdLine)
   return CMD_RET_OK;
 }
 
+//
+// Function: doPaintTriangleFill
+//
+// Paint filled triangle
+//
+u08 doPaintTriangleFill(cmdLine_t *cmdLine)
+{
+  // Draw filled triangle
+  glcdFillTriangle(TO_U08(argDouble[0]), TO_U08(argDouble[1]),
+    TO_U08(argDouble[2]), TO_U08(argDouble[3]), TO_U08(argDouble[4]),
+    TO_U08(argDouble[5]), TO_U08(argDouble[6]));
+  ctrlLcdFlush();
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doRepeatBreak
 //
@@ -2231,6 +2496,26 @@ u08 doRepeatNext(cmdLine_t **cmdProgCounter)
   return CMD_RET_OK;
 }
 
+//
+// Function: doStatsPong
+//
+// Print whether the fixed-point ball model of the pong clock plays the same
+// game as the float ball model it replaced, for a seeded series of ball
+// trajectories
+//
+u08 doStatsPong(cmdLine_t *cmdLine)
+{
+  pongCheck_t check;
+
+  pongModelCheck(TO_U16(argDouble[0]), (u32)argDouble[1], &check);
+
+  printf("pong   : serves=%u, misses=%u\n", check.serves, check.misses);
+  printf("         trajectoryDiff=%u, outcomeDiff=%u\n", check.trajDiff,
+    check.outcomeDiff);
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doStatsPrint
 //
@@ -2246,6 +2531,22 @@ u08 doStatsPrint(cmdLine_t *cmdLine)
   // Print aggregated display related statistics
   ctrlStatsPrint(CTRL_STATS_AGGREGATE);
 
+  // Print the clock cycle profiles
+  profPrint();
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: doStatsProfScale
+//
+// Set the host-to-Monochron cpu speed scale factor of the clock cycle
+// profiler
+//
+u08 doStatsProfScale(cmdLine_t *cmdLine)
+{
+  profScaleSet(TO_U16(argDouble[0]));
+
   return CMD_RET_OK;
 }
 
@@ -2262,6 +2563,9 @@ u08 doStatsReset(cmdLine_t *cmdLine)
   // Reset glcd interface and lcd performance statistics
   ctrlStatsReset(CTRL_STATS_ALL);
 
+  // Reset the clock cycle profiles
+  profReset();
+
   if (cmdEcho == CMD_ECHO_YES)
     printf("statistics reset\n");
 
@@ -2288,6 +2592,63 @@ u08 doStatsStack(cmdLine_t *cmdLine)
   return retVal;
 }
 
+//
+// Function: doStatsTrig
+//
+// Print the accuracy of the fixed-point sine/cosine functions used by the
+// clocks when compared to float sin()/cos(). This is done for their Q1.15
+// values and for the lcd pixel offsets they create for the radii in use by
+// the clocks.
+//
+u08 doStatsTrig(cmdLine_t *cmdLine)
+{
+  u32 angle;
+  u08 radius;
+  double rad;
+  double error;
+  double errorMax = 0;
+  int pxFloat, pxFixed;
+  int delta;
+  int deltaMax = 0;
+  int pxCount = 0;
+  int pxMismatch = 0;
+
+  for (angle = 0; angle < TRIG_ANGLE_FULL; angle = angle + 16)
+  {
+    // Check the Q1.15 sine and cosine value
+    rad = 2 * M_PI * angle / TRIG_ANGLE_FULL;
+    error = fabs(trigSin(angle) / 32768.0 - sin(rad));
+    if (error > errorMax)
+      errorMax = error;
+    error = fabs(trigCos(angle) / 32768.0 - cos(rad));
+    if (error > errorMax)
+      errorMax = error;
+
+    // Check the pixel offset for a radius as done in the clocks
+    for (radius = 1; radius <= GLCD_YPIXELS / 2; radius++)
+    {
+      pxFixed = trigSinMul(angle, radius);
+      pxFloat = (s08)(sin(rad) * radius);
+      delta = abs(pxFixed - pxFloat);
+      pxFixed = trigCosMul(angle, radius);
+      pxFloat = (s08)(cos(rad) * radius);
+      delta = MAX(delta, abs(pxFixed - pxFloat));
+      if (delta != 0)
+        pxMismatch++;
+      deltaMax = MAX(delta, deltaMax);
+      pxCount++;
+    }
+  }
+
+  printf("trig   : angles=%d, maxError=%.6f\n", (int)(TRIG_ANGLE_FULL / 16),
+    errorMax);
+  printf("         radius=1..%d, positions=%d, mismatch=%d (%.3f%%), "
+    "maxDelta=%d px\n", GLCD_YPIXELS / 2, pxCount, pxMismatch,
+    pxMismatch * 100.0 / pxCount, deltaMax);
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doTimeAlarmPos
 //
@@ -2595,6 +2956,26 @@ u08 doTimeSet(cmdLine_t *cmdLine)
   return CMD_RET_OK;
 }
 
+//
+// Function: doTimeWarp
+//
+// Set time warp factor for virtual time
+//
+u08 doTimeWarp(cmdLine_t *cmdLine)
+{
+  // Set time warp factor
+  stubTimeWarpSet(TO_INT(argDouble[0]));
+
+  // Restart the wait timer as it may refer to the other time line
+  waitTimerStart(&tsTimer);
+
+  // Report time warp
+  if (cmdEcho == CMD_ECHO_YES)
+    emuTimePrint(ALM_NONE);
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: doVarPrint
 //
@@ -2719,7 +3100,7 @@ u08 doWaitTimerExpiry(cmdLine_t *cmdLine)
 
   // Wait for timer expiry (if not already expired)
   delay = TO_INT(argDouble[0]);
-  ch = waitTimerExpiry(&tvTimer, delay, MC_TRUE, NULL);
+  ch = waitTimerExpiry(&tsTimer, delay, MC_TRUE, NULL);
 
   // If the stack is active re-enable its 100 msec timer for subsequent list
   // commands
@@ -2743,7 +3124,7 @@ u08 doWaitTimerExpiry(cmdLine_t *cmdLine)
 //
 u08 doWaitTimerStart(cmdLine_t *cmdLine)
 {
-  waitTimerStart(&tvTimer);
+  waitTimerStart(&tsTimer);
 
   return CMD_RET_OK;
 }
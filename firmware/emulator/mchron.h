@@ -9,8 +9,14 @@
 #include "../avrlibtypes.h"
 #include "interpreter.h"
 
-// Number of data buffers to store graphics data in
+// Number of data buffers to store graphics data in. Override it at build time
+// via the GRBUF flag in MakefileEmu (1..128).
+#ifndef GRAPHICS_BUFFERS
 #define GRAPHICS_BUFFERS	10
+#endif
+#if GRAPHICS_BUFFERS < 1 || GRAPHICS_BUFFERS > 128
+#error "GRAPHICS_BUFFERS must be in range 1..128"
+#endif
 
 // Standard command handler function prototypes
 u08 doBeep(cmdLine_t *cmdLine);
@@ -31,6 +37,8 @@ u08 doDbStepOut(cmdLine_t *cmdLine);
 u08 doEepromPrint(cmdLine_t *cmdLine);
 u08 doEepromReset(cmdLine_t *cmdLine);
 u08 doEepromWrite(cmdLine_t *cmdLine);
+u08 doExecEventRecord(cmdLine_t *cmdLine);
+u08 doExecEventReplay(cmdLine_t *cmdLine);
 u08 doExecFile(cmdLine_t *cmdLine);
 u08 doExecListPrint(cmdLine_t *cmdLine);
 u08 doExecResume(cmdLine_t *cmdLine);
@@ -40,10 +48,12 @@ u08 doGrCopy(cmdLine_t *cmdLine);
 u08 doGrInfo(cmdLine_t *cmdLine);
 u08 doGrLoadCtrImg(cmdLine_t *cmdLine);
 u08 doGrLoadFile(cmdLine_t *cmdLine);
+u08 doGrLoadFileAnim(cmdLine_t *cmdLine);
 u08 doGrLoadFileImg(cmdLine_t *cmdLine);
 u08 doGrLoadFileSpr(cmdLine_t *cmdLine);
 u08 doGrReset(cmdLine_t *cmdLine);
 u08 doGrSaveFile(cmdLine_t *cmdLine);
+u08 doGrSaveFileBin(cmdLine_t *cmdLine);
 u08 doHelp(cmdLine_t *cmdLine);
 u08 doHelpCmd(cmdLine_t *cmdLine);
 u08 doHelpExpr(cmdLine_t *cmdLine);
@@ -53,6 +63,10 @@ u08 doLcdBacklightSet(cmdLine_t *cmdLine);
 u08 doLcdCursorReset(cmdLine_t *cmdLine);
 u08 doLcdDisplaySet(cmdLine_t *cmdLine);
 u08 doLcdErase(cmdLine_t *cmdLine);
+u08 doLcdFrameBufferSet(cmdLine_t *cmdLine);
+u08 doLcdFrameCompare(cmdLine_t *cmdLine);
+u08 doLcdFrameExport(cmdLine_t *cmdLine);
+u08 doLcdFrameExportStop(cmdLine_t *cmdLine);
 u08 doLcdGlutEdit(cmdLine_t *cmdLine);
 u08 doLcdGlutGrSet(cmdLine_t *cmdLine);
 u08 doLcdGlutSizeSet(cmdLine_t *cmdLine);
@@ -82,9 +96,13 @@ u08 doPaintLine(cmdLine_t *cmdLine);
 u08 doPaintNumber(cmdLine_t *cmdLine);
 u08 doPaintRect(cmdLine_t *cmdLine);
 u08 doPaintRectFill(cmdLine_t *cmdLine);
+u08 doPaintTriangleFill(cmdLine_t *cmdLine);
+u08 doStatsPong(cmdLine_t *cmdLine);
 u08 doStatsPrint(cmdLine_t *cmdLine);
+u08 doStatsProfScale(cmdLine_t *cmdLine);
 u08 doStatsReset(cmdLine_t *cmdLine);
 u08 doStatsStack(cmdLine_t *cmdLine);
+u08 doStatsTrig(cmdLine_t *cmdLine);
 u08 doTimeAlarmPos(cmdLine_t *cmdLine);
 u08 doTimeAlarmSet(cmdLine_t *cmdLine);
 u08 doTimeAlarmToggle(cmdLine_t *cmdLine);
@@ -95,6 +113,7 @@ u08 doTimeGet(cmdLine_t *cmdLine);
 u08 doTimePrint(cmdLine_t *cmdLine);
 u08 doTimeReset(cmdLine_t *cmdLine);
 u08 doTimeSet(cmdLine_t *cmdLine);
+u08 doTimeWarp(cmdLine_t *cmdLine);
 u08 doVarPrint(cmdLine_t *cmdLine);
 u08 doVarReset(cmdLine_t *cmdLine);
 u08 doVarSet(cmdLine_t *cmdLine);
@@ -120,6 +120,10 @@ DOMAIN(domCharEcho, \
 DOMAIN(domCharMode, \
   DOM_CHAR_VAL, "cr", 0, 0, "c = single cycle, r = run");
 
+// Lcd frame export format: 'p'bm image file sequence, animated 'g'if file
+DOMAIN(domCharExport, \
+  DOM_CHAR_VAL, "gp", 0, 0, "g = animated gif, p = pbm sequence");
+
 // Lcd backlight: 0..16
 DOMAIN(domNumBacklight, \
   DOM_NUM_RANGE, NULL, 0, 16, "0 = dim .. 16 = bright");
@@ -164,11 +168,11 @@ DOMAIN(domNumAxisSize, \
 DOMAIN(domNumAlign, \
   DOM_NUM_RANGE, NULL, 0, 2, "0 = top left, 1 = bottom left, 2 = auto");
 
-// Graphics buffer: 0..9
+// Graphics buffer: 0..GRAPHICS_BUFFERS - 1 (build-time, default 10, max 128)
 DOMAIN(domNumBufferId, \
   DOM_NUM_RANGE, NULL, 0, GRAPHICS_BUFFERS - 1, NULL);
 
-// Graphics buffer or all: -1..9
+// Graphics buffer or all: -1..GRAPHICS_BUFFERS - 1
 DOMAIN(domNumBufferAllId, \
   DOM_NUM_RANGE, NULL, -1, GRAPHICS_BUFFERS - 1, "-1 = all, other = buffer");
 
@@ -208,6 +212,10 @@ DOMAIN(domNumImageYSize, \
 DOMAIN(domNumFrame, \
   DOM_NUM_RANGE, NULL, 0, 127, NULL);
 
+// Sprite animation keyframe interval: 1..128
+DOMAIN(domNumKeyFrames, \
+  DOM_NUM_RANGE, NULL, 1, 128, "1 = keyframes only, other = max frames");
+
 // Graphics data format: 'b'yte (8-bit), 'w'ord (16-bit), 'd'ouble word (32-bit)
 DOMAIN(domCharDataFormat, \
   DOM_CHAR_VAL, "bwd", 0, 0, "b = 8-bit, w = 16-bit, d = 32-bit");
@@ -240,6 +248,22 @@ DOMAIN(domNumHour, \
 DOMAIN(domNumMinSec, \
   DOM_NUM_RANGE, NULL, 0, 59, NULL);
 
+// Profiler host-to-Monochron cpu speed scale: 1..10000
+DOMAIN(domNumProfScale, \
+  DOM_NUM_RANGE, NULL, 1, 10000, "host cpu is <scale> times faster");
+
+// Pong ball model check seed: 0..65535
+DOMAIN(domNumPongSeed, \
+  DOM_NUM_RANGE, NULL, 0, 65535, NULL);
+
+// Pong ball model check trajectories: 1..10000000
+DOMAIN(domNumPongServes, \
+  DOM_NUM_RANGE, NULL, 1, 10000000, NULL);
+
+// Time warp factor: 0..1000
+DOMAIN(domNumTimeWarp, \
+  DOM_NUM_RANGE, NULL, 0, 1000, "0 = max speed, 1 = real time, other = speed factor");
+
 // Variable name: [a-zA-Z_]+ where value 'null' means to ignore it
 DOMAIN(domStrVarName, \
   DOM_WORD_REGEX, "^[a-zA-Z_]+$", 0, 0, "word of [a-zA-Z_] characters, 'null' = ignore");
@@ -377,8 +401,14 @@ cmdArg_t argDbPcSet[] =
 // Argument profile for activating script debugging
 cmdArg_t argDbSet[] =
 { { ARGTYPE(ARG_NUM),    "enable",       &domNumOffOn } };
+// Argument profile for clock cycle profiler cpu speed scale
+cmdArg_t argStatsProfScale[] =
+{ { ARGTYPE(ARG_NUM),    "scale",        &domNumProfScale } };
 
 // Command 'e*'
+// Argument profile for recording or replaying an event log
+cmdArg_t argExecEvent[] =
+{ { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
 // Argument profile for printing stack level source list range
 cmdArg_t argExecListPrint[] =
 { { ARGTYPE(ARG_NUM),    "stacklevel",   &domNumStackLevel },
@@ -409,6 +439,13 @@ cmdArg_t argGrLoadFile[] =
 { { ARGTYPE(ARG_NUM),    "buffer",       &domNumBufferId },
   { ARGTYPE(ARG_CHAR),   "format",       &domCharDataFormat },
   { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
+// Argument profile for loading graphics file sprite animation data in buffer
+cmdArg_t argGrLoadFileAnim[] =
+{ { ARGTYPE(ARG_NUM),    "buffer",       &domNumBufferId },
+  { ARGTYPE(ARG_NUM),    "xsize",        &domNumFrameX },
+  { ARGTYPE(ARG_NUM),    "ysize",        &domNumFrameY },
+  { ARGTYPE(ARG_NUM),    "keyframe",     &domNumKeyFrames },
+  { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
 // Argument profile for loading graphics file image data in buffer
 cmdArg_t argGrLoadFileImg[] =
 { { ARGTYPE(ARG_NUM),    "buffer",       &domNumBufferId },
@@ -430,6 +467,10 @@ cmdArg_t argGrSaveFile[] =
 { { ARGTYPE(ARG_NUM),    "buffer",       &domNumBufferId },
   { ARGTYPE(ARG_NUM),    "width",        &domNumElements },
   { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
+// Argument profile for saving graphics buffer data in binary file
+cmdArg_t argGrSaveFileBin[] =
+{ { ARGTYPE(ARG_NUM),    "buffer",       &domNumBufferId },
+  { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
 
 // Command 'h*'
 // Argument profile for help command dictionary using command name
@@ -462,6 +503,16 @@ cmdArg_t argLcdBacklightSet[] =
 cmdArg_t argLcdDisplaySet[] =
 { { ARGTYPE(ARG_NUM),    "controller-0", &domNumOffOn },
   { ARGTYPE(ARG_NUM),    "controller-1", &domNumOffOn } };
+// Argument profile for lcd frame buffer on/off
+cmdArg_t argLcdFrameBufferSet[] =
+{ { ARGTYPE(ARG_NUM),    "on",           &domNumOffOn } };
+// Argument profile for lcd frame compare with golden frame
+cmdArg_t argLcdFrameCompare[] =
+{ { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
+// Argument profile for lcd frame export
+cmdArg_t argLcdFrameExport[] =
+{ { ARGTYPE(ARG_CHAR),   "format",       &domCharExport },
+  { ARGTYPE(ARG_STRING), "filename",     &domStrFileName } };
 // Argument profile for glut graphic options support
 cmdArg_t argLcdGlutGrSet[] =
 { { ARGTYPE(ARG_NUM),    "pixelbezel",   &domNumOffOn },
@@ -587,6 +638,15 @@ cmdArg_t argPaintRectFill[] =
 // Argument profile for paint set draw color
 cmdArg_t argPaintSetColor[] =
 { { ARGTYPE(ARG_NUM),    "color",        &domNumColor } };
+// Argument profile for paint triangle filled
+cmdArg_t argPaintTriangleFill[] =
+{ { ARGTYPE(ARG_NUM),    "x1",           &domNumPosX },
+  { ARGTYPE(ARG_NUM),    "y1",           &domNumPosY },
+  { ARGTYPE(ARG_NUM),    "x2",           &domNumPosX },
+  { ARGTYPE(ARG_NUM),    "y2",           &domNumPosY },
+  { ARGTYPE(ARG_NUM),    "x3",           &domNumPosX },
+  { ARGTYPE(ARG_NUM),    "y3",           &domNumPosY },
+  { ARGTYPE(ARG_NUM),    "pattern",      &domNumFillPattern } };
 
 // Command 'r*'
 // Argument profile for repeat for
@@ -599,6 +659,10 @@ cmdArg_t argRepeatFor[] =
 // Argument profile for providing command stack statistics
 cmdArg_t argStatsStack[] =
 { { ARGTYPE(ARG_NUM),    "enable",       &domNumOffOn } };
+// Argument profile for the pong ball model check
+cmdArg_t argStatsPong[] =
+{ { ARGTYPE(ARG_NUM),    "seed",         &domNumPongSeed },
+  { ARGTYPE(ARG_NUM),    "serves",       &domNumPongServes } };
 
 // Command 't*'
 // Argument profile for alarm switch position
@@ -627,6 +691,9 @@ cmdArg_t argTimeSet[] =
 { { ARGTYPE(ARG_NUM),    "hour",         &domNumHour },
   { ARGTYPE(ARG_NUM),    "min",          &domNumMinSec },
   { ARGTYPE(ARG_NUM),    "sec",          &domNumMinSec } };
+// Argument profile for time warp
+cmdArg_t argTimeWarp[] =
+{ { ARGTYPE(ARG_NUM),    "factor",       &domNumTimeWarp } };
 
 // Command 'v*'
 // Argument profile for variable print
@@ -690,6 +757,8 @@ cmdCommand_t cmdGroupDebug[] =
 // All commands for command group 'e' (execute)
 cmdCommand_t cmdGroupExecute[] =
 { { "e",   PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argExecute),         CMDHANDLER(doExecFile),        "execute commands from file" },
+  { "eep", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argExecEvent),       CMDHANDLER(doExecEventReplay), "replay event log in next session" },
+  { "eer", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argExecEvent),       CMDHANDLER(doExecEventRecord), "record event log of next session" },
   { "elp", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argExecListPrint),   CMDHANDLER(doExecListPrint),   "print source list" },
   { "elr", PCBTYPE(PCB_RETURN),      MC_TRUE,  CMDARGS(NULL),               PCCTRLHANDLER(doExecReturn),   "return from current stack level" },
   { "er",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doExecResume),      "resume interrupted execution" },
@@ -697,12 +766,14 @@ cmdCommand_t cmdGroupExecute[] =
 
 // All commands for command group 'g' (graphics buffer)
 cmdCommand_t cmdGroupGraphics[] =
-{ { "gbc", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrCopy),          CMDHANDLER(doGrCopy),          "copy graphics buffer" },
+{ { "gbb", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrSaveFileBin),   CMDHANDLER(doGrSaveFileBin),   "save graphics buffer to binary file" },
+  { "gbc", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrCopy),          CMDHANDLER(doGrCopy),          "copy graphics buffer" },
   { "gbi", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrInfo),          CMDHANDLER(doGrInfo),          "show graphics buffer info" },
   { "gbr", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrReset),         CMDHANDLER(doGrReset),         "reset graphics buffer" },
   { "gbs", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrSaveFile),      CMDHANDLER(doGrSaveFile),      "save graphics buffer to file" },
   { "gci", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrLoadCtrImg),    CMDHANDLER(doGrLoadCtrImg),    "load controller lcd image data" },
   { "gf",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrLoadFile),      CMDHANDLER(doGrLoadFile),      "load file graphics data" },
+  { "gfa", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrLoadFileAnim),  CMDHANDLER(doGrLoadFileAnim),  "load file sprite animation data" },
   { "gfi", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrLoadFileImg),   CMDHANDLER(doGrLoadFileImg),   "load file image data" },
   { "gfs", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argGrLoadFileSpr),   CMDHANDLER(doGrLoadFileSpr),   "load file sprite data" } };
 
@@ -727,6 +798,10 @@ cmdCommand_t cmdGroupLcd[] =
   { "lcs", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdActCtrlSet),   CMDHANDLER(doLcdActCtrlSet),   "set active lcd controller" },
   { "lds", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdDisplaySet),   CMDHANDLER(doLcdDisplaySet),   "switch lcd controller display on/off" },
   { "le",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doLcdErase),        "erase lcd display" },
+  { "lfb", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdFrameBufferSet), CMDHANDLER(doLcdFrameBufferSet), "switch lcd frame buffer on/off" },
+  { "lfc", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdFrameCompare), CMDHANDLER(doLcdFrameCompare), "compare lcd frame with golden frame" },
+  { "lfe", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdFrameExport),  CMDHANDLER(doLcdFrameExport),  "start lcd frame export" },
+  { "lfs", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doLcdFrameExportStop), "stop lcd frame export" },
   { "lge", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doLcdGlutEdit),     "edit glut lcd display" },
   { "lgg", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdGlutGrSet),    CMDHANDLER(doLcdGlutGrSet),    "set glut graphics options" },
   { "lgs", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argLcdGlutSizeSet),  CMDHANDLER(doLcdGlutSizeSet),  "set glut window size" },
@@ -764,7 +839,8 @@ cmdCommand_t cmdGroupPaint[] =
   { "prf", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argPaintRectFill),   CMDHANDLER(doPaintRectFill),   "paint filled rectangle" },
   { "ps",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argPaintSetColor),   CMDHANDLER(doPaintSetColor),   "set draw color" },
   { "psb", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doPaintSetBg),      "set draw color to background color" },
-  { "psf", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doPaintSetFg),      "set draw color to foreground color" } };
+  { "psf", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doPaintSetFg),      "set draw color to foreground color" },
+  { "ptf", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argPaintTriangleFill), CMDHANDLER(doPaintTriangleFill), "paint filled triangle" } };
 
 // All commands for command group 'r' (repeat)
 cmdCommand_t cmdGroupRepeat[] =
@@ -777,7 +853,10 @@ cmdCommand_t cmdGroupRepeat[] =
 cmdCommand_t cmdGroupStats[] =
 { { "sls", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argStatsStack),      CMDHANDLER(doStatsStack),      "set list runtime statistics" },
   { "sp",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doStatsPrint),      "print application statistics" },
-  { "sr",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doStatsReset),      "reset application statistics" } };
+  { "spg", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argStatsPong),       CMDHANDLER(doStatsPong),       "print pong fixed-point ball model check" },
+  { "sps", PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argStatsProfScale),  CMDHANDLER(doStatsProfScale),  "set cycle profiler cpu speed scale" },
+  { "sr",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doStatsReset),      "reset application statistics" },
+  { "st",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doStatsTrig),       "print fixed-point trig accuracy" } };
 
 // All commands for command group 't' (time/date/alarm)
 cmdCommand_t cmdGroupTime[] =
@@ -790,7 +869,8 @@ cmdCommand_t cmdGroupTime[] =
   { "tg",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argTimeGet),         CMDHANDLER(doTimeGet),         "get date/time" },
   { "tp",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doTimePrint),       "print time/date/alarm" },
   { "tr",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(NULL),               CMDHANDLER(doTimeReset),       "reset time to system time" },
-  { "ts",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argTimeSet),         CMDHANDLER(doTimeSet),         "set time" } };
+  { "ts",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argTimeSet),         CMDHANDLER(doTimeSet),         "set time" },
+  { "tw",  PCBTYPE(PCB_CONTINUE),    MC_TRUE,  CMDARGS(argTimeWarp),        CMDHANDLER(doTimeWarp),        "set time warp factor" } };
 
 // All commands for command group 'v' (variable)
 cmdCommand_t cmdGroupVar[] =
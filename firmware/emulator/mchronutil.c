@@ -12,6 +12,8 @@
 #include <math.h>
 #include <regex.h>
 #include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <time.h>
@@ -51,6 +53,8 @@
 // Emuchron utilities
 #include "dictutil.h"
 #include "listutil.h"
+#include "reactor.h"
+#include "render.h"
 #include "scanutil.h"
 #include "varutil.h"
 #include "mchronutil.h"
@@ -67,9 +71,45 @@
 // bootloader, leaving 30 KB free for software and progmem data.
 #define GRAPH_BUF_BYTES	30720
 
+// The max size of raw sprite animation data loaded from file. This data is
+// compressed into keyframes and deltas that must fit in GRAPH_BUF_BYTES.
+#define GRAPH_ANIM_RAW_BYTES	(2 * GRAPH_BUF_BYTES)
+
+// Sprite animation data consists of a sequence of frames. A frame starts with
+// its type byte. A keyframe holds all sprite frame elements. A delta frame
+// holds runs of [skip elements, changed elements, changed elements XOR-ed with
+// the previous frame], up to the sprite width. Elements are stored in little
+// endian byte order.
+#define GRAPH_ANIM_KEY		0
+#define GRAPH_ANIM_DELTA	1
+
 // The graphics data buffer lcd controller origin (as opposed to filename)
 #define GRAPH_ORIGIN_CTRL	"lcd controllers"
 
+// A binary graphics data file starts with a header, followed by the buffer
+// data elements in little endian byte order (as used by the emulator host).
+// The header holds (offset: size):
+// 0: 4 = magic "EGB1"
+// 4: 1 = element format (ELM_BYTE/ELM_WORD/ELM_DWORD)
+// 5: 1 = buffer type (GRAPH_RAW/GRAPH_IMAGE/GRAPH_SPRITE)
+// 6: 1 = image or sprite width
+// 7: 1 = image or sprite height
+// 8: 1 = image or sprite frames
+// 9: 1 = reserved (0)
+// 10: 2 = number of elements (little endian)
+// 12: 4 = FNV-1a 32-bit checksum of the data elements (little endian)
+#define GRAPH_BIN_MAGIC		"EGB1"
+#define GRAPH_BIN_HDR_BYTES	16
+
+// The FNV-1a 32-bit checksum parameters
+#define GRAPH_FNV_BASIS		0x811c9dc5U
+#define GRAPH_FNV_PRIME		0x01000193U
+
+// The graphics data file cache memory budget and max number of cached files.
+// When either is exceeded the least recently used cached file is evicted.
+#define GRAPH_CACHE_BYTES	(8 * GRAPH_BUF_BYTES)
+#define GRAPH_CACHE_FILES	32
+
 // Definition of an eeprom dictionary used to always print in sorted order
 typedef struct _eepDict_t
 {
@@ -89,6 +129,20 @@ typedef struct _emuClockDict_t
   char *clockDesc;		// The short description of the clock
 } emuClockDict_t;
 
+// Definition of a graphics data file cache entry. A cached file is identified
+// by its name, load format and max elements, and is valid as long as its
+// modification time and size are unchanged.
+typedef struct _grCache_t
+{
+  char *fileName;		// Graphics data filename (malloc-ed)
+  struct timespec fileMtime;	// File modification time
+  off_t fileSize;		// File size
+  u08 format;			// Data element format
+  u16 maxElements;		// Max number of elements loaded
+  u32 lastUse;			// Last use stamp for lru eviction
+  emuGrBuf_t emuGrBuf;		// Loaded graphics buffer
+} grCache_t;
+
 // Monochron defined data
 extern volatile rtcDateTime_t rtcDateTime;
 extern volatile rtcDateTime_t rtcDateTimeNext;
@@ -176,8 +230,32 @@ static int emuClockDictCount = sizeof(emuClockDict) / sizeof(emuClockDict_t);
 u08 invokeExit = MC_FALSE;
 static u08 closeWinMsg = MC_FALSE;
 
+// The graphics data file cache and its statistics
+static grCache_t grCache[GRAPH_CACHE_FILES];
+static u32 grCacheBytes = 0;
+static u32 grCacheUse = 0;
+static u32 grCacheHits = 0;
+static u32 grCacheMisses = 0;
+static u32 grCacheEvicts = 0;
+
 // Local function prototypes
 static void emuSigCatch(int sig, siginfo_t *siginfo, void *context);
+static u16 grBufAnimFrameApply(emuGrBuf_t *emuGrBuf, u16 pos,
+  void *frameData);
+static long long grBufAnimLcdWritesGet(void);
+static void grBufCacheAdd(char *fileName, struct stat *fileStat, u08 format,
+  u16 maxElements, emuGrBuf_t *emuGrBuf);
+static void grBufCacheEvict(grCache_t *grCacheEntry);
+static grCache_t *grBufCacheFind(char *fileName, struct stat *fileStat,
+  u08 format, u16 maxElements);
+static u32 grBufChecksum(u08 *data, u32 size);
+static uint32_t grBufElmGet(void *data, u08 format, u16 idx);
+static void grBufElmSet(void *data, u08 format, u16 idx, uint32_t elm);
+static void grBufLcdCreate(emuGrBuf_t *emuGrBuf);
+static u08 grBufLoadFileBin(char *argName, u08 format, u16 maxElements,
+  char *fileName, u08 *fileData, off_t fileSize, emuGrBuf_t *emuGrBuf);
+static u08 grBufLoadFileText(char *argName, u08 format, u16 maxElements,
+  u32 maxBytes, char *fileName, emuGrBuf_t *emuGrBuf);
 
 //
 // Function: emuArgcArgvGet
@@ -194,11 +272,16 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
   u08 argError = MC_FALSE;
 
   // Init references to command line argument positions
+  emuArgcArgv->argBatch = 0;
   emuArgcArgv->argDebug = 0;
+  emuArgcArgv->argFormat = 0;
   emuArgcArgv->argGlutGeometry = 0;
   emuArgcArgv->argGlutPosition = 0;
+  emuArgcArgv->argImage = 0;
+  emuArgcArgv->argJobs = 0;
   emuArgcArgv->argTty = 0;
   emuArgcArgv->argLcdType = 0;
+  emuArgcArgv->argOutput = 0;
 
   // Init the lcd device data
   emuArgcArgv->ctrlDeviceArgs.useNcurses = MC_FALSE;
@@ -210,17 +293,30 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
   emuArgcArgv->ctrlDeviceArgs.lcdGlutInitArgs.sizeX = 520;
   emuArgcArgv->ctrlDeviceArgs.lcdGlutInitArgs.sizeY = 264;
   emuArgcArgv->ctrlDeviceArgs.lcdGlutInitArgs.winClose = emuShutdown;
+  emuArgcArgv->ctrlDeviceArgs.lcdGlutInitArgs.winKey = reactorGlutKeyPut;
 
   // Do archaic command line processing to obtain the lcd output device(s),
   // lcd output configs and debug logfile
   while (argCount < argc)
   {
-    if (strncmp(argv[argCount], "-d", 4) == 0)
+    if (strncmp(argv[argCount], "-b", 4) == 0)
+    {
+      // Batch job
+      emuArgcArgv->argBatch = argCount + 1;
+      argCount = argCount + 2;
+    }
+    else if (strncmp(argv[argCount], "-d", 4) == 0)
     {
       // Debug output file name
       emuArgcArgv->argDebug = argCount + 1;
       argCount = argCount + 2;
     }
+    else if (strncmp(argv[argCount], "-f", 4) == 0)
+    {
+      // Batch output format
+      emuArgcArgv->argFormat = argCount + 1;
+      argCount = argCount + 2;
+    }
     else if (strncmp(argv[argCount], "-g", 4) == 0)
     {
       // Glut window geometry
@@ -233,12 +329,30 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
       argHelp = MC_TRUE;
       argCount = argc;
     }
+    else if (strncmp(argv[argCount], "-i", 4) == 0)
+    {
+      // Render image output folder
+      emuArgcArgv->argImage = argCount + 1;
+      argCount = argCount + 2;
+    }
+    else if (strncmp(argv[argCount], "-j", 4) == 0)
+    {
+      // Render worker processes
+      emuArgcArgv->argJobs = argCount + 1;
+      argCount = argCount + 2;
+    }
     else if (strncmp(argv[argCount], "-l", 4) == 0)
     {
       // Lcd stub device type
       emuArgcArgv->argLcdType = argCount + 1;
       argCount = argCount + 2;
     }
+    else if (strncmp(argv[argCount], "-o", 4) == 0)
+    {
+      // Batch output file name
+      emuArgcArgv->argOutput = argCount + 1;
+      argCount = argCount + 2;
+    }
     else if (strncmp(argv[argCount], "-p", 4) == 0)
     {
       // Glut window position
@@ -266,7 +380,7 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
     printf("%s: invalid/incomplete command argument\n\n", __progname);
   if (argHelp == MC_TRUE || argError == MC_TRUE)
   {
-    system("/usr/bin/head -24 ../support/help.txt | /usr/bin/tail -21 2>&1");
+    system("/usr/bin/head -42 ../support/help.txt | /usr/bin/tail -39 2>&1");
     return MC_FALSE;
   }
 
@@ -288,6 +402,11 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
       emuArgcArgv->ctrlDeviceArgs.useGlut = MC_TRUE;
       emuArgcArgv->ctrlDeviceArgs.useNcurses = MC_TRUE;
     }
+    else if (strcmp(argv[emuArgcArgv->argLcdType], "none") == 0)
+    {
+      emuArgcArgv->ctrlDeviceArgs.useGlut = MC_FALSE;
+      emuArgcArgv->ctrlDeviceArgs.useNcurses = MC_FALSE;
+    }
     else
     {
       printf("%s: -l: invalid lcd stub device type %s\n", __progname,
@@ -296,6 +415,65 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
     }
   }
 
+  // Validate batch job and its output format and file
+  if (emuArgcArgv->argBatch > 0)
+  {
+    if (strcmp(argv[emuArgcArgv->argBatch], "render") == 0 ||
+        strncmp(argv[emuArgcArgv->argBatch], "render:", 7) == 0 ||
+        strcmp(argv[emuArgcArgv->argBatch], "golden") == 0 ||
+        strncmp(argv[emuArgcArgv->argBatch], "golden:", 7) == 0)
+    {
+      // Rendering clock frames is done headless, and comparing them with
+      // golden frames requires the golden frame folder
+      emuArgcArgv->ctrlDeviceArgs.useGlut = MC_FALSE;
+      emuArgcArgv->ctrlDeviceArgs.useNcurses = MC_FALSE;
+      if (argv[emuArgcArgv->argBatch][0] == 'g' && emuArgcArgv->argImage == 0)
+      {
+        printf("%s: -b: golden frame folder (-i) is required\n", __progname);
+        return MC_FALSE;
+      }
+    }
+    else if (strcmp(argv[emuArgcArgv->argBatch], "perf") != 0 &&
+        strncmp(argv[emuArgcArgv->argBatch], "perf:", 5) != 0)
+    {
+      printf("%s: -b: invalid batch job %s\n", __progname,
+        argv[emuArgcArgv->argBatch]);
+      return MC_FALSE;
+    }
+    else if (emuArgcArgv->argImage > 0 || emuArgcArgv->argJobs > 0)
+    {
+      printf("%s: -i/-j: only supported with batch job render/golden\n",
+        __progname);
+      return MC_FALSE;
+    }
+    if (emuArgcArgv->argOutput == 0)
+    {
+      printf("%s: -b: batch output file (-o) is required\n", __progname);
+      return MC_FALSE;
+    }
+  }
+  else if (emuArgcArgv->argFormat > 0 || emuArgcArgv->argOutput > 0 ||
+      emuArgcArgv->argImage > 0 || emuArgcArgv->argJobs > 0)
+  {
+    printf("%s: -f/-i/-j/-o: only supported with batch job (-b)\n",
+      __progname);
+    return MC_FALSE;
+  }
+  if (emuArgcArgv->argJobs > 0 && atoi(argv[emuArgcArgv->argJobs]) <= 0)
+  {
+    printf("%s: -j: invalid number of workers %s\n", __progname,
+      argv[emuArgcArgv->argJobs]);
+    return MC_FALSE;
+  }
+  if (emuArgcArgv->argFormat > 0 &&
+      strcmp(argv[emuArgcArgv->argFormat], "csv") != 0 &&
+      strcmp(argv[emuArgcArgv->argFormat], "json") != 0)
+  {
+    printf("%s: -f: invalid batch output format %s\n", __progname,
+      argv[emuArgcArgv->argFormat]);
+    return MC_FALSE;
+  }
+
   // Validate glut window geometry
   if (emuArgcArgv->argGlutGeometry > 0)
   {
@@ -414,6 +592,84 @@ u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv)
   return MC_TRUE;
 }
 
+//
+// Function: emuBatchRun
+//
+// Run the batch job from the mchron startup command line arguments.
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 emuBatchRun(char *argv[], emuArgcArgv_t *emuArgcArgv)
+{
+  FILE *fp;
+  char *batch = argv[emuArgcArgv->argBatch];
+  char *suite = NULL;
+  char *imageDir = NULL;
+  int jobs;
+  u08 json = MC_FALSE;
+  u08 success;
+
+  // Get the output format
+  if (emuArgcArgv->argFormat > 0 &&
+      strcmp(argv[emuArgcArgv->argFormat], "json") == 0)
+    json = MC_TRUE;
+
+  // Open the output file
+  fp = fopen(argv[emuArgcArgv->argOutput], "w");
+  if (fp == NULL)
+  {
+    printf("%s: -o: cannot open file \"%s\"\n", __progname,
+      argv[emuArgcArgv->argOutput]);
+    return MC_FALSE;
+  }
+
+  printf("batch  : %s\n", batch);
+  if (strncmp(batch, "render", 6) == 0 || strncmp(batch, "golden", 6) == 0)
+  {
+    // Render clock frames using the (optional) render specification, image
+    // or golden frame folder and number of workers (default: one per online
+    // cpu)
+    if (emuArgcArgv->argImage > 0)
+      imageDir = argv[emuArgcArgv->argImage];
+    if (emuArgcArgv->argJobs > 0)
+      jobs = atoi(argv[emuArgcArgv->argJobs]);
+    else
+      jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs <= 0)
+      jobs = 1;
+    success = renderBatch(batch[6] == ':' ? &batch[7] : NULL,
+      emuClockDictCount, fp, json == MC_TRUE ? RENDER_FORMAT_JSON :
+      RENDER_FORMAT_CSV, batch[0] == 'g' ? RENDER_MODE_GOLDEN :
+      RENDER_MODE_HASH, jobs, imageDir);
+  }
+  else
+  {
+    // Run the (optional) performance test suite
+    if (batch[4] == ':')
+      suite = &batch[5];
+    success = perfBatch(suite, fp, json == MC_TRUE ? PERF_FORMAT_JSON :
+      PERF_FORMAT_CSV);
+    if (success == MC_FALSE)
+      printf("%s: -b: unknown test suite %s\n", __progname, suite);
+  }
+  fclose(fp);
+  if (success == MC_TRUE || batch[0] != 'p')
+    printf("output : %s\n", argv[emuArgcArgv->argOutput]);
+
+  return success;
+}
+
+//
+// Function: emuClockDescGet
+//
+// Get the description of a clock in the mchron clock pool
+//
+char *emuClockDescGet(int clock)
+{
+  if (clock < 0 || clock >= emuClockDictCount)
+    return "";
+  return emuClockDict[clock].clockDesc;
+}
+
 //
 // Function: emuClockPoolCleanup
 //
@@ -791,7 +1047,7 @@ void emuEepromPrint(void)
     printf("invalid\n");
 
   // All Monochron eeprom settings
-  printf("byte  address  name              value  value\n");
+  printf("byte  address  name              value  value  writes\n");
 
   // Copy all id's, sort them and then print them
   for (i = 0; i < eepDictCount; i++)
@@ -814,9 +1070,10 @@ void emuEepromPrint(void)
   for (i = 0; i < eepDictCount; i++)
   {
     value = eeprom_read_byte((uint8_t *)(size_t)dictSort[i]->eepItemId);
-    printf("  %2d    0x%03x  %-15s     %3d   0x%02x\n",
+    printf("  %2d    0x%03x  %-15s     %3d   0x%02x  %6lld\n",
       dictSort[i]->eepItemId - EE_OFFSET, dictSort[i]->eepItemId,
-      dictSort[i]->eepItemName, value, value);
+      dictSort[i]->eepItemName, value, value,
+      stubEepWritesGet(dictSort[i]->eepItemId));
   }
 }
 
@@ -973,8 +1230,8 @@ void emuShutdown(void)
 //
 // Function: emuSigCatch
 //
-// Main signal handler wrapper. Used for system timers and signals to implement
-// a graceful shutdown (preventing a screwed up bash terminal and killing alarm
+// Main signal handler wrapper. Used for signals to implement a graceful
+// shutdown (preventing a screwed up bash terminal and killing alarm
 // audio).
 // For signals that should make the application quit, switch back to keyboard
 // line mode and kill audio before we actually exit.
@@ -983,13 +1240,7 @@ static void emuSigCatch(int sig, siginfo_t *siginfo, void *context)
 {
   //printf("signo=%d\n", siginfo->si_signo);
 
-  if (sig == SIGVTALRM)
-  {
-    // Recurring system timer expiry.
-    // Execute the handler as requested in emuSysTimerStart().
-    ((void (*)(void))siginfo->si_value.sival_ptr)();
-  }
-  else if (sig == SIGINT)
+  if (sig == SIGINT)
   {
     // Keyboard: "^C"
     printf("\n<ctrl>c - interrupt\n");
@@ -1057,8 +1308,6 @@ void emuSigSetup(void)
   sigAction.sa_sigaction = &emuSigCatch;
   sigAction.sa_flags = SA_SIGINFO;
 
-  if (sigaction(SIGVTALRM, &sigAction, NULL) < 0)
-    printf("Cannot set handler SIGVTALRM (%d)\n", SIGVTALRM);
   if (sigaction(SIGINT, &sigAction, NULL) < 0)
     printf("Cannot set handler SIGINT (%d)\n", SIGINT);
   if (sigaction(SIGTSTP, &sigAction, NULL) < 0)
@@ -1098,6 +1347,10 @@ void emuTimePrint(u08 type)
     rtcDateTime.timeMin, rtcDateTime.timeSec);
   printf("date   : %02d/%02d/%04d (dd/mm/yyyy)\n", rtcDateTime.dateDay,
     rtcDateTime.dateMon, rtcDateTime.dateYear + 2000);
+  if (stubTimeWarpGet() == TIME_WARP_MAX)
+    printf("warp   : max (virtual time)\n");
+  else if (stubTimeWarpGet() != TIME_WARP_REAL)
+    printf("warp   : %dx (virtual time)\n", stubTimeWarpGet());
   if (type == ALM_EMUCHRON)
     printf("alarm  : %02d:%02d (hh:mm)\n", emuAlarmH, emuAlarmM);
   else if (type == ALM_MONOCHRON)
@@ -1195,6 +1448,338 @@ u08 emuValuePrint(double value, u08 detail, u08 newline, u08 print)
   return length;
 }
 
+//
+// Function: grBufAnimCreate
+//
+// Compress the frames of a sprite graphics buffer into sprite animation
+// keyframes and deltas. A frame is stored as a delta against its previous
+// frame unless a keyframe is due or the delta would not be smaller.
+//
+u08 grBufAnimCreate(char *argName, u08 keyFrames, emuGrBuf_t *emuGrBuf)
+{
+  u08 *animData;
+  u08 width = emuGrBuf->bufSprWidth;
+  u08 format = emuGrBuf->bufElmFormat;
+  u08 elmBytes = emuGrBuf->bufElmByteSize;
+  u16 frameBytes = 1 + width * elmBytes;
+  u16 pos = 0;
+  u16 framePos;
+  u16 elmIdx;
+  uint32_t elm;
+  u08 frame;
+  u08 col;
+  u08 start;
+  u08 skip;
+  u08 count;
+  u08 gap;
+  u08 i;
+  u08 j;
+
+  // Reserve data for all frames being a keyframe
+  animData = malloc(emuGrBuf->bufSprFrames * frameBytes);
+
+  for (frame = 0; frame < emuGrBuf->bufSprFrames; frame++)
+  {
+    elmIdx = frame * width;
+    framePos = pos;
+
+    // Build a delta frame as runs of unchanged and changed elements, where a
+    // short gap of unchanged elements is cheaper to keep in a run
+    if (frame % keyFrames != 0)
+    {
+      animData[pos] = GRAPH_ANIM_DELTA;
+      pos++;
+      col = 0;
+      while (col < width && pos < framePos + frameBytes)
+      {
+        skip = 0;
+        while (col < width && grBufElmGet(emuGrBuf->bufData, format,
+            elmIdx + col) == grBufElmGet(emuGrBuf->bufData, format,
+            elmIdx + col - width))
+        {
+          skip++;
+          col++;
+        }
+        start = col;
+        count = 0;
+        while (col < width)
+        {
+          for (gap = 0; col + gap < width; gap++)
+          {
+            if (grBufElmGet(emuGrBuf->bufData, format, elmIdx + col + gap) !=
+                grBufElmGet(emuGrBuf->bufData, format,
+                elmIdx + col + gap - width))
+              break;
+          }
+          if (gap == 0)
+            gap = 1;
+          else if (col + gap >= width || gap * elmBytes > 2)
+            break;
+          count = count + gap;
+          col = col + gap;
+        }
+
+        // Add the run when it fits in a keyframe size
+        if (pos + 2 + count * elmBytes >= framePos + frameBytes)
+        {
+          pos = framePos + frameBytes;
+          break;
+        }
+        animData[pos] = skip;
+        animData[pos + 1] = count;
+        pos = pos + 2;
+        for (i = start; i < start + count; i++)
+        {
+          elm = grBufElmGet(emuGrBuf->bufData, format, elmIdx + i) ^
+            grBufElmGet(emuGrBuf->bufData, format, elmIdx + i - width);
+          for (j = 0; j < elmBytes; j++)
+          {
+            animData[pos] = (u08)(elm >> (j * 8));
+            pos++;
+          }
+        }
+      }
+
+      // When the delta is not smaller, store a keyframe instead
+      if (pos < framePos + frameBytes)
+        continue;
+      pos = framePos;
+    }
+
+    // Build a keyframe
+    animData[pos] = GRAPH_ANIM_KEY;
+    pos++;
+    for (i = 0; i < width; i++)
+    {
+      elm = grBufElmGet(emuGrBuf->bufData, format, elmIdx + i);
+      for (j = 0; j < elmBytes; j++)
+      {
+        animData[pos] = (u08)(elm >> (j * 8));
+        pos++;
+      }
+    }
+  }
+
+  // The compressed data must fit in a graphics buffer
+  if (pos > GRAPH_BUF_BYTES)
+  {
+    printf("%s? animation data overflow (%d bytes)\n", argName, pos);
+    free(animData);
+    grBufReset(emuGrBuf);
+    return CMD_RET_ERROR;
+  }
+
+  // Replace the sprite data by the animation data
+  free(emuGrBuf->bufData);
+  emuGrBuf->bufData = realloc(animData, pos);
+  emuGrBuf->bufType = GRAPH_ANIM;
+  emuGrBuf->bufAnimBytes = pos;
+  emuGrBuf->bufAnimKeys = keyFrames;
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: grBufAnimFrameApply
+//
+// Apply the sprite animation frame at a data offset on decoded frame elements
+// and return the data offset of the next frame. When no frame elements are
+// provided, only the data offset of the next frame is returned.
+//
+static u16 grBufAnimFrameApply(emuGrBuf_t *emuGrBuf, u16 pos, void *frameData)
+{
+  u08 *animData = (u08 *)emuGrBuf->bufData;
+  u08 width = emuGrBuf->bufSprWidth;
+  u08 format = emuGrBuf->bufElmFormat;
+  u08 elmBytes = emuGrBuf->bufElmByteSize;
+  uint32_t elm;
+  u08 col = 0;
+  u08 count;
+  u08 i;
+  u08 j;
+
+  // A keyframe replaces all elements and a delta frame XORs runs of elements
+  if (animData[pos] == GRAPH_ANIM_KEY)
+  {
+    pos++;
+    for (col = 0; col < width; col++)
+    {
+      if (frameData != NULL)
+      {
+        elm = 0;
+        for (j = 0; j < elmBytes; j++)
+          elm = elm | ((uint32_t)animData[pos + j] << (j * 8));
+        grBufElmSet(frameData, format, col, elm);
+      }
+      pos = pos + elmBytes;
+    }
+    return pos;
+  }
+
+  pos++;
+  while (col < width)
+  {
+    col = col + animData[pos];
+    count = animData[pos + 1];
+    pos = pos + 2;
+    for (i = 0; i < count; i++)
+    {
+      if (frameData != NULL)
+      {
+        elm = 0;
+        for (j = 0; j < elmBytes; j++)
+          elm = elm | ((uint32_t)animData[pos + j] << (j * 8));
+        grBufElmSet(frameData, format, col,
+          grBufElmGet(frameData, format, col) ^ elm);
+      }
+      pos = pos + elmBytes;
+      col++;
+    }
+  }
+
+  return pos;
+}
+
+//
+// Function: grBufAnimLcdWritesGet
+//
+// Get the number of writes that changed or may have changed the lcd image,
+// being glcd byte writes on the lcd or in the lcd frame buffer and lcd
+// display and startline commands
+//
+static long long grBufAnimLcdWritesGet(void)
+{
+  ctrlGlcdStats_t glcdStats;
+  ctrlStats_t ctrlStats;
+
+  ctrlStatsGet(&glcdStats, &ctrlStats);
+  return glcdStats.dataWrite + glcdStats.frameWrite + ctrlStats.displayReq +
+    ctrlStats.startLineReq;
+}
+
+//
+// Function: grBufCacheAdd
+//
+// Add a copy of a graphics buffer loaded from file to the file cache, evicting
+// least recently used files to stay within the cache budget
+//
+static void grBufCacheAdd(char *fileName, struct stat *fileStat, u08 format,
+  u16 maxElements, emuGrBuf_t *emuGrBuf)
+{
+  grCache_t *grCacheEntry = NULL;
+  grCache_t *grCacheLru;
+  u32 bytes = emuGrBuf->bufElmCount * emuGrBuf->bufElmByteSize;
+  int i;
+
+  // Evict least recently used files until there is room for the new one
+  while (MC_TRUE)
+  {
+    grCacheLru = NULL;
+    grCacheEntry = NULL;
+    for (i = 0; i < GRAPH_CACHE_FILES; i++)
+    {
+      if (grCache[i].fileName == NULL)
+        grCacheEntry = &grCache[i];
+      else if (grCacheLru == NULL || grCache[i].lastUse < grCacheLru->lastUse)
+        grCacheLru = &grCache[i];
+    }
+    if (grCacheEntry != NULL && grCacheBytes + bytes <= GRAPH_CACHE_BYTES)
+      break;
+    grBufCacheEvict(grCacheLru);
+    grCacheEvicts++;
+  }
+
+  // Keep our own copy of the graphics buffer
+  grCacheEntry->fileName = malloc(strlen(fileName) + 1);
+  strcpy(grCacheEntry->fileName, fileName);
+  grCacheEntry->fileMtime = fileStat->st_mtim;
+  grCacheEntry->fileSize = fileStat->st_size;
+  grCacheEntry->format = format;
+  grCacheEntry->maxElements = maxElements;
+  grCacheEntry->lastUse = ++grCacheUse;
+  grBufInit(&grCacheEntry->emuGrBuf);
+  grBufCopy(emuGrBuf, &grCacheEntry->emuGrBuf);
+  grCacheBytes = grCacheBytes + bytes;
+}
+
+//
+// Function: grBufCacheEvict
+//
+// Remove a file from the graphics data file cache
+//
+static void grBufCacheEvict(grCache_t *grCacheEntry)
+{
+  grCacheBytes = grCacheBytes - grCacheEntry->emuGrBuf.bufElmCount *
+    grCacheEntry->emuGrBuf.bufElmByteSize;
+  grBufReset(&grCacheEntry->emuGrBuf);
+  free(grCacheEntry->fileName);
+  grCacheEntry->fileName = NULL;
+}
+
+//
+// Function: grBufCacheFind
+//
+// Find a file in the graphics data file cache. A cached file that has been
+// modified since it was cached is evicted.
+//
+static grCache_t *grBufCacheFind(char *fileName, struct stat *fileStat,
+  u08 format, u16 maxElements)
+{
+  int i;
+
+  for (i = 0; i < GRAPH_CACHE_FILES; i++)
+  {
+    if (grCache[i].fileName != NULL && grCache[i].format == format &&
+        grCache[i].maxElements == maxElements &&
+        strcmp(grCache[i].fileName, fileName) == 0)
+    {
+      if (grCache[i].fileSize == fileStat->st_size &&
+          grCache[i].fileMtime.tv_sec == fileStat->st_mtim.tv_sec &&
+          grCache[i].fileMtime.tv_nsec == fileStat->st_mtim.tv_nsec)
+        return &grCache[i];
+      grBufCacheEvict(&grCache[i]);
+      return NULL;
+    }
+  }
+
+  return NULL;
+}
+
+//
+// Function: grBufCacheReset
+//
+// Clear the graphics data file cache
+//
+void grBufCacheReset(void)
+{
+  int i;
+
+  for (i = 0; i < GRAPH_CACHE_FILES; i++)
+  {
+    if (grCache[i].fileName != NULL)
+      grBufCacheEvict(&grCache[i]);
+  }
+}
+
+//
+// Function: grBufChecksum
+//
+// Get the FNV-1a 32-bit checksum of graphics buffer data
+//
+static u32 grBufChecksum(u08 *data, u32 size)
+{
+  u32 checksum = GRAPH_FNV_BASIS;
+  u32 i;
+
+  for (i = 0; i < size; i++)
+  {
+    checksum = checksum ^ data[i];
+    checksum = checksum * GRAPH_FNV_PRIME;
+  }
+
+  return checksum;
+}
+
 //
 // Function: grBufCopy
 //
@@ -1202,6 +1787,8 @@ u08 emuValuePrint(double value, u08 detail, u08 newline, u08 print)
 //
 u08 grBufCopy(emuGrBuf_t *emuGrBufFrom, emuGrBuf_t *emuGrBufTo)
 {
+  u32 size;
+
   // Omit copy if we copy into oneself
   if (emuGrBufFrom == emuGrBufTo)
     return CMD_RET_OK;
@@ -1209,8 +1796,13 @@ u08 grBufCopy(emuGrBuf_t *emuGrBufFrom, emuGrBuf_t *emuGrBufTo)
   // Reset target buffer
   grBufReset(emuGrBufTo);
 
-  // Copy buffer but make fresh copy of origin string and buffer data
+  // Copy buffer but make fresh copy of origin string and buffer data. The lcd
+  // byte aligned data and animation state are not copied but recreated upon
+  // painting.
   *emuGrBufTo = *emuGrBufFrom;
+  emuGrBufTo->bufLcdData = NULL;
+  emuGrBufTo->bufLcdBytes = 0;
+  emuGrBufTo->bufAnim = NULL;
   if (emuGrBufFrom->bufOrigin != NULL)
   {
      emuGrBufTo->bufOrigin = malloc(strlen(emuGrBufFrom->bufOrigin) + 1);
@@ -1218,15 +1810,47 @@ u08 grBufCopy(emuGrBuf_t *emuGrBufFrom, emuGrBuf_t *emuGrBufTo)
   }
   if (emuGrBufFrom->bufData != NULL)
   {
-     emuGrBufTo->bufData =
-       malloc(emuGrBufFrom->bufElmCount * emuGrBufFrom->bufElmByteSize);
-     memcpy(emuGrBufTo->bufData, emuGrBufFrom->bufData,
-       emuGrBufFrom->bufElmCount * emuGrBufFrom->bufElmByteSize);
+     if (emuGrBufFrom->bufType == GRAPH_ANIM)
+       size = emuGrBufFrom->bufAnimBytes;
+     else
+       size = emuGrBufFrom->bufElmCount * emuGrBufFrom->bufElmByteSize;
+     emuGrBufTo->bufData = malloc(size);
+     memcpy(emuGrBufTo->bufData, emuGrBufFrom->bufData, size);
   }
 
   return CMD_RET_OK;
 }
 
+//
+// Function: grBufElmGet
+//
+// Get a graphics data element
+//
+static uint32_t grBufElmGet(void *data, u08 format, u16 idx)
+{
+  if (format == ELM_BYTE)
+    return ((uint8_t *)data)[idx];
+  else if (format == ELM_WORD)
+    return ((uint16_t *)data)[idx];
+  else
+    return ((uint32_t *)data)[idx];
+}
+
+//
+// Function: grBufElmSet
+//
+// Set a graphics data element
+//
+static void grBufElmSet(void *data, u08 format, u16 idx, uint32_t elm)
+{
+  if (format == ELM_BYTE)
+    ((uint8_t *)data)[idx] = (uint8_t)elm;
+  else if (format == ELM_WORD)
+    ((uint16_t *)data)[idx] = (uint16_t)elm;
+  else
+    ((uint32_t *)data)[idx] = elm;
+}
+
 //
 // Function: grBufInfoPrint
 //
@@ -1261,17 +1885,24 @@ void grBufInfoPrint(emuGrBuf_t *emuGrBuf)
     printf("(%d bytes per element)\n", emuGrBuf->bufElmByteSize);
 
   // Data elements and size in bytes
-  printf("data elements   : %d (%d bytes)\n", emuGrBuf->bufElmCount,
-    emuGrBuf->bufElmCount * emuGrBuf->bufElmByteSize);
+  if (emuGrBuf->bufType == GRAPH_ANIM)
+    printf("data elements   : %d (%d bytes compressed to %d bytes)\n",
+      emuGrBuf->bufElmCount, emuGrBuf->bufElmCount * emuGrBuf->bufElmByteSize,
+      emuGrBuf->bufAnimBytes);
+  else
+    printf("data elements   : %d (%d bytes)\n", emuGrBuf->bufElmCount,
+      emuGrBuf->bufElmCount * emuGrBuf->bufElmByteSize);
 
-  // We either have raw data, image data or sprite data
+  // We either have raw data, image data, sprite data or animation data
   printf("data contents   : ");
   if (emuGrBuf->bufType == GRAPH_RAW)
     printf("raw (free format data)\n");
   else if (emuGrBuf->bufType == GRAPH_IMAGE)
     printf("image (single fixed size image)\n");
-  else // GRAPH_SPRITE
+  else if (emuGrBuf->bufType == GRAPH_SPRITE)
     printf("sprite (multiple fixed size image frames)\n");
+  else // GRAPH_ANIM
+    printf("animation (sprite keyframes and delta frames)\n");
 
   // Provide content details
   printf("content details : ");
@@ -1280,9 +1911,31 @@ void grBufInfoPrint(emuGrBuf_t *emuGrBuf)
   else if (emuGrBuf->bufType == GRAPH_IMAGE)
     printf("image size %dx%d pixels requiring %d frame(s)\n",
       emuGrBuf->bufImgWidth, emuGrBuf->bufImgHeight, emuGrBuf->bufImgFrames);
-  else // GRAPH_SPRITE
+  else if (emuGrBuf->bufType == GRAPH_SPRITE)
     printf("sprite size %dx%d pixels, %d frame(s)\n",
       emuGrBuf->bufSprWidth, emuGrBuf->bufSprHeight, emuGrBuf->bufSprFrames);
+  else // GRAPH_ANIM
+    printf("sprite size %dx%d pixels, %d frame(s), keyframe interval %d\n",
+      emuGrBuf->bufSprWidth, emuGrBuf->bufSprHeight, emuGrBuf->bufSprFrames,
+      emuGrBuf->bufAnimKeys);
+
+  // Provide file cache result and statistics
+  printf("file cache      : ");
+  if (emuGrBuf->bufCache == GRAPH_CACHE_NONE)
+    printf("n/a ");
+  else if (emuGrBuf->bufCache == GRAPH_CACHE_MISS)
+    printf("miss ");
+  else // GRAPH_CACHE_HIT
+    printf("hit ");
+  printf("(hits %u, misses %u, evictions %u, cached %u bytes)\n", grCacheHits,
+    grCacheMisses, grCacheEvicts, grCacheBytes);
+
+  // Provide lcd byte aligned data size
+  printf("lcd aligned     : ");
+  if (emuGrBuf->bufLcdData == NULL)
+    printf("none\n");
+  else
+    printf("%u bytes (8 y offsets)\n", emuGrBuf->bufLcdBytes);
 }
 
 //
@@ -1298,6 +1951,104 @@ void grBufInit(emuGrBuf_t *emuGrBuf)
   emuGrBuf->bufOrigin = NULL;
   emuGrBuf->bufElmFormat = ELM_NULL;
   emuGrBuf->bufData = NULL;
+  emuGrBuf->bufLcdData = NULL;
+  emuGrBuf->bufAnim = NULL;
+}
+
+//
+// Function: grBufLcdCreate
+//
+// Create lcd byte aligned data for the image or sprite frames in a graphics
+// buffer. For each frame and for each of the 8 y pixel offsets within an lcd
+// byte it holds the frame pixels as lcd bytes, row by row, in the order they
+// are written to the lcd controllers.
+//
+static void grBufLcdCreate(emuGrBuf_t *emuGrBuf)
+{
+  u08 width;
+  u08 height;
+  u08 frames;
+  u08 frame;
+  u08 offset;
+  u08 row;
+  u08 rows;
+  u08 col;
+  u08 bit;
+  u08 lcdByte;
+  u08 *lcdData;
+  int pixel;
+  u16 elmIdx;
+  u08 elmBit;
+  uint32_t elm;
+
+  // Get the frame size
+  if (emuGrBuf->bufType == GRAPH_IMAGE)
+  {
+    width = emuGrBuf->bufImgWidth;
+    height = emuGrBuf->bufImgHeight;
+    frames = 1;
+  }
+  else // GRAPH_SPRITE
+  {
+    width = emuGrBuf->bufSprWidth;
+    height = emuGrBuf->bufSprHeight;
+    frames = emuGrBuf->bufSprFrames;
+  }
+
+  // Reserve lcd data for all frames and y offsets
+  emuGrBuf->bufLcdBytes = 0;
+  for (offset = 0; offset < 8; offset++)
+    emuGrBuf->bufLcdBytes =
+      emuGrBuf->bufLcdBytes + (offset + height + 7) / 8 * width;
+  emuGrBuf->bufLcdBytes = emuGrBuf->bufLcdBytes * frames;
+  emuGrBuf->bufLcdData = malloc(emuGrBuf->bufLcdBytes);
+  lcdData = emuGrBuf->bufLcdData;
+
+  // Transcode the frame pixels into lcd bytes
+  for (frame = 0; frame < frames; frame++)
+  {
+    for (offset = 0; offset < 8; offset++)
+    {
+      rows = (offset + height + 7) / 8;
+      for (row = 0; row < rows; row++)
+      {
+        for (col = 0; col < width; col++)
+        {
+          lcdByte = 0;
+          for (bit = 0; bit < 8; bit++)
+          {
+            // Skip pixels outside the frame
+            pixel = row * 8 + bit - offset;
+            if (pixel < 0 || pixel >= height)
+              continue;
+
+            // An image spreads its pixel rows over multiple element rows
+            // whereas a sprite frame is a single element row
+            if (emuGrBuf->bufType == GRAPH_IMAGE)
+            {
+              elmIdx = pixel / emuGrBuf->bufElmBitSize * width + col;
+              elmBit = pixel % emuGrBuf->bufElmBitSize;
+            }
+            else
+            {
+              elmIdx = frame * width + col;
+              elmBit = pixel;
+            }
+            if (emuGrBuf->bufElmFormat == ELM_BYTE)
+              elm = ((uint8_t *)(emuGrBuf->bufData))[elmIdx];
+            else if (emuGrBuf->bufElmFormat == ELM_WORD)
+              elm = ((uint16_t *)(emuGrBuf->bufData))[elmIdx];
+            else
+              elm = ((uint32_t *)(emuGrBuf->bufData))[elmIdx];
+            if ((elm >> elmBit) & 0x1)
+              lcdByte = lcdByte | (0x1 << bit);
+          }
+          *lcdData = lcdByte;
+          lcdData++;
+        }
+      }
+    }
+  }
 }
 
 //
@@ -1416,25 +2167,205 @@ void grBufLoadCtrl(u08 x, u08 y, u08 width, u08 height, char formatName,
 //
 // Function: grBufLoadFile
 //
-// Load graphics buffer with data from a file
+// Load graphics buffer with data from a file. A file that was loaded before
+// and has not been modified since is copied from the file cache.
 //
 u08 grBufLoadFile(char *argName, char formatName, u16 maxElements,
   char *fileName, emuGrBuf_t *emuGrBuf)
+{
+  int fd;
+  struct stat fileStat;
+  u08 *fileData;
+  grCache_t *grCacheEntry;
+  u08 fileBinary = MC_FALSE;
+  u08 format;
+  u08 retVal = CMD_RET_OK;
+
+  // Setup for loading graphics data
+  grBufReset(emuGrBuf);
+  format = emuFormatGet(formatName, NULL, NULL);
+
+  // Get the file from the cache when it is unmodified since it was cached
+  fd = open(fileName, O_RDONLY);
+  if (fd >= 0 && fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    fd = -1;
+  }
+  if (fd >= 0)
+  {
+    grCacheEntry = grBufCacheFind(fileName, &fileStat, format, maxElements);
+    if (grCacheEntry != NULL)
+    {
+      close(fd);
+      grBufCopy(&grCacheEntry->emuGrBuf, emuGrBuf);
+      emuGrBuf->bufCache = GRAPH_CACHE_HIT;
+      emuGrBuf->bufCreate = time(NULL);
+      grCacheEntry->lastUse = ++grCacheUse;
+      grCacheHits++;
+      return CMD_RET_OK;
+    }
+  }
+
+  // Map a binary graphics data file and load it without parsing, or else
+  // load it as a text graphics data file
+  if (fd >= 0 && fileStat.st_size >= GRAPH_BIN_HDR_BYTES)
+  {
+    fileData = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (fileData != MAP_FAILED)
+    {
+      if (memcmp(fileData, GRAPH_BIN_MAGIC, 4) == 0)
+      {
+        fileBinary = MC_TRUE;
+        retVal = grBufLoadFileBin(argName, format, maxElements, fileName,
+          fileData, fileStat.st_size, emuGrBuf);
+      }
+      munmap(fileData, fileStat.st_size);
+    }
+  }
+  if (fileBinary == MC_FALSE)
+    retVal = grBufLoadFileText(argName, format, maxElements, GRAPH_BUF_BYTES,
+      fileName, emuGrBuf);
+  if (fd >= 0)
+    close(fd);
+  if (retVal != CMD_RET_OK)
+    return retVal;
+
+  // Add the loaded file to the cache
+  emuGrBuf->bufCache = GRAPH_CACHE_MISS;
+  grCacheMisses++;
+  if (fd >= 0)
+    grBufCacheAdd(fileName, &fileStat, format, maxElements, emuGrBuf);
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: grBufLoadFileAnim
+//
+// Load graphics buffer with raw sprite animation data from a text file. As
+// the data is to be compressed into keyframes and deltas it may exceed the
+// size of a graphics buffer.
+//
+u08 grBufLoadFileAnim(char *argName, char formatName, char *fileName,
+  emuGrBuf_t *emuGrBuf)
+{
+  grBufReset(emuGrBuf);
+  return grBufLoadFileText(argName, emuFormatGet(formatName, NULL, NULL), 0,
+    GRAPH_ANIM_RAW_BYTES, fileName, emuGrBuf);
+}
+
+//
+// Function: grBufLoadFileBin
+//
+// Load graphics buffer with data from a memory-mapped binary file. The data
+// elements are validated against the header and its checksum, and are copied
+// into the buffer as-is.
+//
+static u08 grBufLoadFileBin(char *argName, u08 format, u16 maxElements,
+  char *fileName, u08 *fileData, off_t fileSize, emuGrBuf_t *emuGrBuf)
+{
+  u08 formatBytes;
+  u16 count;
+  u32 checksum;
+
+  // Validate the header
+  if (fileData[4] != format)
+  {
+    printf("%s? binary data format mismatch\n", argName);
+    return CMD_RET_ERROR;
+  }
+  if (fileData[5] != GRAPH_RAW && fileData[5] != GRAPH_IMAGE &&
+      fileData[5] != GRAPH_SPRITE)
+  {
+    printf("%s? binary data type invalid\n", argName);
+    return CMD_RET_ERROR;
+  }
+  if (format == ELM_BYTE)
+    formatBytes = sizeof(uint8_t);
+  else if (format == ELM_WORD)
+    formatBytes = sizeof(uint16_t);
+  else
+    formatBytes = sizeof(uint32_t);
+  count = fileData[10] | (u16)fileData[11] << 8;
+  checksum = fileData[12] | (u32)fileData[13] << 8 |
+    (u32)fileData[14] << 16 | (u32)fileData[15] << 24;
+  if (count == 0 ||
+      fileSize != GRAPH_BIN_HDR_BYTES + (off_t)count * formatBytes)
+  {
+    printf("%s? binary data size mismatch\n", argName);
+    return CMD_RET_ERROR;
+  }
+  if ((u32)count * formatBytes > GRAPH_BUF_BYTES)
+  {
+    printf("buffer overflow at element %d\n", GRAPH_BUF_BYTES / formatBytes);
+    return CMD_RET_ERROR;
+  }
+  if (grBufChecksum(fileData + GRAPH_BIN_HDR_BYTES, count * formatBytes) !=
+      checksum)
+  {
+    printf("%s? binary data checksum error\n", argName);
+    return CMD_RET_ERROR;
+  }
+
+  // Copy the data elements, up to the max number requested
+  if (maxElements > 0 && count > maxElements)
+    count = maxElements;
+  emuGrBuf->bufData = malloc(count * formatBytes);
+  memcpy(emuGrBuf->bufData, fileData + GRAPH_BIN_HDR_BYTES,
+    count * formatBytes);
+
+  // Administer metadata from the header
+  emuGrBuf->bufType = fileData[5];
+  if (emuGrBuf->bufType == GRAPH_IMAGE)
+  {
+    emuGrBuf->bufImgWidth = fileData[6];
+    emuGrBuf->bufImgHeight = fileData[7];
+    emuGrBuf->bufImgFrames = fileData[8];
+  }
+  else if (emuGrBuf->bufType == GRAPH_SPRITE)
+  {
+    emuGrBuf->bufSprWidth = fileData[6];
+    emuGrBuf->bufSprHeight = fileData[7];
+    emuGrBuf->bufSprFrames = fileData[8];
+  }
+  emuGrBuf->bufOrigin = malloc(strlen(fileName) + 1);
+  strcpy(emuGrBuf->bufOrigin, fileName);
+  emuGrBuf->bufElmFormat = format;
+  emuGrBuf->bufElmByteSize = formatBytes;
+  emuGrBuf->bufElmBitSize = formatBytes * 8;
+  emuGrBuf->bufElmCount = count;
+  emuGrBuf->bufCreate = time(NULL);
+
+  return CMD_RET_OK;
+}
+
+//
+// Function: grBufLoadFileText
+//
+// Load graphics buffer with data from a text file
+//
+static u08 grBufLoadFileText(char *argName, u08 format, u16 maxElements,
+  u32 maxBytes, char *fileName, emuGrBuf_t *emuGrBuf)
 {
   FILE *fp;
   u16 count = 0;
   u16 readCount = 0;
   unsigned int bufVal;
   int scanRetVal;
-  u08 format;
   u08 formatBytes;
   u08 formatBits;
 
-  // Setup for loading graphics data
-  grBufReset(emuGrBuf);
-  format = emuFormatGet(formatName, &formatBytes, &formatBits);
+  // Get the data element size
+  if (format == ELM_BYTE)
+    formatBytes = sizeof(uint8_t);
+  else if (format == ELM_WORD)
+    formatBytes = sizeof(uint16_t);
+  else
+    formatBytes = sizeof(uint32_t);
+  formatBits = formatBytes * 8;
 
-  // Open graphics data file
+  // Open text graphics data file
   fp = fopen(fileName, "r");
   if (fp == NULL)
   {
@@ -1447,7 +2378,7 @@ u08 grBufLoadFile(char *argName, char formatName, u16 maxElements,
   while (scanRetVal == 1)
   {
     // Check on buffer overflow
-    if (count * formatBytes >= GRAPH_BUF_BYTES)
+    if ((u32)count * formatBytes >= maxBytes)
     {
       printf("buffer overflow at element %d\n", count);
       fclose(fp);
@@ -1511,6 +2442,255 @@ u08 grBufLoadFile(char *argName, char formatName, u16 maxElements,
   return CMD_RET_OK;
 }
 
+
+//
+// Function: grBufPaintAnim
+//
+// Paint a sprite animation frame from a graphics buffer. When the frame
+// directly follows the last painted frame at the same position and in the
+// same draw color, the lcd has not been written to since, and the frame is a
+// delta, only the lcd bytes that change are written. Otherwise the frame is
+// decoded from its preceding keyframe and is painted in full.
+//
+void grBufPaintAnim(u08 x, u08 y, u08 frame, emuGrBuf_t *emuGrBuf)
+{
+  emuGrAnim_t *anim = emuGrBuf->bufAnim;
+  u08 *animData = (u08 *)emuGrBuf->bufData;
+  u08 width = emuGrBuf->bufSprWidth;
+  u08 height = emuGrBuf->bufSprHeight;
+  u08 format = emuGrBuf->bufElmFormat;
+  u08 elmBytes = emuGrBuf->bufElmByteSize;
+  u08 color = glcdColorGet();
+  u08 offset = y % 8;
+  u08 yByte = y / 8;
+  u08 rows = (offset + height + 7) / 8;
+  u16 pos;
+  u16 keyPos = 0;
+  u08 keyFrame = 0;
+  uint64_t elm;
+  uint64_t delta;
+  u08 row;
+  u08 mask;
+  u08 lcdByte;
+  s16 cursor;
+  u08 col;
+  u08 start;
+  u08 count;
+  u08 i;
+  u08 j;
+
+  // Create the animation state upon first use
+  if (anim == NULL)
+  {
+    anim = malloc(sizeof(emuGrAnim_t));
+    anim->frameData = malloc(width * elmBytes);
+    anim->decoded = MC_FALSE;
+    anim->painted = MC_FALSE;
+    emuGrBuf->bufAnim = anim;
+  }
+
+  // Paint a frame in full when we cannot step to it, including when the lcd
+  // may no longer show the last painted frame
+  if (anim->painted == MC_FALSE || anim->frame + 1 != frame ||
+      anim->x != x || anim->y != y || anim->color != color ||
+      anim->lcdWrites != grBufAnimLcdWritesGet() ||
+      animData[anim->nextPos] != GRAPH_ANIM_DELTA)
+  {
+    // Find the keyframe preceding the frame
+    pos = 0;
+    for (i = 0; i <= frame; i++)
+    {
+      if (animData[pos] == GRAPH_ANIM_KEY)
+      {
+        keyFrame = i;
+        keyPos = pos;
+      }
+      if (i < frame)
+        pos = grBufAnimFrameApply(emuGrBuf, pos, NULL);
+    }
+
+    // Decode from the keyframe unless the decoded frame gets us there faster
+    if (anim->decoded == MC_FALSE || anim->frame < keyFrame ||
+        anim->frame > frame)
+    {
+      anim->nextPos = grBufAnimFrameApply(emuGrBuf, keyPos, anim->frameData);
+      anim->frame = keyFrame;
+      anim->decoded = MC_TRUE;
+    }
+    while (anim->frame < frame)
+    {
+      anim->nextPos = grBufAnimFrameApply(emuGrBuf, anim->nextPos,
+        anim->frameData);
+      anim->frame++;
+    }
+
+    // Paint the decoded frame
+    glcdBitmap(x, y, 0, 0, width, height, format, DATA_RAM, anim->frameData);
+    anim->painted = MC_TRUE;
+    anim->x = x;
+    anim->y = y;
+    anim->color = color;
+    anim->lcdWrites = grBufAnimLcdWritesGet();
+    return;
+  }
+
+  // Step to the next frame by painting only the changed lcd bytes of the
+  // delta runs
+  pos = anim->nextPos + 1;
+  col = 0;
+  while (col < width)
+  {
+    col = col + animData[pos];
+    count = animData[pos + 1];
+    pos = pos + 2;
+    start = col;
+
+    // Paint the changed lcd bytes of the run row by row, while keeping
+    // consecutive lcd byte writes
+    for (row = 0; row < rows; row++)
+    {
+      mask = 0xff;
+      if (row == 0)
+        mask = mask << offset;
+      if (row == rows - 1 && (offset + height) % 8 != 0)
+        mask = mask & (0xff >> (8 - (offset + height) % 8));
+      cursor = -1;
+      for (i = 0; i < count; i++)
+      {
+        delta = 0;
+        for (j = 0; j < elmBytes; j++)
+          delta = delta |
+            ((uint64_t)animData[pos + i * elmBytes + j] << (j * 8));
+        if ((u08)((delta << offset) >> (row * 8)) == 0)
+        {
+          cursor = -1;
+          continue;
+        }
+        elm = grBufElmGet(anim->frameData, format, start + i) ^ delta;
+        lcdByte = (u08)((elm << offset) >> (row * 8));
+        if (color == GLCD_OFF)
+          lcdByte = ~lcdByte;
+        if (mask != 0xff)
+        {
+          glcdSetAddress(x + start + i, yByte + row);
+          glcdDataRead();
+          lcdByte = (glcdDataRead() & ~mask) | (lcdByte & mask);
+          cursor = -1;
+        }
+        if (cursor != start + i)
+          glcdSetAddress(x + start + i, yByte + row);
+        glcdDataWrite(lcdByte);
+        cursor = start + i + 1;
+      }
+    }
+
+    // Apply the run on the decoded frame
+    for (i = 0; i < count; i++)
+    {
+      delta = 0;
+      for (j = 0; j < elmBytes; j++)
+        delta = delta | ((uint64_t)animData[pos + j] << (j * 8));
+      grBufElmSet(anim->frameData, format, col,
+        grBufElmGet(anim->frameData, format, col) ^ (uint32_t)delta);
+      pos = pos + elmBytes;
+      col++;
+    }
+  }
+  anim->nextPos = pos;
+  anim->frame = frame;
+  anim->lcdWrites = grBufAnimLcdWritesGet();
+}
+
+//
+// Function: grBufPaintLcd
+//
+// Paint an image or sprite frame from a graphics buffer using its lcd byte
+// aligned data, that is created upon first use. Full lcd bytes are written
+// as-is and only the partial top and bottom lcd bytes are merged with the
+// current lcd contents.
+//
+void grBufPaintLcd(u08 x, u08 y, u08 frame, emuGrBuf_t *emuGrBuf)
+{
+  u08 lcdBuffer[GLCD_XPIXELS];
+  u08 *lcdData;
+  u32 frameBytes = 0;
+  u32 offsetBytes = 0;
+  u08 offset = y % 8;
+  u08 yByte = y / 8;
+  u08 width;
+  u08 height;
+  u08 rows;
+  u08 row;
+  u08 mask;
+  u08 merge;
+  u08 color = glcdColorGet();
+  u08 i;
+
+  // Get the frame size
+  if (emuGrBuf->bufType == GRAPH_IMAGE)
+  {
+    width = emuGrBuf->bufImgWidth;
+    height = emuGrBuf->bufImgHeight;
+  }
+  else // GRAPH_SPRITE
+  {
+    width = emuGrBuf->bufSprWidth;
+    height = emuGrBuf->bufSprHeight;
+  }
+
+  // Locate the lcd data for the frame and y offset
+  if (emuGrBuf->bufLcdData == NULL)
+    grBufLcdCreate(emuGrBuf);
+  for (i = 0; i < 8; i++)
+  {
+    if (i == offset)
+      offsetBytes = frameBytes;
+    frameBytes = frameBytes + (i + height + 7) / 8 * width;
+  }
+  lcdData = emuGrBuf->bufLcdData + frame * frameBytes + offsetBytes;
+
+  // Paint the lcd data row by row
+  rows = (offset + height + 7) / 8;
+  for (row = 0; row < rows; row++)
+  {
+    // Create a mask for the bits to paint in the lcd bytes of this row
+    mask = 0xff;
+    if (row == 0)
+      mask = mask << offset;
+    if (row == rows - 1 && (offset + height) % 8 != 0)
+      mask = mask & (0xff >> (8 - (offset + height) % 8));
+
+    // In case we partly update lcd bytes get current lcd data, using a dummy
+    // read on the first read and upon switching between controllers
+    if (mask != 0xff)
+    {
+      for (i = 0; i < width; i++)
+      {
+        if (i == 0 || ((i + x) & GLCD_CONTROLLER_XPIXMASK) == 0)
+        {
+          glcdSetAddress(i + x, yByte + row);
+          glcdDataRead();
+        }
+        lcdBuffer[i] = glcdDataRead();
+      }
+    }
+
+    // Write consecutive lcd bytes
+    glcdSetAddress(x, yByte + row);
+    for (i = 0; i < width; i++)
+    {
+      merge = lcdData[i];
+      if (color == GLCD_OFF)
+        merge = ~merge;
+      if (mask == 0xff)
+        glcdDataWrite(merge);
+      else
+        glcdDataWrite((lcdBuffer[i] & ~mask) | (merge & mask));
+    }
+    lcdData = lcdData + width;
+  }
+}
+
 //
 // Function: grBufReset
 //
@@ -1523,6 +2703,13 @@ void grBufReset(emuGrBuf_t *emuGrBuf)
     free(emuGrBuf->bufOrigin);
   if (emuGrBuf->bufData != NULL)
     free(emuGrBuf->bufData);
+  if (emuGrBuf->bufLcdData != NULL)
+    free(emuGrBuf->bufLcdData);
+  if (emuGrBuf->bufAnim != NULL)
+  {
+    free(emuGrBuf->bufAnim->frameData);
+    free(emuGrBuf->bufAnim);
+  }
   grBufInit(emuGrBuf);
 }
 
@@ -1611,6 +2798,61 @@ u08 grBufSaveFile(char *argName, u08 lineElements, char *fileName,
   return CMD_RET_OK;
 }
 
+//
+// Function: grBufSaveFileBin
+//
+// Save graphics buffer data in a binary file
+//
+u08 grBufSaveFileBin(char *argName, char *fileName, emuGrBuf_t *emuGrBuf)
+{
+  FILE *fp;
+  u08 header[GRAPH_BIN_HDR_BYTES];
+  u32 size = emuGrBuf->bufElmCount * emuGrBuf->bufElmByteSize;
+  u32 checksum = grBufChecksum(emuGrBuf->bufData, size);
+
+  // Build the header
+  memset(header, 0, GRAPH_BIN_HDR_BYTES);
+  memcpy(header, GRAPH_BIN_MAGIC, 4);
+  header[4] = emuGrBuf->bufElmFormat;
+  header[5] = emuGrBuf->bufType;
+  if (emuGrBuf->bufType == GRAPH_IMAGE)
+  {
+    header[6] = emuGrBuf->bufImgWidth;
+    header[7] = emuGrBuf->bufImgHeight;
+    header[8] = emuGrBuf->bufImgFrames;
+  }
+  else if (emuGrBuf->bufType == GRAPH_SPRITE)
+  {
+    header[6] = emuGrBuf->bufSprWidth;
+    header[7] = emuGrBuf->bufSprHeight;
+    header[8] = emuGrBuf->bufSprFrames;
+  }
+  header[10] = (u08)emuGrBuf->bufElmCount;
+  header[11] = (u08)(emuGrBuf->bufElmCount >> 8);
+  header[12] = (u08)checksum;
+  header[13] = (u08)(checksum >> 8);
+  header[14] = (u08)(checksum >> 16);
+  header[15] = (u08)(checksum >> 24);
+
+  // Rewrite binary graphics data file with header and data elements
+  fp = fopen(fileName, "wb");
+  if (fp == NULL)
+  {
+    printf("%s? cannot open data file \"%s\"\n", argName, fileName);
+    return CMD_RET_ERROR;
+  }
+  if (fwrite(header, 1, GRAPH_BIN_HDR_BYTES, fp) != GRAPH_BIN_HDR_BYTES ||
+      fwrite(emuGrBuf->bufData, 1, size, fp) != size)
+  {
+    printf("%s? write error in data file \"%s\"\n", argName, fileName);
+    fclose(fp);
+    return CMD_RET_ERROR;
+  }
+  fclose(fp);
+
+  return CMD_RET_OK;
+}
+
 //
 // Function: waitDelay
 //
@@ -1619,34 +2861,50 @@ u08 grBufSaveFile(char *argName, u08 lineElements, char *fileName,
 char waitDelay(int delay)
 {
   char ch = '\0';
-  struct timeval tvNow;
-  struct timeval tvEnd;
+  struct timespec tsNow;
+  struct timespec tsEnd;
   suseconds_t timeDiff;
-  struct timespec timeSleep = { 0, 250000000 };
-  struct timespec timeRem = { 0, 0 };
+  suseconds_t timeSleep = 250000;
   u08 myKbMode = KB_MODE_LINE;
+  u08 sources = REACT_NONE;
 
   // Set offset for wait period
-  gettimeofday(&tvNow, NULL);
-  gettimeofday(&tvEnd, NULL);
+  stubClockGet(&tsNow);
+  tsEnd = tsNow;
 
   // Set end timestamp based current time plus delay and get diff in time
-  tvEnd.tv_usec = tvEnd.tv_usec + delay * 1000;
-  timeDiff = TIMEDIFF_USEC(tvEnd, tvNow);
+  tsEnd.tv_sec = tsEnd.tv_sec + delay / 1000;
+  tsEnd.tv_nsec = tsEnd.tv_nsec + (long)(delay % 1000) * 1000000;
+  if (tsEnd.tv_nsec >= 1000000000)
+  {
+    tsEnd.tv_sec++;
+    tsEnd.tv_nsec = tsEnd.tv_nsec - 1000000000;
+  }
+  timeDiff = TIMESPECDIFF_USEC(tsEnd, tsNow);
 
   // Switch to keyboard scan mode if needed
   myKbMode = kbModeGet();
   if (myKbMode == KB_MODE_LINE)
     kbModeSet(KB_MODE_SCAN);
 
-  // Wait till end of delay or a 'q' keypress and ignore a remaining wait time
-  // that is less than 0.5 msec
-  while (ch != 'q' && timeDiff > 500)
+  // In real time sleep till end of delay or a 'q' keypress, where the reactor
+  // wakes us up on any keypress
+  while (stubTimeWarpGet() == TIME_WARP_REAL && ch != 'q' && timeDiff > 500 &&
+      (sources & REACT_TIMER) == 0)
+  {
+    sources = reactorWait(&tsEnd);
+    if ((sources & REACT_KEY) != 0)
+      ch = kbKeypressScan(MC_TRUE);
+  }
+
+  // In virtual time wait till end of delay or a 'q' keypress and ignore a
+  // remaining wait time that is less than 0.5 msec
+  while (stubTimeWarpGet() != TIME_WARP_REAL && ch != 'q' && timeDiff > 500)
   {
     // Split time to delay up in parts of max 250 msec
     if (timeDiff < 250000)
-      timeSleep.tv_nsec = timeDiff * 1000;
-    nanosleep(&timeSleep, &timeRem);
+      timeSleep = timeDiff;
+    stubTimeWait(timeSleep);
 
     // Scan keyboard
     ch = kbKeypressScan(MC_TRUE);
@@ -1654,8 +2912,8 @@ char waitDelay(int delay)
       break;
 
     // Based on last wait and keypress delays get time left to wait
-    gettimeofday(&tvNow, NULL);
-    timeDiff = TIMEDIFF_USEC(tvEnd, tvNow);
+    stubClockGet(&tsNow);
+    timeDiff = TIMESPECDIFF_USEC(tsEnd, tsNow);
   }
 
   // Return to line mode if needed
@@ -1696,8 +2954,8 @@ char waitKeypress(u08 allowQuit)
   fflush(stdout);
   while (ch == '\0')
   {
-    // Sleep 150 msec and scan keyboard
-    waitSleep(150);
+    // Sleep until a keypress and scan keyboard
+    reactorWait(NULL);
     ch = kbKeypressScan(MC_TRUE);
   }
 
@@ -1732,21 +2990,31 @@ void waitSleep(int sleep)
 // allowing a 'q' keypress interrupt. Restart the timer when timer has already
 // expired upon entering this function or has expired after the remaining timer
 // period. When pressing the 'q' key the timer will not be restarted.
+// The timer runs on the monotonic emulator clock, and without a 'q' keypress
+// interrupt it sleeps until its absolute deadline. As the deadline becomes the
+// next timer offset, wakeup latencies do not accumulate into drift.
 // (Optional) return parameter remaining will indicate the remaining timer time
 // in usec upon entering this function, or -1 in case the timer had already
 // expired.
 //
-char waitTimerExpiry(struct timeval *tvTimer, int expiry, u08 allowQuit,
+char waitTimerExpiry(struct timespec *tsTimer, int expiry, u08 allowQuit,
   suseconds_t *remaining)
 {
   char ch = '\0';
-  struct timeval tvNow;
-  struct timespec timeSleep;
+  struct timespec tsNow;
+  struct timespec tsDeadline;
   suseconds_t timeDiff;
 
-  // Get the total time to wait based on timer expiry
-  gettimeofday(&tvNow, NULL);
-  timeDiff = TIMEDIFF_USEC(*tvTimer, tvNow) + expiry * 1000;
+  // Get the timer deadline and the total time to wait for it
+  tsDeadline.tv_sec = tsTimer->tv_sec + expiry / 1000;
+  tsDeadline.tv_nsec = tsTimer->tv_nsec + (long)(expiry % 1000) * 1000000;
+  if (tsDeadline.tv_nsec >= 1000000000)
+  {
+    tsDeadline.tv_sec++;
+    tsDeadline.tv_nsec = tsDeadline.tv_nsec - 1000000000;
+  }
+  stubClockGet(&tsNow);
+  timeDiff = TIMESPECDIFF_USEC(tsDeadline, tsNow);
 
   // See if timer has already expired
   if (timeDiff < 0)
@@ -1755,11 +3023,12 @@ char waitTimerExpiry(struct timeval *tvTimer, int expiry, u08 allowQuit,
     // attempt to compensate
     if (remaining != NULL)
       *remaining = -1;
-    *tvTimer = tvNow;
+    *tsTimer = tsNow;
   }
   else
   {
     // Wait the remaining time of the timer, defaulting to at least 1 msec
+    // when allowing a keypress interrupt
     if (remaining != NULL)
       *remaining = timeDiff;
     if (allowQuit == MC_TRUE)
@@ -1771,23 +3040,12 @@ char waitTimerExpiry(struct timeval *tvTimer, int expiry, u08 allowQuit,
     }
     else
     {
-      timeSleep.tv_sec = timeDiff / 1E6;
-      timeSleep.tv_nsec = (timeDiff % (int)1E6) * 1000;
-      nanosleep(&timeSleep, NULL);
+      stubClockWait(&tsDeadline);
     }
 
-    // Get next timer offset by adding expiry to current timer offset
+    // The deadline is the next timer offset
     if (ch != 'q')
-    {
-      // Add expiry to current timer offset
-      tvTimer->tv_sec = tvTimer->tv_sec + expiry / 1000;
-      tvTimer->tv_usec = tvTimer->tv_usec + (expiry % 1000) * 1000;
-      if (tvTimer->tv_usec > 1E6)
-      {
-        tvTimer->tv_sec++;
-        tvTimer->tv_usec = tvTimer->tv_usec - 1E6;
-      }
-    }
+      *tsTimer = tsDeadline;
   }
 
   return ch;
@@ -1798,8 +3056,8 @@ char waitTimerExpiry(struct timeval *tvTimer, int expiry, u08 allowQuit,
 //
 // (Re)set wait timer to current time
 //
-void waitTimerStart(struct timeval *tvTimer)
+void waitTimerStart(struct timespec *tsTimer)
 {
-  // Set timer to current timestamp
-  gettimeofday(tvTimer, NULL);
+  // Set timer to current (virtual) monotonic timestamp
+  stubClockGet(tsTimer);
 }
@@ -30,22 +30,53 @@
 #define GRAPH_RAW	1	// Free format use of graphics data
 #define GRAPH_IMAGE	2	// Single image with size (x,y) over z frames
 #define GRAPH_SPRITE	3	// Sprite image with size (x,y) with z frames
+#define GRAPH_ANIM	4	// Sprite frames stored as keyframes and deltas
+
+// The max number of sprite animation frames
+#define GRAPH_ANIM_FRAMES	128
+
+// The graphics data buffer file cache result
+#define GRAPH_CACHE_NONE	0	// Not loaded from file
+#define GRAPH_CACHE_MISS	1	// Loaded from file
+#define GRAPH_CACHE_HIT		2	// Loaded from file cache
 
 // Get time diff between two timestamps in usec
 #define TIMEDIFF_USEC(a,b)	\
   (((a).tv_sec - (b).tv_sec) * 1E6 + (a).tv_usec - (b).tv_usec)
+#define TIMESPECDIFF_USEC(a,b)	\
+  (((a).tv_sec - (b).tv_sec) * 1E6 + ((a).tv_nsec - (b).tv_nsec) / 1E3)
 
 // Definition of a structure to hold the main() arguments
 typedef struct _emuArgcArgv_t
 {
+  int argBatch;			// argv index for batch job arg
   int argDebug;			// argv index for logfile arg
+  int argFormat;		// argv index for batch output format arg
   int argGlutGeometry;		// argv index for glut geometry arg
   int argGlutPosition;		// argv index for glut window pos arg
+  int argImage;			// argv index for render image folder arg
+  int argJobs;			// argv index for render workers arg
   int argLcdType;		// argv index for lcd device arg
+  int argOutput;		// argv index for batch output file arg
   int argTty;			// argv index for ncurses tty arg
   ctrlDeviceArgs_t ctrlDeviceArgs; // Processed args for lcd stub interface
 } emuArgcArgv_t;
 
+// Definition of a structure holding the decode and paint state of a sprite
+// animation graphics buffer
+typedef struct _emuGrAnim_t
+{
+  void *frameData;		// Decoded frame elements (malloc-ed)
+  u16 nextPos;			// Data offset of frame after decoded frame
+  u08 frame;			// Decoded frame
+  u08 decoded;			// Whether a frame is decoded
+  u08 painted;			// Whether decoded frame is painted last
+  u08 x;			// Painted frame x position
+  u08 y;			// Painted frame y position
+  u08 color;			// Painted frame draw color
+  long long lcdWrites;		// Lcd writes after painting frame
+} emuGrAnim_t;
+
 // Definition of a structure holding a graphics buffer and its metadata
 typedef struct _emuGrBuf_t
 {
@@ -63,6 +94,12 @@ typedef struct _emuGrBuf_t
   u08 bufSprWidth;		// Sprite: sprite width
   u08 bufSprHeight;		// Sprite: sprite height
   u08 bufSprFrames;		// Sprite: sprite frames
+  u08 bufCache;			// File cache result: none, miss, hit
+  u08 *bufLcdData;		// Lcd byte aligned image/sprite frames (malloc-ed)
+  u32 bufLcdBytes;		// Size of lcd byte aligned data in bytes
+  u16 bufAnimBytes;		// Animation: size of keyframe and delta data
+  u08 bufAnimKeys;		// Animation: max frames between keyframes
+  emuGrAnim_t *bufAnim;		// Animation: decode/paint state (malloc-ed)
 } emuGrBuf_t;
 
 // mchron command argument translation functions
@@ -75,6 +112,7 @@ u08 emuStartModeGet(char startId);
 
 // mchron environment functions
 u08 emuArgcArgvGet(int argc, char *argv[], emuArgcArgv_t *emuArgcArgv);
+u08 emuBatchRun(char *argv[], emuArgcArgv_t *emuArgcArgv);
 u08 emuConfigCreate(void);
 void emuCoreDump(u08 origin, const char *location, int arg1, int arg2,
   int arg3, int arg4);
@@ -82,6 +120,7 @@ void emuSigSetup(void);
 void emuShutdown(void);
 
 // mchron interpreter support functions
+char *emuClockDescGet(int clock);
 void emuClockPoolCleanup(clockDriver_t *clockDriver);
 clockDriver_t *emuClockPoolInit(int *count);
 void emuClockPrint(void);
@@ -104,11 +143,13 @@ void emuCmdPromptSet(char *prompt);
 char waitDelay(int delay);
 char waitKeypress(u08 allowQuit);
 void waitSleep(int sleep);
-char waitTimerExpiry(struct timeval *tvTimer, int expiry, u08 allowQuit,
+char waitTimerExpiry(struct timespec *tsTimer, int expiry, u08 allowQuit,
   suseconds_t *remaining);
-void waitTimerStart(struct timeval *tvTimer);
+void waitTimerStart(struct timespec *tsTimer);
 
 // mchron graphics buffer data functions
+u08 grBufAnimCreate(char *argName, u08 keyFrames, emuGrBuf_t *emuGrBuf);
+void grBufCacheReset(void);
 u08 grBufCopy(emuGrBuf_t *emuGrBufFrom, emuGrBuf_t *emuGrBufTo);
 void grBufInfoPrint(emuGrBuf_t *emuGrBuf);
 void grBufInit(emuGrBuf_t *emuGrBuf);
@@ -116,7 +157,12 @@ void grBufLoadCtrl(u08 x, u08 y, u08 width, u08 height, char formatName,
   emuGrBuf_t *emuGrBuf);
 u08 grBufLoadFile(char *argName, char formatName, u16 maxElements,
   char *fileName, emuGrBuf_t *emuGrBuf);
+u08 grBufLoadFileAnim(char *argName, char formatName, char *fileName,
+  emuGrBuf_t *emuGrBuf);
+void grBufPaintAnim(u08 x, u08 y, u08 frame, emuGrBuf_t *emuGrBuf);
+void grBufPaintLcd(u08 x, u08 y, u08 frame, emuGrBuf_t *emuGrBuf);
 void grBufReset(emuGrBuf_t *emuGrBuf);
 u08 grBufSaveFile(char *argName, u08 lineElements, char *fileName,
   emuGrBuf_t *emuGrBuf);
+u08 grBufSaveFileBin(char *argName, char *fileName, emuGrBuf_t *emuGrBuf);
 #endif
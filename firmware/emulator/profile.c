@@ -0,0 +1,359 @@
+//*****************************************************************************
+// Filename : 'profile.c'
+// Title    : Clock cycle budget profiler for emuchron emulator
+//*****************************************************************************
+
+// Everything we need for running this thing in Linux
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Monochron and emuchron defines
+#include "../global.h"
+#include "../monomain.h"
+#include "controller.h"
+#include "mchronutil.h"
+#include "profile.h"
+
+//
+// A Monochron clock cycle method must complete within the animation tick
+// cycle of 75 msec. The profiler models the Monochron hardware time of each
+// clock cycle, split into:
+// - Clock logic: The host cpu time spent in the clock cycle method, including
+//   the recompose of its sprites, multiplied by the host-to-Monochron cpu
+//   speed scale factor. The host time spent in the emulated lcd controllers
+//   is measured separately and is left out, as is the estimated overhead of
+//   measuring it.
+// - Glcd work: The number of glcd byte reads/writes and cursor address sets
+//   made by the clock cycle method times an estimate of the Monochron cpu
+//   cycles spent in the ks0108 layer per access.
+// - Controller: The number of lcd controller accesses for these glcd accesses
+//   times the Monochron cpu cycles per lcd controller access, being the
+//   controller busy wait and enable pulse on the lcd data bus.
+// Monochron has no lcd frame buffer, so when it is switched on in mchron its
+// byte and address accesses are modelled as glcd and controller accesses, and
+// the controller traffic of its diff flush is ignored.
+// Per clock a histogram of the modelled clock cycle time is kept, in buckets
+// of 10% of the cycle budget. A cycle exceeding the cycle budget is flagged.
+//
+
+// The Monochron cpu speed and modelled cpu cycles per glcd/controller access
+#define PROF_CPU_MHZ		8
+#define PROF_CYCLES_GLCD	24	// Cpu cycles per glcd access
+#define PROF_CYCLES_CTRL	64	// Cpu cycles per controller access
+#define PROF_ACCESS_ADDRESS	2	// Controller accesses per address set
+
+// The clock cycle budget and its histogram buckets
+#define PROF_BUDGET_USEC	(ANIM_TICK_CYCLE_MS * 1000)
+#define PROF_BUCKETS		11	// 10% per bucket, last is over budget
+
+// The max number of profiled clocks in the mchron clock pool
+#define PROF_CLOCKS		64
+
+// Definition of a structure holding the profile of a single clock cycle
+typedef struct _profCycle_t
+{
+  double logic;				// Clock logic time (usec)
+  double glcd;				// Glcd work time (usec)
+  double ctrl;				// Controller access time (usec)
+} profCycle_t;
+
+// Definition of a structure holding the aggregated profile of a clock
+typedef struct _profClock_t
+{
+  long long cycles;			// Profiled clock cycles
+  long long over;			// Cycles exceeding cycle budget
+  profCycle_t total;			// Total time of all cycles
+  profCycle_t max;			// Split time of the max cycle
+  double maxTime;			// Max cycle time (usec)
+  u08 maxTH, maxTM, maxTS;		// Clock time of the max cycle
+  long long hist[PROF_BUCKETS];		// Cycle time histogram
+} profClock_t;
+
+// Monochron defined data
+extern volatile rtcDateTime_t rtcDateTimeNext;
+extern volatile uint8_t mcMchronClock;
+
+// The aggregated profile per clock and the last profiled clock cycle
+static profClock_t profClocks[PROF_CLOCKS];
+static profCycle_t profCycleLast;
+static u08 profCycleLastValid = MC_FALSE;
+
+// The host-to-Monochron cpu speed scale factor
+static u16 profScale = PROF_SCALE_DEFAULT;
+
+// The clock cycle start data
+static struct timespec tsBegin;
+static struct timespec tsLcd;
+static ctrlGlcdStats_t glcdStatsBegin;
+static ctrlGlcdStats_t glcdStatsLcd;
+
+// The host time spent in the emulated lcd controllers in the clock logic of
+// a clock cycle, and the host time of a single time measurement (nsec)
+static u08 profEmuActive = MC_FALSE;
+static struct timespec tsEmu;
+static long long profEmuNsec = 0;
+static long long profEmuCount = 0;
+static double profEmuCost = 0;
+
+// Local function prototypes
+static long long profCtrlAccessGet(ctrlGlcdStats_t *glcdStats);
+static void profEmuCostGet(void);
+static long long profGlcdAccessGet(ctrlGlcdStats_t *glcdStats);
+
+//
+// Function: profCtrlAccessGet
+//
+// Get the number of lcd controller accesses Monochron makes for the glcd
+// byte reads/writes and cursor address sets, either on the lcd or in the lcd
+// frame buffer
+//
+static long long profCtrlAccessGet(ctrlGlcdStats_t *glcdStats)
+{
+  return glcdStats->dataRead + glcdStats->dataWrite + glcdStats->frameRead +
+    glcdStats->frameWrite + (glcdStats->addressSet + glcdStats->frameAddress) *
+    PROF_ACCESS_ADDRESS;
+}
+
+//
+// Function: profCycleBegin
+//
+// Mark the start of a clock cycle
+//
+void profCycleBegin(void)
+{
+  ctrlStats_t ctrlStats;
+
+  if (profEmuCost == 0)
+    profEmuCostGet();
+  ctrlStatsGet(&glcdStatsBegin, &ctrlStats);
+  profEmuNsec = 0;
+  profEmuCount = 0;
+  profEmuActive = MC_TRUE;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tsBegin);
+}
+
+//
+// Function: profCycleEnd
+//
+// Mark the end of a clock cycle after its lcd frame is written to the lcd
+// controllers, and add the modelled clock cycle time to the clock profile
+//
+void profCycleEnd(void)
+{
+  profClock_t *profClock;
+  profCycle_t *profCycle = &profCycleLast;
+  double cycleTime;
+  int bucket;
+
+  // Model the clock logic, glcd work and controller access time. Leave out
+  // the host time of the emulated lcd controllers from the clock logic. Per
+  // measurement its overhead outside the measured time is one time query.
+  profCycle->logic = TIMESPECDIFF_USEC(tsLcd, tsBegin) -
+    (profEmuNsec + profEmuCount * profEmuCost) / 1000;
+  if (profCycle->logic < 0)
+    profCycle->logic = 0;
+  profCycle->logic = profCycle->logic * profScale;
+  profCycle->glcd = (profGlcdAccessGet(&glcdStatsLcd) -
+    profGlcdAccessGet(&glcdStatsBegin)) *
+    PROF_CYCLES_GLCD / (double)PROF_CPU_MHZ;
+  profCycle->ctrl = (profCtrlAccessGet(&glcdStatsLcd) -
+    profCtrlAccessGet(&glcdStatsBegin)) *
+    PROF_CYCLES_CTRL / (double)PROF_CPU_MHZ;
+  profCycleLastValid = MC_TRUE;
+  if (mcMchronClock >= PROF_CLOCKS)
+    return;
+
+  // Add the cycle to the clock profile
+  cycleTime = profCycle->logic + profCycle->glcd + profCycle->ctrl;
+  profClock = &profClocks[mcMchronClock];
+  profClock->cycles++;
+  profClock->total.logic = profClock->total.logic + profCycle->logic;
+  profClock->total.glcd = profClock->total.glcd + profCycle->glcd;
+  profClock->total.ctrl = profClock->total.ctrl + profCycle->ctrl;
+  bucket = (int)(cycleTime * 10 / PROF_BUDGET_USEC);
+  if (bucket >= PROF_BUCKETS - 1)
+    bucket = (cycleTime > PROF_BUDGET_USEC ? PROF_BUCKETS - 1 :
+      PROF_BUCKETS - 2);
+  profClock->hist[bucket]++;
+  if (cycleTime > profClock->maxTime)
+  {
+    profClock->maxTime = cycleTime;
+    profClock->max = *profCycle;
+    profClock->maxTH = rtcDateTimeNext.timeHour;
+    profClock->maxTM = rtcDateTimeNext.timeMin;
+    profClock->maxTS = rtcDateTimeNext.timeSec;
+  }
+
+  // Flag a cycle exceeding the cycle budget
+  if (cycleTime > PROF_BUDGET_USEC)
+  {
+    profClock->over++;
+    if (DEBUGGING)
+    {
+      char msg[80];
+      sprintf(msg, "*** Cycle over budget: clock=%d, time=%.0f usec",
+        mcMchronClock, cycleTime);
+      DEBUGP(msg);
+    }
+  }
+}
+
+//
+// Function: profCycleLcd
+//
+// Mark the end of the clock logic and glcd work in a clock cycle, and the
+// start of writing its lcd frame to the lcd controllers
+//
+void profCycleLcd(void)
+{
+  ctrlStats_t ctrlStats;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tsLcd);
+  profEmuActive = MC_FALSE;
+  ctrlStatsGet(&glcdStatsLcd, &ctrlStats);
+}
+
+//
+// Function: profCyclePrint
+//
+// Print the modelled time of the last profiled clock cycle
+//
+void profCyclePrint(void)
+{
+  profCycle_t *profCycle = &profCycleLast;
+  double cycleTime;
+
+  if (profCycleLastValid == MC_FALSE)
+    return;
+  cycleTime = profCycle->logic + profCycle->glcd + profCycle->ctrl;
+  printf("prof   : cycle=%.0f usec (%.0f%%), logic=%.0f, glcd=%.0f, "
+    "ctrl=%.0f usec\n", cycleTime, cycleTime * 100 / PROF_BUDGET_USEC,
+    profCycle->logic, profCycle->glcd, profCycle->ctrl);
+  if (cycleTime > PROF_BUDGET_USEC)
+    printf("*** cycle exceeds budget of %d msec\n", ANIM_TICK_CYCLE_MS);
+}
+
+//
+// Function: profEmuBegin
+//
+// Mark the start of processing an lcd controller access in the emulator
+//
+void profEmuBegin(void)
+{
+  if (profEmuActive == MC_TRUE)
+    clock_gettime(CLOCK_MONOTONIC, &tsEmu);
+}
+
+//
+// Function: profEmuCostGet
+//
+// Get the host time of a single time query used to measure the emulator
+// lcd controller processing time
+//
+static void profEmuCostGet(void)
+{
+  struct timespec tsStart;
+  struct timespec tsEnd;
+  struct timespec ts;
+  int i;
+
+  clock_gettime(CLOCK_MONOTONIC, &tsStart);
+  for (i = 0; i < 1000; i++)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+  clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+  // The usec duration of 1000 queries equals the nsec duration of one query
+  profEmuCost = TIMESPECDIFF_USEC(tsEnd, tsStart);
+}
+
+//
+// Function: profEmuEnd
+//
+// Mark the end of processing an lcd controller access in the emulator
+//
+void profEmuEnd(void)
+{
+  struct timespec ts;
+
+  if (profEmuActive == MC_FALSE)
+    return;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  profEmuNsec = profEmuNsec + (ts.tv_sec - tsEmu.tv_sec) * 1000000000LL +
+    ts.tv_nsec - tsEmu.tv_nsec;
+  profEmuCount++;
+}
+
+//
+// Function: profGlcdAccessGet
+//
+// Get the number of glcd byte reads/writes and cursor address sets, either on
+// the lcd or in the lcd frame buffer
+//
+static long long profGlcdAccessGet(ctrlGlcdStats_t *glcdStats)
+{
+  return glcdStats->dataRead + glcdStats->dataWrite + glcdStats->frameRead +
+    glcdStats->frameWrite + glcdStats->addressSet + glcdStats->frameAddress;
+}
+
+//
+// Function: profPrint
+//
+// Print the modelled clock cycle profile of all profiled clocks
+//
+void profPrint(void)
+{
+  profClock_t *profClock;
+  int i;
+  int j;
+
+  printf("prof   : budget=%d msec, scale=%d, glcd=%d cycles, "
+    "ctrl=%d cycles\n", ANIM_TICK_CYCLE_MS, profScale, PROF_CYCLES_GLCD,
+    PROF_CYCLES_CTRL);
+  for (i = 0; i < PROF_CLOCKS; i++)
+  {
+    profClock = &profClocks[i];
+    if (profClock->cycles == 0)
+      continue;
+
+    // Average and max cycle time split
+    printf("clock  : %d (%s), cycles=%lld, over=%lld\n", i,
+      emuClockDescGet(i), profClock->cycles, profClock->over);
+    printf("         avg=%.0f usec, logic=%.0f, glcd=%.0f, ctrl=%.0f usec\n",
+      (profClock->total.logic + profClock->total.glcd +
+        profClock->total.ctrl) / profClock->cycles,
+      profClock->total.logic / profClock->cycles,
+      profClock->total.glcd / profClock->cycles,
+      profClock->total.ctrl / profClock->cycles);
+    printf("         max=%.0f usec, logic=%.0f, glcd=%.0f, ctrl=%.0f usec "
+      "at %02d:%02d:%02d\n", profClock->maxTime, profClock->max.logic,
+      profClock->max.glcd, profClock->max.ctrl, profClock->maxTH,
+      profClock->maxTM, profClock->maxTS);
+
+    // Cycle time histogram in buckets of 10% of the cycle budget
+    printf("         hist%%=");
+    for (j = 0; j < PROF_BUCKETS - 1; j++)
+      printf("%d:%lld ", (j + 1) * 10, profClock->hist[j]);
+    printf(">100:%lld\n", profClock->hist[PROF_BUCKETS - 1]);
+  }
+}
+
+//
+// Function: profReset
+//
+// Reset the clock cycle profiles
+//
+void profReset(void)
+{
+  memset(profClocks, 0, sizeof(profClocks));
+  profCycleLastValid = MC_FALSE;
+}
+
+//
+// Function: profScaleSet
+//
+// Set the host-to-Monochron cpu speed scale factor
+//
+void profScaleSet(u16 scale)
+{
+  profScale = scale;
+}
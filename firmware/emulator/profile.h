@@ -0,0 +1,28 @@
+//*****************************************************************************
+// Filename : 'profile.h'
+// Title    : Defines for the emuchron emulator clock cycle budget profiler
+//*****************************************************************************
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "../avrlibtypes.h"
+
+// The default host-to-Monochron cpu speed scale factor
+#define PROF_SCALE_DEFAULT	200
+
+// Clock cycle profiling hooks used by animClockDraw()
+void profCycleBegin(void);
+void profCycleEnd(void);
+void profCycleLcd(void);
+
+// Lcd controller emulation hooks used by ctrlExecute()
+void profEmuBegin(void);
+void profEmuEnd(void);
+
+// Clock cycle profile report and setup
+void profCyclePrint(void);
+void profPrint(void);
+void profReset(void);
+void profScaleSet(u16 scale);
+#endif
@@ -0,0 +1,226 @@
+//*****************************************************************************
+// Filename : 'reactor.c'
+// Title    : Input and timer event reactor for emuchron emulator
+//*****************************************************************************
+
+// Everything we need for running this thing in Linux
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+// Monochron and emuchron defines
+#include "../global.h"
+#include "reactor.h"
+
+// The max number of event sources reported in a single epoll wait
+#define REACT_EVENTS_MAX	3
+
+// This is me
+extern const char *__progname;
+
+// The epoll instance that multiplexes stdin, the glut window keypress pipe
+// and the wait deadline timer
+static int epollFd = -1;
+static int glutPipe[2] = { -1, -1 };
+static int timerFd = -1;
+
+// A regular file cannot be monitored by epoll. When stdin is a regular file
+// it is always considered to have input, similar to select().
+static u08 stdinPollable = MC_TRUE;
+
+// Indicates whether glut window keypresses are accepted as emulator input
+static volatile u08 glutKeyAccept = MC_FALSE;
+
+// Local function prototypes
+static u08 reactorPoll(int timeout);
+
+//
+// Function: reactorCleanup
+//
+// Cleanup the reactor event sources
+//
+void reactorCleanup(void)
+{
+  glutKeyAccept = MC_FALSE;
+  if (epollFd >= 0)
+    close(epollFd);
+  if (timerFd >= 0)
+    close(timerFd);
+  if (glutPipe[0] >= 0)
+  {
+    close(glutPipe[0]);
+    close(glutPipe[1]);
+  }
+  epollFd = timerFd = glutPipe[0] = glutPipe[1] = -1;
+}
+
+//
+// Function: reactorGlutKeyAccept
+//
+// Start or stop accepting glut window keypresses as emulator input. Upon
+// start any stale keypress is discarded.
+//
+void reactorGlutKeyAccept(u08 accept)
+{
+  unsigned char key;
+
+  if (accept == MC_TRUE && glutPipe[0] >= 0)
+    while (read(glutPipe[0], &key, 1) == 1);
+  glutKeyAccept = accept;
+}
+
+//
+// Function: reactorGlutKeyPut
+//
+// Forward a glut window keypress as emulator input. This function is called
+// from the glut thread.
+// Return: MC_TRUE (keypress accepted) or MC_FALSE (keypress not accepted).
+//
+u08 reactorGlutKeyPut(unsigned char key)
+{
+  if (glutKeyAccept == MC_FALSE || glutPipe[1] < 0)
+    return MC_FALSE;
+
+  // A full pipe drops the keypress
+  if (write(glutPipe[1], &key, 1) != 1)
+    return MC_FALSE;
+
+  return MC_TRUE;
+}
+
+//
+// Function: reactorInit
+//
+// Create the epoll instance with its event sources
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 reactorInit(void)
+{
+  struct epoll_event event;
+
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (epollFd < 0 || timerFd < 0 ||
+      pipe2(glutPipe, O_NONBLOCK | O_CLOEXEC) < 0)
+  {
+    printf("%s: cannot create event reactor: %s\n", __progname,
+      strerror(errno));
+    return MC_FALSE;
+  }
+
+  // Register the event sources
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.u32 = REACT_STDIN;
+  if (epoll_ctl(epollFd, EPOLL_CTL_ADD, STDIN_FILENO, &event) < 0)
+    stdinPollable = MC_FALSE;
+  event.data.u32 = REACT_GLUT;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, glutPipe[0], &event);
+  event.data.u32 = REACT_TIMER;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event);
+
+  return MC_TRUE;
+}
+
+//
+// Function: reactorKeyGet
+//
+// Get a keypress character where stdin input has precedence over glut window
+// keypresses. No keypress returns the null character.
+//
+// WARNING: Prior to using this function make sure the keyboard is set to scan
+// mode using kbModeGet()/kbModeSet().
+//
+char reactorKeyGet(void)
+{
+  unsigned char key;
+
+  if ((reactorPoll(0) & REACT_STDIN) != 0)
+    return getchar();
+  if (read(glutPipe[0], &key, 1) == 1)
+    return (char)key;
+
+  return '\0';
+}
+
+//
+// Function: reactorKeyHit
+//
+// Get keypress (if any) on stdin or in the glut window
+//
+// WARNING: Prior to using this function make sure the keyboard is set to scan
+// mode using kbModeGet()/kbModeSet().
+//
+u08 reactorKeyHit(void)
+{
+  if ((reactorPoll(0) & REACT_KEY) != 0)
+    return MC_TRUE;
+
+  return MC_FALSE;
+}
+
+//
+// Function: reactorPoll
+//
+// Wait for events with a timeout (in msec, -1 = infinite) and return the
+// event sources that have them
+//
+static u08 reactorPoll(int timeout)
+{
+  struct epoll_event events[REACT_EVENTS_MAX];
+  u08 sources = REACT_NONE;
+  int count;
+  int i;
+
+  // Stdin as regular file always has input
+  if (stdinPollable == MC_FALSE)
+  {
+    sources = REACT_STDIN;
+    timeout = 0;
+  }
+
+  // An interrupted epoll wait is restarted
+  do
+  {
+    count = epoll_wait(epollFd, events, REACT_EVENTS_MAX, timeout);
+  } while (count < 0 && errno == EINTR);
+
+  for (i = 0; i < count; i++)
+    sources = sources | events[i].data.u32;
+
+  return sources;
+}
+
+//
+// Function: reactorWait
+//
+// Sleep until a keypress on stdin or in the glut window, or until an absolute
+// deadline on the monotonic clock has passed. Without a deadline only a
+// keypress ends the wait. Returns the event sources that ended the wait.
+//
+u08 reactorWait(struct timespec *deadline)
+{
+  struct itimerspec timerSpec;
+  uint64_t expiry;
+  u08 sources = REACT_NONE;
+
+  // (Re)arm or disarm the deadline timer, also clearing a pending expiry
+  memset(&timerSpec, 0, sizeof(timerSpec));
+  if (deadline != NULL)
+    timerSpec.it_value = *deadline;
+  timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &timerSpec, NULL);
+
+  // Sleep until an event source wakes us up
+  while (sources == REACT_NONE)
+    sources = reactorPoll(-1);
+  if ((sources & REACT_TIMER) != 0)
+    read(timerFd, &expiry, sizeof(expiry));
+
+  return sources;
+}
@@ -0,0 +1,31 @@
+//*****************************************************************************
+// Filename : 'reactor.h'
+// Title    : Defines for the emuchron emulator input and timer event reactor
+//*****************************************************************************
+
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <time.h>
+#include "../avrlibtypes.h"
+
+// The reactor event sources that end a reactor wait
+#define REACT_NONE		0x00	// Interrupted by a signal
+#define REACT_STDIN		0x01	// Keyboard input on stdin
+#define REACT_GLUT		0x02	// Keypress in glut lcd window
+#define REACT_TIMER		0x04	// Wait deadline timer expiry
+#define REACT_KEY		(REACT_STDIN | REACT_GLUT)
+
+// Reactor setup and cleanup
+void reactorCleanup(void);
+u08 reactorInit(void);
+
+// Keypress events from the keyboard and glut lcd window
+void reactorGlutKeyAccept(u08 accept);
+u08 reactorGlutKeyPut(unsigned char key);
+char reactorKeyGet(void);
+u08 reactorKeyHit(void);
+
+// Wait for a keypress event or an (optional) monotonic clock deadline
+u08 reactorWait(struct timespec *deadline);
+#endif
@@ -0,0 +1,597 @@
+//*****************************************************************************
+// Filename : 'render.c'
+// Title    : Parallel clock frame renderer for emuchron emulator
+//*****************************************************************************
+
+// Everything we need for running this thing in Linux
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+// Monochron and emuchron defines
+#include "../global.h"
+#include "../anim.h"
+#include "../monomain.h"
+#include "stub.h"
+#include "mchronutil.h"
+#include "render.h"
+
+//
+// The render batch draws a frame for each combination of a set of clocks and
+// a set of times of day, and reports a hash of each frame. Optionally each
+// frame is also written to a pbm image file.
+// In golden mode each frame is compared with its golden frame, being a pbm
+// image file as created earlier by a render batch. The difference is reported
+// as the number of different pixels and their bounding box. When a frame
+// differs from its golden frame a side-by-side pbm image file is written with
+// the golden frame, the rendered frame and the different pixels.
+// Rendering a frame is done in a forked worker process, with a configurable
+// max number of workers running in parallel. As each worker starts from the
+// identical mchron process state, each worker has its own private copy of the
+// emulated lcd controllers, Monochron clock state and emulator time. This
+// makes the rendered frame of a clock at a specific time independent of any
+// other frame rendered before it, and of the number of workers used.
+// A frame is rendered like command 'cs' would do: the clock is initialized
+// and its first clock cycles are generated. The time warp factor is set to
+// max so no emulator time elapses while rendering a frame.
+//
+// The worker results are collected in a shared memory array, after which the
+// results are written in clock and time order.
+//
+
+// The frame render status of a clock and time
+#define RENDER_PENDING		0	// Not rendered (or worker failed)
+#define RENDER_OK		1	// Frame rendered (identical to golden)
+#define RENDER_IMG_FAIL		2	// Frame rendered but image write failed
+#define RENDER_DIFF		3	// Frame differs from golden frame
+#define RENDER_NO_GOLDEN	4	// Golden frame not found or invalid
+
+// The whitespace between frames in a side-by-side pbm image
+#define RENDER_DIFF_GAP		8
+#define RENDER_DIFF_XPIXELS	(GLCD_XPIXELS * 3 + RENDER_DIFF_GAP * 2)
+
+// The number of times of day (in hhmm format)
+#define RENDER_TIMES		2400
+
+// The FNV-1a 64-bit hash parameters
+#define RENDER_FNV_BASIS	0xcbf29ce484222325ULL
+#define RENDER_FNV_PRIME	0x100000001b3ULL
+
+// Definition of a structure holding the render result of a clock and time
+typedef struct _renderResult_t
+{
+  u64 hash;				// Frame hash
+  u08 clock;				// Clock number
+  u16 time;				// Time of day in hhmm format
+  u08 status;				// Frame render status
+  renderDiff_t diff;			// Difference with golden frame
+} renderResult_t;
+
+// Monochron defined data
+extern volatile uint8_t mcMchronClock;
+extern clockDriver_t *mcClockPool;
+
+// This is me
+extern const char *__progname;
+
+// Local function prototypes
+static u08 renderListParse(char *list, int min, int max, u08 *select);
+static void renderPair(renderResult_t *result, u08 mode, char *imageDir);
+
+//
+// Function: renderBatch
+//
+// Render the clock frames as specified in the render batch job specification,
+// using a max number of worker processes. The spec is either NULL (all clocks
+// for all minutes of the day) or "<clocks>[:<times>]", where each is a comma
+// separated list of values or value ranges, e.g. "2,8-10:0000-0059,1200".
+// In golden mode the image folder holds the golden frames.
+// Return: MC_TRUE (success) or MC_FALSE (failure or frame differences).
+//
+u08 renderBatch(char *spec, int clockCount, FILE *fp, u08 format, u08 mode,
+  int jobs, char *imageDir)
+{
+  u08 clockSelect[clockCount];
+  u08 timeSelect[RENDER_TIMES];
+  char *specCopy = NULL;
+  char *timeSpec = NULL;
+  renderResult_t *results;
+  renderResult_t *result;
+  int clock, hhmm;
+  int times = 0;
+  int clocks = 0;
+  int pairs = 0;
+  int active = 0;
+  int failed = 0;
+  int diffs = 0;
+  int missing = 0;
+  int i;
+  pid_t pid;
+  struct timespec tsStart, tsEnd;
+  u08 success = MC_TRUE;
+
+  // Get the clocks and times to render. By default this is every clock,
+  // except for the performance test clock, for every minute of the day.
+  memset(clockSelect, 0, sizeof(clockSelect));
+  memset(timeSelect, 0, sizeof(timeSelect));
+  if (spec != NULL)
+  {
+    specCopy = malloc(strlen(spec) + 1);
+    strcpy(specCopy, spec);
+    timeSpec = strchr(specCopy, ':');
+    if (timeSpec != NULL)
+    {
+      *timeSpec = '\0';
+      timeSpec++;
+    }
+    success = renderListParse(specCopy, 1, clockCount - 1, clockSelect);
+  }
+  else
+  {
+    memset(&clockSelect[1], 1, clockCount - 1);
+  }
+  if (success == MC_TRUE && timeSpec != NULL)
+    success = renderListParse(timeSpec, 0, RENDER_TIMES - 1, timeSelect);
+  else if (success == MC_TRUE)
+    memset(timeSelect, 1, sizeof(timeSelect));
+  free(specCopy);
+  if (success == MC_FALSE)
+  {
+    printf("%s: -b: invalid render specification %s\n", __progname, spec);
+    return MC_FALSE;
+  }
+  for (i = 1; i < clockCount; i++)
+  {
+    if (mcClockPool[i].clockId == CHRON_PERFTEST && clockSelect[i] == 1)
+    {
+      if (spec != NULL)
+      {
+        printf("%s: -b: cannot render clock %d\n", __progname, i);
+        return MC_FALSE;
+      }
+      clockSelect[i] = 0;
+    }
+  }
+
+  // Build the list of clock and time pairs to render in a shared memory
+  // array, so the worker processes can report their results in it. A time
+  // that is not a valid time of day is ignored.
+  for (hhmm = 0; hhmm < RENDER_TIMES; hhmm++)
+  {
+    if (hhmm % 100 >= 60)
+      timeSelect[hhmm] = 0;
+    times = times + timeSelect[hhmm];
+  }
+  for (clock = 0; clock < clockCount; clock++)
+    clocks = clocks + clockSelect[clock];
+  pairs = clocks * times;
+  if (pairs == 0)
+  {
+    printf("%s: -b: no clock frames to render\n", __progname);
+    return MC_FALSE;
+  }
+  results = mmap(NULL, sizeof(renderResult_t) * pairs,
+    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (results == MAP_FAILED)
+  {
+    printf("%s: -b: cannot allocate render results\n", __progname);
+    return MC_FALSE;
+  }
+  result = results;
+  for (clock = 0; clock < clockCount; clock++)
+  {
+    for (hhmm = 0; hhmm < RENDER_TIMES && clockSelect[clock] == 1; hhmm++)
+    {
+      if (timeSelect[hhmm] == 0)
+        continue;
+      result->hash = 0;
+      result->clock = clock;
+      result->time = hhmm;
+      result->status = RENDER_PENDING;
+      memset(&result->diff, 0, sizeof(renderDiff_t));
+      result++;
+    }
+  }
+  printf("render : %d clocks, %d times, %d frames, %d workers\n", clocks,
+    times, pairs, jobs);
+
+  // Render the frames in worker processes. A worker must not flush stdio
+  // buffers inherited from mchron, so flush them before forking.
+  clock_gettime(CLOCK_MONOTONIC, &tsStart);
+  stubTimeWarpSet(TIME_WARP_MAX);
+  fflush(stdout);
+  fflush(fp);
+  for (i = 0; i < pairs; i++)
+  {
+    // Wait for a worker to end when all workers are busy
+    if (active == jobs)
+    {
+      wait(NULL);
+      active--;
+    }
+
+    pid = fork();
+    if (pid == 0)
+    {
+      renderPair(&results[i], mode, imageDir);
+      _exit(0);
+    }
+    else if (pid < 0)
+    {
+      // Failure to fork: try again after the next worker ends
+      if (active == 0)
+        break;
+      wait(NULL);
+      active--;
+      i--;
+      continue;
+    }
+    active++;
+  }
+  while (active > 0)
+  {
+    wait(NULL);
+    active--;
+  }
+  stubTimeWarpSet(TIME_WARP_REAL);
+  clock_gettime(CLOCK_MONOTONIC, &tsEnd);
+
+  // Write the render results
+  if (format == RENDER_FORMAT_CSV)
+    fprintf(fp, "clock,time,status,hash,pixels,xMin,yMin,xMax,yMax\n");
+  else
+    fprintf(fp, "[");
+  for (i = 0; i < pairs; i++)
+  {
+    char *status;
+
+    result = &results[i];
+    if (result->status == RENDER_OK)
+    {
+      status = "ok";
+    }
+    else if (result->status == RENDER_DIFF)
+    {
+      status = "diff";
+      diffs++;
+    }
+    else if (result->status == RENDER_NO_GOLDEN)
+    {
+      status = "nogolden";
+      missing++;
+    }
+    else
+    {
+      if (result->status == RENDER_IMG_FAIL)
+        status = "imagefail";
+      else
+        status = "failed";
+      failed++;
+    }
+    if (format == RENDER_FORMAT_CSV)
+      fprintf(fp, "%d,%02d:%02d,%s,%016llx,%d,%d,%d,%d,%d\n", result->clock,
+        result->time / 100, result->time % 100, status,
+        (unsigned long long)result->hash, result->diff.pixels,
+        result->diff.xMin, result->diff.yMin, result->diff.xMax,
+        result->diff.yMax);
+    else
+      fprintf(fp, "%s\n  {\"clock\": %d, \"time\": \"%02d:%02d\", "
+        "\"status\": \"%s\", \"hash\": \"%016llx\", \"pixels\": %d, "
+        "\"box\": [%d, %d, %d, %d]}", i == 0 ? "" : ",", result->clock,
+        result->time / 100, result->time % 100, status,
+        (unsigned long long)result->hash, result->diff.pixels,
+        result->diff.xMin, result->diff.yMin, result->diff.xMax,
+        result->diff.yMax);
+  }
+  if (format == RENDER_FORMAT_JSON)
+    fprintf(fp, "\n]\n");
+  fflush(fp);
+  munmap(results, sizeof(renderResult_t) * pairs);
+
+  printf("elapsed: %ld msec, failed: %d\n",
+    (long)(TIMESPECDIFF_USEC(tsEnd, tsStart) / 1000), failed);
+  if (mode == RENDER_MODE_GOLDEN)
+    printf("golden : %d ok, %d diff, %d missing\n",
+      pairs - diffs - missing - failed, diffs, missing);
+
+  if (failed > 0 || diffs > 0 || missing > 0)
+    return MC_FALSE;
+  return MC_TRUE;
+}
+
+//
+// Function: renderFrameDiff
+//
+// Get the number of different pixels between two lcd frames and their
+// bounding box. When there are no differences the bounding box is all zero.
+// Return: The number of different pixels.
+//
+u16 renderFrameDiff(ctrlLcdImage_t frame1, ctrlLcdImage_t frame2,
+  renderDiff_t *diff)
+{
+  u08 x, y;
+  u08 data;
+  u08 yMin, yMax;
+
+  diff->pixels = 0;
+  diff->xMin = GLCD_XPIXELS - 1;
+  diff->yMin = GLCD_YPIXELS - 1;
+  diff->xMax = 0;
+  diff->yMax = 0;
+
+  // Compare the frames an lcd byte at a time
+  for (x = 0; x < GLCD_XPIXELS; x++)
+  {
+    for (y = 0; y < GLCD_CONTROLLER_YPAGES; y++)
+    {
+      data = frame1[x][y] ^ frame2[x][y];
+      if (data == 0)
+        continue;
+
+      // Add the different pixels in the lcd byte, where lcd byte bit 0 is the
+      // top pixel
+      diff->pixels = diff->pixels + __builtin_popcount(data);
+      yMin = y * 8 + __builtin_ctz(data);
+      yMax = y * 8 + 7 - (__builtin_clz(data) - 24);
+      if (x < diff->xMin)
+        diff->xMin = x;
+      if (x > diff->xMax)
+        diff->xMax = x;
+      if (yMin < diff->yMin)
+        diff->yMin = yMin;
+      if (yMax > diff->yMax)
+        diff->yMax = yMax;
+    }
+  }
+  if (diff->pixels == 0)
+    memset(diff, 0, sizeof(renderDiff_t));
+
+  return diff->pixels;
+}
+
+//
+// Function: renderFrameDiffWrite
+//
+// Write a side-by-side binary pbm image file with a golden frame, a rendered
+// frame and their different pixels
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 renderFrameDiffWrite(char *fileName, ctrlLcdImage_t golden,
+  ctrlLcdImage_t frame)
+{
+  FILE *fp;
+  u08 row[(RENDER_DIFF_XPIXELS + 7) / 8];
+  u08 x, y;
+  u08 mask;
+  u16 pos;
+
+  fp = fopen(fileName, "w");
+  if (fp == NULL)
+    return MC_FALSE;
+
+  fprintf(fp, "P4\n%d %d\n", RENDER_DIFF_XPIXELS, GLCD_YPIXELS);
+  for (y = 0; y < GLCD_YPIXELS; y++)
+  {
+    memset(row, 0, sizeof(row));
+    mask = 0x1 << (y & 0x7);
+    for (x = 0; x < GLCD_XPIXELS; x++)
+    {
+      if ((golden[x][y >> 3] & mask) != 0)
+        row[x >> 3] |= (0x80 >> (x & 0x7));
+      pos = x + GLCD_XPIXELS + RENDER_DIFF_GAP;
+      if ((frame[x][y >> 3] & mask) != 0)
+        row[pos >> 3] |= (0x80 >> (pos & 0x7));
+      pos = pos + GLCD_XPIXELS + RENDER_DIFF_GAP;
+      if (((golden[x][y >> 3] ^ frame[x][y >> 3]) & mask) != 0)
+        row[pos >> 3] |= (0x80 >> (pos & 0x7));
+    }
+    fwrite(row, 1, sizeof(row), fp);
+  }
+
+  if (fclose(fp) != 0)
+    return MC_FALSE;
+  return MC_TRUE;
+}
+
+//
+// Function: renderFrameHash
+//
+// Get the FNV-1a 64-bit hash of an lcd frame
+//
+u64 renderFrameHash(ctrlLcdImage_t frame)
+{
+  u08 *data = (u08 *)frame;
+  u64 hash = RENDER_FNV_BASIS;
+  u16 i;
+
+  for (i = 0; i < sizeof(ctrlLcdImage_t); i++)
+  {
+    hash = hash ^ data[i];
+    hash = hash * RENDER_FNV_PRIME;
+  }
+
+  return hash;
+}
+
+//
+// Function: renderFramePbmRead
+//
+// Read an lcd frame from a binary pbm image file as written by
+// renderFramePbmWrite()
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 renderFramePbmRead(char *fileName, ctrlLcdImage_t frame)
+{
+  FILE *fp;
+  u08 row[GLCD_XPIXELS / 8];
+  u08 x, y;
+  int width = 0;
+  int height = 0;
+  u08 success = MC_TRUE;
+
+  fp = fopen(fileName, "r");
+  if (fp == NULL)
+    return MC_FALSE;
+
+  // Verify the header, which is followed by a single whitespace character
+  if (fscanf(fp, "P4 %d %d", &width, &height) != 2 ||
+      width != GLCD_XPIXELS || height != GLCD_YPIXELS || fgetc(fp) == EOF)
+    success = MC_FALSE;
+
+  // Get the pbm rows and map them onto the lcd bytes
+  memset(frame, 0, sizeof(ctrlLcdImage_t));
+  for (y = 0; y < GLCD_YPIXELS && success == MC_TRUE; y++)
+  {
+    if (fread(row, 1, sizeof(row), fp) != sizeof(row))
+    {
+      success = MC_FALSE;
+      break;
+    }
+    for (x = 0; x < GLCD_XPIXELS; x++)
+      if ((row[x >> 3] & (0x80 >> (x & 0x7))) != 0)
+        frame[x][y >> 3] |= (0x1 << (y & 0x7));
+  }
+
+  fclose(fp);
+  return success;
+}
+
+//
+// Function: renderFramePbmWrite
+//
+// Write an lcd frame to a binary pbm image file
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 renderFramePbmWrite(char *fileName, ctrlLcdImage_t frame)
+{
+  FILE *fp;
+  u08 row[GLCD_XPIXELS / 8];
+  u08 x, y;
+
+  fp = fopen(fileName, "w");
+  if (fp == NULL)
+    return MC_FALSE;
+
+  // A pbm row is a sequence of bytes with 8 horizontal pixels each, msb first
+  fprintf(fp, "P4\n%d %d\n", GLCD_XPIXELS, GLCD_YPIXELS);
+  for (y = 0; y < GLCD_YPIXELS; y++)
+  {
+    memset(row, 0, sizeof(row));
+    for (x = 0; x < GLCD_XPIXELS; x++)
+      if ((frame[x][y >> 3] & (0x1 << (y & 0x7))) != 0)
+        row[x >> 3] |= (0x80 >> (x & 0x7));
+    fwrite(row, 1, sizeof(row), fp);
+  }
+
+  if (fclose(fp) != 0)
+    return MC_FALSE;
+  return MC_TRUE;
+}
+
+//
+// Function: renderListParse
+//
+// Mark the values in a comma separated list of values and value ranges (for
+// example "1,4-6,9") in a selection array
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+static u08 renderListParse(char *list, int min, int max, u08 *select)
+{
+  char *item = list;
+  char *end;
+  long from, to;
+
+  while (MC_TRUE)
+  {
+    // Get a single value or a value range
+    from = strtol(item, &end, 10);
+    if (end == item)
+      return MC_FALSE;
+    to = from;
+    if (*end == '-')
+    {
+      item = end + 1;
+      to = strtol(item, &end, 10);
+      if (end == item)
+        return MC_FALSE;
+    }
+    if (from < min || to > max || from > to)
+      return MC_FALSE;
+    memset(&select[from], 1, to - from + 1);
+
+    // Get the next list item
+    if (*end == '\0')
+      break;
+    if (*end != ',')
+      return MC_FALSE;
+    item = end + 1;
+  }
+
+  return MC_TRUE;
+}
+
+//
+// Function: renderPair
+//
+// Render the frame of a clock at a time of day in a worker process. The frame
+// is drawn like command 'cs' would do. Depending on the mode, (optionally)
+// write the frame image, or compare the frame with its golden frame.
+//
+static void renderPair(renderResult_t *result, u08 mode, char *imageDir)
+{
+  ctrlLcdImage_t frame;
+  ctrlLcdImage_t golden;
+  char *fileName;
+
+  // Set the time and draw the clock
+  stubTimeSet(0, result->time % 100, result->time / 100, RENDER_DATE_DAY,
+    RENDER_DATE_MON, RENDER_DATE_YEAR);
+  rtcMchronTimeInit();
+  mcMchronClock = result->clock;
+  almStateSet();
+  animClockDraw(DRAW_INIT_FULL);
+  emuClockUpdate();
+
+  // Get the frame hash
+  ctrlLcdImageGet(frame);
+  result->hash = renderFrameHash(frame);
+  if (imageDir == NULL)
+  {
+    result->status = RENDER_OK;
+    return;
+  }
+
+  // Write the frame image or compare it with the golden frame
+  fileName = malloc(strlen(imageDir) + 24);
+  sprintf(fileName, "%s/clock%02d-%04d.pbm", imageDir, result->clock,
+    result->time);
+  if (mode == RENDER_MODE_HASH)
+  {
+    if (renderFramePbmWrite(fileName, frame) == MC_FALSE)
+      result->status = RENDER_IMG_FAIL;
+    else
+      result->status = RENDER_OK;
+  }
+  else if (renderFramePbmRead(fileName, golden) == MC_FALSE)
+  {
+    result->status = RENDER_NO_GOLDEN;
+  }
+  else if (renderFrameDiff(golden, frame, &result->diff) == 0)
+  {
+    result->status = RENDER_OK;
+  }
+  else
+  {
+    sprintf(fileName, "%s/clock%02d-%04d-diff.pbm", imageDir, result->clock,
+      result->time);
+    if (renderFrameDiffWrite(fileName, golden, frame) == MC_FALSE)
+      result->status = RENDER_IMG_FAIL;
+    else
+      result->status = RENDER_DIFF;
+  }
+  free(fileName);
+}
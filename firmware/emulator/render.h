@@ -0,0 +1,48 @@
+//*****************************************************************************
+// Filename : 'render.h'
+// Title    : Defines for the emuchron emulator parallel clock frame renderer
+//*****************************************************************************
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdio.h>
+#include "../avrlibtypes.h"
+#include "controller.h"
+
+// The render batch output formats
+#define RENDER_FORMAT_CSV	0
+#define RENDER_FORMAT_JSON	1
+
+// The render batch modes
+#define RENDER_MODE_HASH	0	// Report frame hash
+#define RENDER_MODE_GOLDEN	1	// Compare frame with golden frame
+
+// The fixed date used for rendering clock frames (01/01/2025)
+#define RENDER_DATE_DAY		1
+#define RENDER_DATE_MON		1
+#define RENDER_DATE_YEAR	25
+
+// Definition of a structure holding the difference between two lcd frames
+typedef struct _renderDiff_t
+{
+  u16 pixels;				// Number of different pixels
+  u08 xMin;				// Bounding box left of different pixels
+  u08 yMin;				// Bounding box top of different pixels
+  u08 xMax;				// Bounding box right of different pixels
+  u08 yMax;				// Bounding box bottom of different pixels
+} renderDiff_t;
+
+// Render clock frames for a set of clocks and times in worker processes
+u08 renderBatch(char *spec, int clockCount, FILE *fp, u08 format, u08 mode,
+  int jobs, char *imageDir);
+
+// Lcd frame compare, hash and image file methods
+u16 renderFrameDiff(ctrlLcdImage_t frame1, ctrlLcdImage_t frame2,
+  renderDiff_t *diff);
+u08 renderFrameDiffWrite(char *fileName, ctrlLcdImage_t golden,
+  ctrlLcdImage_t frame);
+u64 renderFrameHash(ctrlLcdImage_t frame);
+u08 renderFramePbmRead(char *fileName, ctrlLcdImage_t frame);
+u08 renderFramePbmWrite(char *fileName, ctrlLcdImage_t frame);
+#endif
@@ -11,7 +11,10 @@
 #include <termios.h>
 #include <time.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/select.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <signal.h>
@@ -25,6 +28,8 @@
 #include "controller.h"
 #include "listutil.h"
 #include "mchronutil.h"
+#include "profile.h"
+#include "reactor.h"
 #include "scanutil.h"
 #include "stub.h"
 
@@ -82,9 +87,32 @@
 #define CYCLE_REQ_NOWAIT	3
 #define CYCLE_REQ_WAIT		4
 
+// Cycle wakeup lateness histogram size and its bucket width (usec)
+#define LATE_BUCKETS		1000
+#define LATE_BUCKET_USEC	10
+
 // Debug output buffer size
 #define DEBUG_BUFSIZE		100
 
+// Event log file identification and event record types
+#define EVLOG_MAGIC		"MCEVLOG1"
+#define EVLOG_MAGIC_LEN		8
+#define EVLOG_EV_END		'e'	// End of session
+#define EVLOG_EV_KEY		'k'	// Keypress in run mode
+#define EVLOG_EV_KEY_WAIT	'w'	// Keypress in single cycle mode
+#define EVLOG_EV_RTC		't'	// Changed RTC time read
+#define EVLOG_EV_START		's'	// Monochron RTC time at session start
+#define EVLOG_RTC_LEN		6
+
+// An event log record
+typedef struct _evLogRec_t
+{
+  u32 cycle;			// Event engine cycle number
+  u08 type;			// Event record type
+  u08 index;			// RTC read index in cycle
+  u08 data[EVLOG_RTC_LEN];	// Keypress char or (bcd) RTC time
+} evLogRec_t;
+
 // Emulator event engine keypress overview
 #define EMU_KEYS_CLOCK		\
   "<run: info = e/p/r/t, hardware = a/s/+, c = cycle, h = help, q = quit> "
@@ -150,8 +178,16 @@ static u08 debugNew = MC_TRUE;
 static u08 hold = MC_FALSE;
 static char lastChar = '\0';
 
-// Stubbed eeprom data. An atmega328p has 1 KB of eeprom.
-static uint8_t stubEeprom[EE_SIZE];
+// Stubbed eeprom data. An atmega328p has 1 KB of eeprom. The eeprom is
+// memory mapped from a file in the mchron config folder so its contents are
+// persisted without explicit save. When the file cannot be mapped the eeprom
+// falls back to an in-memory copy that is lost upon exit. For each eeprom
+// address the number of writes is counted to find wear-heavy write patterns.
+static uint8_t stubEepromMem[EE_SIZE];
+static uint8_t *stubEeprom = stubEepromMem;
+static long long eepWrites[EE_SIZE];
+static long long eepWriteTotal = 0;
+static long long eepWriteChange = 0;
 
 // Stubbed alarm play pid
 static pid_t alarmPid = -1;
@@ -169,14 +205,31 @@ static u08 eventCfgTimeout = MC_TRUE;
 static u08 eventQuitReq = MC_FALSE;
 static u08 eventInit = MC_TRUE;
 
+// Event log data for recording or replaying an event engine session
+static FILE *evLogFp = NULL;
+static u08 evLogArm = EVLOG_NONE;
+static u08 evLogMode = EVLOG_NONE;
+static u32 evLogCycle = 0;
+static u32 evLogCount = 0;
+static u08 evLogRtcIdx = 0;
+static u08 evLogRtcValid = MC_FALSE;
+static u08 evLogRtc[EVLOG_RTC_LEN];
+static evLogRec_t evLogNext;
+
 // Date/time and timer statistics data
 static double timeDelta = 0L;
-static struct timeval tvCycleTimer;
+static time_t rtcCacheSec = -1;
+static u08 rtcCacheBcd[EVLOG_RTC_LEN];
+static int timeWarp = TIME_WARP_REAL;
+static struct timeval tvVirtual;
+static struct timespec tsCycleTimer;
 static int inTimeCount = 0;
 static int outTimeCount = 0;
 static int singleCycleCount = 0;
 static long long waitTotal = 0;
 static int minSleep = ANIM_TICK_CYCLE_MS + 1;
+static int lateHist[LATE_BUCKETS];
+static suseconds_t lateMax = 0;
 
 // Terminal settings for stdin keypress mode data
 static struct termios termOld, termNew;
@@ -185,9 +238,16 @@ static u08 kbMode = KB_MODE_LINE;
 // Local function prototypes
 static void alarmPidStart(void);
 static void alarmPidStop(void);
-static int kbHit(void);
+static void evLogClose(void);
+static char evLogGetchar(void);
+static int evLogKbHit(void);
+static char evLogKeyGet(u08 type);
+static void evLogRead(void);
+static void evLogSessionStart(void);
+static void evLogWrite(u08 type, u08 index, u08 *data, u08 length);
 static void stubHelpClockFeed(void);
 static void stubHelpMonochron(void);
+static int stubLatePercentile(int percentile);
 
 //
 // Function: alarmPidStart
@@ -362,9 +422,184 @@ void eeprom_write_byte(uint8_t *eprombyte, uint8_t value)
 {
   if ((size_t)eprombyte >= EE_SIZE)
     emuCoreDump(CD_EEPROM, __func__, (int)(size_t)eprombyte, 0, 0, 0);
+
+  // Like the avr eeprom_write_byte() a write is done even when the value
+  // does not change, so count it as such
+  eepWrites[(size_t)eprombyte]++;
+  eepWriteTotal++;
+  if (stubEeprom[(size_t)eprombyte] != value)
+    eepWriteChange++;
   stubEeprom[(size_t)eprombyte] = value;
 }
 
+//
+// Function: evLogClose
+//
+// Close the event log of an event engine session and report on it
+//
+static void evLogClose(void)
+{
+  if (evLogMode == EVLOG_RECORD)
+  {
+    evLogWrite(EVLOG_EV_END, 0, NULL, 0);
+    printf("event log: recorded %lu cycles, %lu events\n",
+      (unsigned long)evLogCycle, (unsigned long)evLogCount);
+  }
+  else if (evLogMode == EVLOG_REPLAY)
+  {
+    printf("event log: replayed %lu cycles, %lu events\n",
+      (unsigned long)evLogCycle, (unsigned long)evLogCount);
+  }
+
+  if (evLogFp != NULL && evLogMode != EVLOG_NONE)
+  {
+    fclose(evLogFp);
+    evLogFp = NULL;
+  }
+  evLogMode = EVLOG_NONE;
+}
+
+//
+// Function: evLogGetchar
+//
+// Get a keyboard character in run mode. When recording a session it is
+// logged, and when replaying a session it is taken from the event log.
+//
+static char evLogGetchar(void)
+{
+  char ch;
+
+  if (evLogMode == EVLOG_REPLAY)
+    return evLogKeyGet(EVLOG_EV_KEY);
+
+  ch = reactorKeyGet();
+  if (evLogMode == EVLOG_RECORD)
+    evLogWrite(EVLOG_EV_KEY, 0, (u08 *)&ch, 1);
+
+  return ch;
+}
+
+//
+// Function: evLogKbHit
+//
+// Get keypress (if any) in run mode. When replaying a session it is a
+// pending keypress in the event log for the current cycle.
+//
+static int evLogKbHit(void)
+{
+  if (evLogMode == EVLOG_REPLAY)
+    return (evLogNext.type == EVLOG_EV_KEY && evLogNext.cycle == evLogCycle);
+
+  return reactorKeyHit();
+}
+
+//
+// Function: evLogKeyGet
+//
+// Get the keypress of the requested type for the current cycle from the
+// event log. No such keypress returns the null character.
+//
+static char evLogKeyGet(u08 type)
+{
+  char ch = '\0';
+
+  if (evLogNext.type == type && evLogNext.cycle == evLogCycle)
+  {
+    ch = (char)evLogNext.data[0];
+    evLogCount++;
+    evLogRead();
+  }
+
+  return ch;
+}
+
+//
+// Function: evLogRead
+//
+// Read the next event log record. A truncated or corrupt event log ends the
+// replayed session.
+//
+static void evLogRead(void)
+{
+  u08 valid;
+
+  memset(&evLogNext, 0, sizeof(evLogRec_t));
+  valid = (fread(&evLogNext.cycle, sizeof(u32), 1, evLogFp) == 1 &&
+    fread(&evLogNext.type, 1, 1, evLogFp) == 1);
+  if (valid == MC_TRUE)
+  {
+    if (evLogNext.type == EVLOG_EV_KEY || evLogNext.type == EVLOG_EV_KEY_WAIT)
+      valid = (fread(evLogNext.data, 1, 1, evLogFp) == 1);
+    else if (evLogNext.type == EVLOG_EV_RTC)
+      valid = (fread(&evLogNext.index, 1, 1, evLogFp) == 1 &&
+        fread(evLogNext.data, EVLOG_RTC_LEN, 1, evLogFp) == 1);
+    else if (evLogNext.type == EVLOG_EV_START)
+      valid = (fread(evLogNext.data, EVLOG_RTC_LEN, 1, evLogFp) == 1);
+    else if (evLogNext.type != EVLOG_EV_END)
+      valid = MC_FALSE;
+  }
+
+  if (valid == MC_FALSE)
+  {
+    evLogNext.type = EVLOG_EV_END;
+    evLogNext.cycle = evLogCycle;
+  }
+}
+
+//
+// Function: evLogSessionStart
+//
+// Start an event log session. The Monochron RTC time that was read prior to
+// the session determines the detection of the first RTC second change in the
+// session, so it is logged upon recording and restored upon replay.
+//
+static void evLogSessionStart(void)
+{
+  u08 rtc[EVLOG_RTC_LEN];
+
+  if (evLogMode == EVLOG_RECORD)
+  {
+    rtc[0] = rtcDateTime.timeSec;
+    rtc[1] = rtcDateTime.timeMin;
+    rtc[2] = rtcDateTime.timeHour;
+    rtc[3] = rtcDateTime.dateDay;
+    rtc[4] = rtcDateTime.dateMon;
+    rtc[5] = rtcDateTime.dateYear;
+    evLogWrite(EVLOG_EV_START, 0, rtc, EVLOG_RTC_LEN);
+  }
+  else if (evLogMode == EVLOG_REPLAY)
+  {
+    evLogRead();
+    if (evLogNext.type == EVLOG_EV_START)
+    {
+      rtcDateTime.timeSec = evLogNext.data[0];
+      rtcDateTime.timeMin = evLogNext.data[1];
+      rtcDateTime.timeHour = evLogNext.data[2];
+      rtcDateTime.dateDay = evLogNext.data[3];
+      rtcDateTime.dateMon = evLogNext.data[4];
+      rtcDateTime.dateYear = evLogNext.data[5];
+      evLogRead();
+    }
+  }
+}
+
+//
+// Function: evLogWrite
+//
+// Write a record to the event log
+//
+static void evLogWrite(u08 type, u08 index, u08 *data, u08 length)
+{
+  fwrite(&evLogCycle, sizeof(u32), 1, evLogFp);
+  fwrite(&type, 1, 1, evLogFp);
+  if (type == EVLOG_EV_RTC)
+    fwrite(&index, 1, 1, evLogFp);
+  if (length > 0)
+    fwrite(data, length, 1, evLogFp);
+  if (type != EVLOG_EV_END && type != EVLOG_EV_START)
+    evLogCount++;
+}
+
 //
 // Function: i2cMasterReceiveNI
 //
@@ -379,17 +614,57 @@ u08 i2cMasterReceiveNI(u08 deviceAddr, u08 length, u08 *data)
   struct timeval tv;
   struct tm *tm;
   time_t timeClock;
+  u08 rtc[EVLOG_RTC_LEN];
 
-  gettimeofday(&tv, NULL);
-  timeClock = tv.tv_sec + timeDelta;
-  tm = localtime(&timeClock);
+  if (evLogMode == EVLOG_REPLAY)
+  {
+    // Take the RTC time from the event log when it changed at this read
+    if (evLogNext.type == EVLOG_EV_RTC && evLogNext.cycle == evLogCycle &&
+        evLogNext.index == evLogRtcIdx)
+    {
+      memcpy(evLogRtc, evLogNext.data, EVLOG_RTC_LEN);
+      evLogCount++;
+      evLogRead();
+    }
+    memcpy(rtc, evLogRtc, EVLOG_RTC_LEN);
+  }
+  else
+  {
+    // Only convert the emulator time into RTC time when the emulator time
+    // moved to another second since the previous read or when the time delta
+    // changed, as localtime() is expensive
+    stubTimeGet(&tv);
+    if (tv.tv_sec != rtcCacheSec)
+    {
+      timeClock = tv.tv_sec + timeDelta;
+      tm = localtime(&timeClock);
+      rtcCacheBcd[0] = bcdEncode(tm->tm_sec);
+      rtcCacheBcd[1] = bcdEncode(tm->tm_min);
+      rtcCacheBcd[2] = bcdEncode(tm->tm_hour);
+      rtcCacheBcd[3] = bcdEncode(tm->tm_mday);
+      rtcCacheBcd[4] = bcdEncode(tm->tm_mon + 1);
+      rtcCacheBcd[5] = bcdEncode(tm->tm_year % 100);
+      rtcCacheSec = tv.tv_sec;
+    }
+    memcpy(rtc, rtcCacheBcd, EVLOG_RTC_LEN);
 
-  data[0] = bcdEncode(tm->tm_sec);
-  data[1] = bcdEncode(tm->tm_min);
-  data[2] = bcdEncode(tm->tm_hour);
-  data[4] = bcdEncode(tm->tm_mday);
-  data[5] = bcdEncode(tm->tm_mon + 1);
-  data[6] = bcdEncode(tm->tm_year % 100);
+    // Only log the RTC time when it differs from the previous read
+    if (evLogMode == EVLOG_RECORD && (evLogRtcValid == MC_FALSE ||
+        memcmp(rtc, evLogRtc, EVLOG_RTC_LEN) != 0))
+    {
+      memcpy(evLogRtc, rtc, EVLOG_RTC_LEN);
+      evLogRtcValid = MC_TRUE;
+      evLogWrite(EVLOG_EV_RTC, evLogRtcIdx, rtc, EVLOG_RTC_LEN);
+    }
+  }
+  evLogRtcIdx++;
+
+  data[0] = rtc[0];
+  data[1] = rtc[1];
+  data[2] = rtc[2];
+  data[4] = rtc[3];
+  data[5] = rtc[4];
+  data[6] = rtc[5];
 
   return 0;
 }
@@ -423,33 +698,6 @@ u08 i2cMasterSendNI(u08 deviceAddr, u08 length, u08* data)
   return 0;
 }
 
-//
-// Function: kbHit
-//
-// Get keypress (if any)
-//
-// WARNING: Prior to using this function make sure the keyboard is set to scan
-// mode using kbModeGet()/kbModeSet().
-//
-static int kbHit(void)
-{
-  struct timeval tvWait;
-  fd_set rdfs;
-
-  tvWait.tv_sec = 0;
-  tvWait.tv_usec = 0;
-
-  FD_ZERO(&rdfs);
-  FD_SET(STDIN_FILENO, &rdfs);
-
-  // The keyboard scan result of an interrupted select is unreliable and will
-  // cause a false positive keyboard hit. An interrupted select will happen
-  // every now and then. Keep trying until select properly completes.
-  while (select(STDIN_FILENO + 1, &rdfs, NULL, NULL, &tvWait) < 0);
-
-  return FD_ISSET(STDIN_FILENO, &rdfs);
-}
-
 //
 // Function: kbKeypressScan
 //
@@ -471,9 +719,9 @@ char kbKeypressScan(u08 quitFind)
     kbModeSet(KB_MODE_SCAN);
 
   // Read pending input buffer
-  while (kbHit())
+  while (reactorKeyHit() == MC_TRUE)
   {
-    ch = getchar();
+    ch = reactorKeyGet();
     if (quitFind == MC_TRUE && (ch == 'q' || ch == 'Q'))
       quitFound = MC_TRUE;
   }
@@ -557,6 +805,115 @@ void stubBeep(uint16_t hz, uint8_t msec)
   system(shellCmd);
 }
 
+//
+// Function: stubClockGet
+//
+// Get the emulator monotonic clock time used by the wait timers. This is the
+// system monotonic clock that is not affected by wall-clock jumps or slews,
+// or when time warp is active the virtual time.
+//
+void stubClockGet(struct timespec *ts)
+{
+  if (timeWarp == TIME_WARP_REAL)
+  {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+  }
+  else
+  {
+    ts->tv_sec = tvVirtual.tv_sec;
+    ts->tv_nsec = tvVirtual.tv_usec * 1000;
+  }
+}
+
+//
+// Function: stubClockWait
+//
+// Wait until an absolute deadline on the emulator monotonic clock
+//
+void stubClockWait(struct timespec *deadline)
+{
+  struct timespec tsNow;
+  suseconds_t wait;
+
+  if (timeWarp == TIME_WARP_REAL)
+  {
+    // Resume sleeping to the same deadline when interrupted by a signal
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) ==
+        EINTR);
+  }
+  else
+  {
+    // Advance virtual time up to the deadline
+    stubClockGet(&tsNow);
+    wait = TIMESPECDIFF_USEC(*deadline, tsNow);
+    if (wait > 0)
+      stubTimeWait(wait);
+  }
+}
+
+//
+// Function: stubEepCleanup
+//
+// Unmap the persistent eeprom file
+//
+void stubEepCleanup(void)
+{
+  if (stubEeprom != stubEepromMem)
+  {
+    munmap(stubEeprom, EE_SIZE);
+    stubEeprom = stubEepromMem;
+  }
+}
+
+//
+// Function: stubEepInit
+//
+// Map the eeprom onto the persistent eeprom file in the mchron config folder.
+// A new or resized file is reset to an erased eeprom. When mapping fails use
+// an erased in-memory eeprom instead.
+//
+void stubEepInit(void)
+{
+  char *home;
+  char *fullPath;
+  struct stat fileStat;
+  void *eeprom;
+  int fd;
+
+  // Get the eeprom file in the mchron config folder
+  home = getenv("HOME");
+  if (home == NULL)
+  {
+    printf("%s: eeprom: cannot get $HOME\n", __progname);
+    stubEepReset();
+    return;
+  }
+  fullPath = malloc(strlen(home) + strlen(MCHRON_CONFIG) +
+    strlen(EEPROM_FILE) + 1);
+  sprintf(fullPath, "%s%s%s", home, MCHRON_CONFIG, EEPROM_FILE);
+
+  // Open and map the file, and size it to the eeprom size when needed
+  fd = open(fullPath, O_RDWR | O_CREAT, 0644);
+  free(fullPath);
+  if (fd < 0 || fstat(fd, &fileStat) < 0 ||
+      (fileStat.st_size != EE_SIZE && ftruncate(fd, EE_SIZE) < 0))
+    eeprom = MAP_FAILED;
+  else
+    eeprom = mmap(NULL, EE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (fd >= 0)
+    close(fd);
+  if (eeprom == MAP_FAILED)
+  {
+    printf("%s: eeprom: cannot map file \"~%s%s\", eeprom is not saved\n",
+      __progname, MCHRON_CONFIG, EEPROM_FILE);
+    stubEepReset();
+    return;
+  }
+  stubEeprom = (uint8_t *)eeprom;
+  if (fileStat.st_size != EE_SIZE)
+    stubEepReset();
+}
+
 //
 // Function: stubEepReset
 //
@@ -567,6 +924,16 @@ void stubEepReset(void)
   memset(stubEeprom, 0xff, EE_SIZE);
 }
 
+//
+// Function: stubEepWritesGet
+//
+// Get the number of writes to an eeprom address
+//
+long long stubEepWritesGet(int address)
+{
+  return eepWrites[address];
+}
+
 //
 // Function: stubEventGet
 //
@@ -579,10 +946,20 @@ char stubEventGet(u08 stats)
   char ch = '\0';
   uint8_t keypress = MC_FALSE;
   suseconds_t remaining;
+  suseconds_t late;
+  struct timespec tsNow;
 
   // Flush the lcd device
   ctrlLcdFlush();
 
+  // Next event log cycle. When replaying a session, quit when passing its
+  // end.
+  evLogCycle++;
+  evLogRtcIdx = 0;
+  if (evLogMode == EVLOG_REPLAY && evLogNext.type == EVLOG_EV_END &&
+      evLogCycle > evLogNext.cycle)
+    eventQuitReq = MC_TRUE;
+
   // Detect cascading quit from Monochron config page
   if (eventQuitReq == MC_TRUE)
     return 'q';
@@ -596,13 +973,13 @@ char stubEventGet(u08 stats)
   {
     // The first entry may not invoke a sleep but instead marks the timer
     // timestamp for the next cycle
-    waitTimerStart(&tvCycleTimer);
+    waitTimerStart(&tsCycleTimer);
     eventInit = MC_FALSE;
   }
-  else
+  else if (evLogMode != EVLOG_REPLAY)
   {
     // Wait remaining time for cycle while detecting timer expiry
-    waitTimerExpiry(&tvCycleTimer, ANIM_TICK_CYCLE_MS, MC_FALSE, &remaining);
+    waitTimerExpiry(&tsCycleTimer, ANIM_TICK_CYCLE_MS, MC_FALSE, &remaining);
     if (stats == MC_TRUE)
     {
       if (remaining >= 0)
@@ -611,6 +988,19 @@ char stubEventGet(u08 stats)
         waitTotal = waitTotal + remaining;
         if (minSleep > (int)round(remaining / 1000))
           minSleep = (int)round(remaining / 1000);
+
+        // Register the wakeup lateness relative to the cycle deadline that
+        // has become the cycle timer offset
+        stubClockGet(&tsNow);
+        late = TIMESPECDIFF_USEC(tsNow, tsCycleTimer);
+        if (late < 0)
+          late = 0;
+        if (late > lateMax)
+          lateMax = late;
+        if (late / LATE_BUCKET_USEC >= LATE_BUCKETS)
+          lateHist[LATE_BUCKETS - 1]++;
+        else
+          lateHist[late / LATE_BUCKET_USEC]++;
       }
       else if (eventCycleState == CYCLE_NOWAIT)
       {
@@ -657,16 +1047,29 @@ char stubEventGet(u08 stats)
       emuTimePrint(ALM_NONE);
       ctrlStatsPrint(CTRL_STATS_CYCLE);
       ctrlStatsReset(CTRL_STATS_CYCLE);
+      profCyclePrint();
       printf("\n%s", EMU_KEYS_CYCLE);
       fflush(stdout);
     }
 
-    // Wait for keypress every 75 msec interval
-    ch = kbKeypressScan(MC_FALSE);
-    while (ch == '\0')
+    // Sleep until a keypress, or get it from the event log where a missing
+    // keypress ends the replayed session
+    if (evLogMode == EVLOG_REPLAY)
+    {
+      ch = evLogKeyGet(EVLOG_EV_KEY_WAIT);
+      if (ch == '\0')
+        ch = 'q';
+    }
+    else
     {
-      waitSleep(75);
       ch = kbKeypressScan(MC_FALSE);
+      while (ch == '\0')
+      {
+        reactorWait(NULL);
+        ch = kbKeypressScan(MC_FALSE);
+      }
+      if (evLogMode == EVLOG_RECORD)
+        evLogWrite(EVLOG_EV_KEY_WAIT, 0, (u08 *)&ch, 1);
     }
 
     // Verify keypress and its impact on the wait state
@@ -711,7 +1114,8 @@ char stubEventGet(u08 stats)
 
   // Do we need to do anything with the alarm sound
   if (alarmPid == -1 && almAlarming == MC_TRUE && almSnoozing == MC_FALSE &&
-      (eventCycleState == CYCLE_REQ_NOWAIT || eventCycleState == CYCLE_NOWAIT))
+      evLogMode != EVLOG_REPLAY && (eventCycleState == CYCLE_REQ_NOWAIT ||
+      eventCycleState == CYCLE_NOWAIT))
   {
     // Start playing the alarm sound
     alarmPidStart();
@@ -725,11 +1129,11 @@ char stubEventGet(u08 stats)
 
   // Check if keyboard was hit
   btnHold = BTN_NONE;
-  while (kbHit())
+  while (evLogKbHit())
   {
     // Get keyboard character and make uppercase char a lowercase char
     keypress = MC_TRUE;
-    ch = getchar();
+    ch = evLogGetchar();
     if (ch >= 'A' && ch <= 'Z')
       ch = ch - 'A' + 'a';
 
@@ -864,12 +1268,14 @@ char stubEventGet(u08 stats)
 //
 void stubEventInit(u08 startWait, u08 cfgTimeout, u08 emuType)
 {
-  // If the stack is active disable its 100 msec keyboard scan timer to make
-  // it not interfere with different wait timer mechanisms used in the event
-  // generator
+  // If the stack is active disable its 100 msec keyboard scan timer as the
+  // event generator scans the keyboard itself
   if (cmdStackActiveGet() == MC_TRUE)
      cmdStackTimerSet(LIST_TIMER_DISARM);
 
+  // Accept glut window keypresses as emulator input
+  reactorGlutKeyAccept(MC_TRUE);
+
   // Init the event generator itself
   eventInit = MC_TRUE;
   eventCfgTimeout = cfgTimeout;
@@ -879,6 +1285,16 @@ void stubEventInit(u08 startWait, u08 cfgTimeout, u08 emuType)
   else
     eventCycleState = CYCLE_NOWAIT;
   btnPressed = BTN_NONE;
+
+  // Activate an armed event log for this session
+  evLogMode = evLogArm;
+  evLogArm = EVLOG_NONE;
+  evLogCycle = 0;
+  evLogCount = 0;
+  evLogRtcIdx = 0;
+  evLogRtcValid = MC_FALSE;
+  evLogSessionStart();
+
   if (emuType == EMU_CLOCK)
   {
     stubHelp = stubHelpClockFeed;
@@ -897,6 +1313,53 @@ void stubEventInit(u08 startWait, u08 cfgTimeout, u08 emuType)
   }
 }
 
+//
+// Function: stubEventLogSet
+//
+// Arm recording or replaying the event log of the next event engine session.
+// An event log holds the keypresses and changed RTC time reads of a session
+// indexed by event engine cycle, allowing a bit-exact replay that runs
+// without real-time pacing.
+// Return: MC_TRUE (success) or MC_FALSE (failure).
+//
+u08 stubEventLogSet(u08 mode, char *fileName)
+{
+  char magic[EVLOG_MAGIC_LEN];
+
+  // Discard a previously armed event log
+  if (evLogFp != NULL)
+  {
+    fclose(evLogFp);
+    evLogFp = NULL;
+  }
+  evLogArm = EVLOG_NONE;
+  if (mode == EVLOG_NONE)
+    return MC_TRUE;
+
+  // Open the event log and write or verify its identification
+  evLogFp = fopen(fileName, (mode == EVLOG_RECORD ? "wb" : "rb"));
+  if (evLogFp == NULL)
+  {
+    printf("cannot open event log file \"%s\"\n", fileName);
+    return MC_FALSE;
+  }
+  if (mode == EVLOG_RECORD)
+  {
+    fwrite(EVLOG_MAGIC, EVLOG_MAGIC_LEN, 1, evLogFp);
+  }
+  else if (fread(magic, EVLOG_MAGIC_LEN, 1, evLogFp) != 1 ||
+      memcmp(magic, EVLOG_MAGIC, EVLOG_MAGIC_LEN) != 0)
+  {
+    printf("invalid event log file \"%s\"\n", fileName);
+    fclose(evLogFp);
+    evLogFp = NULL;
+    return MC_FALSE;
+  }
+  evLogArm = mode;
+
+  return MC_TRUE;
+}
+
 //
 // Function: stubEventQuitGet
 //
@@ -918,6 +1381,12 @@ void stubEventReset(void)
   // commands
   if (cmdStackActiveGet() == MC_TRUE)
     cmdStackTimerSet(LIST_TIMER_ARM);
+
+  // Stop accepting glut window keypresses
+  reactorGlutKeyAccept(MC_FALSE);
+
+  // Close the event log of the session (if any)
+  evLogClose();
 }
 
 //
@@ -967,6 +1436,28 @@ static void stubHelpMonochron(void)
   printf("  q = quit\n");
 }
 
+//
+// Function: stubLatePercentile
+//
+// Get the cycle wakeup lateness (usec) of a percentile in the lateness
+// histogram, being the upper bound of the bucket it lives in capped at the
+// max lateness
+//
+static int stubLatePercentile(int percentile)
+{
+  int i;
+  int count = 0;
+
+  for (i = 0; i < LATE_BUCKETS - 1; i++)
+  {
+    count = count + lateHist[i];
+    if ((long long)count * 100 >= (long long)inTimeCount * percentile)
+      return MIN((i + 1) * LATE_BUCKET_USEC, (int)lateMax);
+  }
+
+  return (int)lateMax;
+}
+
 //
 // Function: stubLogfileClose
 //
@@ -1023,6 +1514,9 @@ u08 stubLogfileOpen(char fileName[])
 //
 void stubStatsPrint(void)
 {
+  int i;
+  int hot = 0;
+
   printf("stub   : cycle=%d msec, inTime=%d, outTime=%d, singleCycle=%d\n",
     ANIM_TICK_CYCLE_MS, inTimeCount, outTimeCount, singleCycleCount);
 
@@ -1036,6 +1530,24 @@ void stubStatsPrint(void)
     printf("minSleep=- msec\n");
   else
     printf("minSleep=%d msec\n",minSleep);
+
+  if (inTimeCount == 0)
+    printf("         lateP50=- usec, lateP99=- usec, lateMax=- usec\n");
+  else
+    printf("         lateP50=%d usec, lateP99=%d usec, lateMax=%d usec\n",
+      stubLatePercentile(50), stubLatePercentile(99), (int)lateMax);
+
+  // Eeprom writes, the percentage of writes changing the eeprom, and the
+  // most written eeprom address
+  for (i = 1; i < EE_SIZE; i++)
+    if (eepWrites[i] > eepWrites[hot])
+      hot = i;
+  if (eepWriteTotal == 0)
+    printf("eeprom : write=%lld (-%%)\n", eepWriteTotal);
+  else
+    printf("eeprom : write=%lld (%.0f%%), maxWrite=%lld (address=0x%03x)\n",
+      eepWriteTotal, eepWriteChange * 100 / (double)eepWriteTotal,
+      eepWrites[hot], hot);
 }
 
 //
@@ -1051,6 +1563,40 @@ void stubStatsReset(void)
   singleCycleCount = 0;
   waitTotal = 0;
   minSleep = ANIM_TICK_CYCLE_MS + 1;
+  memset(lateHist, 0, sizeof(lateHist));
+  lateMax = 0;
+  memset(eepWrites, 0, sizeof(eepWrites));
+  eepWriteTotal = 0;
+  eepWriteChange = 0;
+}
+
+//
+// Function: stubTimeGet
+//
+// Get the emulator time. This is the system time, or when time warp is active
+// the virtual time that only advances by the emulator wait functions.
+//
+void stubTimeGet(struct timeval *tv)
+{
+  if (timeWarp == TIME_WARP_REAL)
+    gettimeofday(tv, NULL);
+  else
+    *tv = tvVirtual;
+}
+
+//
+// Function: stubTimeMsecGet
+//
+// Get the msec elapsed in the current second of the emulator time. This is a
+// cheap sub-second query as it does not convert the emulator time into date
+// and time.
+//
+u16 stubTimeMsecGet(void)
+{
+  struct timeval tv;
+
+  stubTimeGet(&tv);
+  return (u16)(tv.tv_usec / 1000);
 }
 
 //
@@ -1081,7 +1627,7 @@ u08 stubTimeSet(uint8_t sec, uint8_t min, uint8_t hr, uint8_t day,
 
   // Init system time and get monochron time
   rtcTimeRead();
-  gettimeofday(&tvNow, NULL);
+  stubTimeGet(&tvNow);
   tmNow = localtime(&tvNow.tv_sec);
 
   // Copy current time
@@ -1155,7 +1701,7 @@ u08 stubTimeSet(uint8_t sec, uint8_t min, uint8_t hr, uint8_t day,
 
   // Get delta between earlier retrieved current and new time and apply it on a
   // fresh current timestamp
-  gettimeofday(&tvNew, NULL);
+  stubTimeGet(&tvNew);
   timeClock = tvNew.tv_sec + timeDeltaNew;
   tmNew = localtime(&timeClock);
 
@@ -1171,8 +1717,9 @@ u08 stubTimeSet(uint8_t sec, uint8_t min, uint8_t hr, uint8_t day,
     timeDeltaNew = timeDeltaNew + 3600;
   }
 
-  // Accept new time delta
+  // Accept new time delta and have the RTC time recalculated
   timeDelta = timeDeltaNew;
+  rtcCacheSec = -1;
 
   // Sync mchron clock time based on new delta
   rtcTimeRead();
@@ -1180,6 +1727,73 @@ u08 stubTimeSet(uint8_t sec, uint8_t min, uint8_t hr, uint8_t day,
   return MC_TRUE;
 }
 
+//
+// Function: stubTimeWait
+//
+// Wait amount of emulator time (in usec). When time warp is active advance the
+// virtual time and only sleep the wait time divided by the time warp factor.
+//
+void stubTimeWait(suseconds_t wait)
+{
+  struct timespec timeSleep;
+
+  if (timeWarp != TIME_WARP_REAL)
+  {
+    // Advance virtual time
+    tvVirtual.tv_sec = tvVirtual.tv_sec + wait / 1000000;
+    tvVirtual.tv_usec = tvVirtual.tv_usec + wait % 1000000;
+    if (tvVirtual.tv_usec >= 1000000)
+    {
+      tvVirtual.tv_sec++;
+      tvVirtual.tv_usec = tvVirtual.tv_usec - 1000000;
+    }
+
+    // At max speed we're done, otherwise sleep a fraction of the wait time
+    if (timeWarp == TIME_WARP_MAX)
+      return;
+    wait = wait / timeWarp;
+  }
+
+  timeSleep.tv_sec = wait / 1000000;
+  timeSleep.tv_nsec = (wait % 1000000) * 1000;
+  nanosleep(&timeSleep, NULL);
+}
+
+//
+// Function: stubTimeWarpGet
+//
+// Get the time warp factor
+//
+int stubTimeWarpGet(void)
+{
+  return timeWarp;
+}
+
+//
+// Function: stubTimeWarpSet
+//
+// Set the time warp factor. Virtual time starts at the start of the current
+// system time second, so the clock cycles in which a new second starts do not
+// depend on the moment time warp got activated. When returning to system time,
+// the time delta is adjusted such that mchron time continues at the virtual
+// time.
+//
+void stubTimeWarpSet(int warp)
+{
+  struct timeval tvNow;
+
+  gettimeofday(&tvNow, NULL);
+  if (timeWarp == TIME_WARP_REAL && warp != TIME_WARP_REAL)
+  {
+    tvVirtual.tv_sec = tvNow.tv_sec;
+    tvVirtual.tv_usec = 0;
+  }
+  else if (timeWarp != TIME_WARP_REAL && warp == TIME_WARP_REAL)
+    timeDelta = timeDelta + (tvVirtual.tv_sec - tvNow.tv_sec);
+  timeWarp = warp;
+  rtcCacheSec = -1;
+}
+
 //
 // Function: stubUartPutChar
 //
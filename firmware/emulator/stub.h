@@ -7,6 +7,8 @@
 #define STUB_H
 
 #include <stddef.h>
+#include <time.h>
+#include <sys/time.h>
 #include "../avrlibtypes.h"
 
 // Keyboard input mode
@@ -19,18 +21,33 @@
 #define DT_TIME_KEEP		70	// Keep current time
 #define DT_TIME_RESET		80	// Reset to system time
 
+// Time warp factor for virtual time at max speed and for system (real) time
+#define TIME_WARP_MAX		0
+#define TIME_WARP_REAL		1
+
 // Emulator type in use in emulator event engine
 #define EMU_CLOCK		0	// Single clock emulator
 #define EMU_MONOCHRON		1	// Monochron application emulator
 
+// Event log mode for recording or replaying an emulator event session
+#define EVLOG_NONE		0
+#define EVLOG_RECORD		1
+#define EVLOG_REPLAY		2
+
 // String to erase the stub event keypress prompt
 #define EMU_KEYS_CLEAR		\
   "                                                                           "
 
+// The persistent eeprom file in the mchron config folder
+#define EEPROM_FILE		"/eeprom"
+
 // Eeprom stubs
 uint8_t eeprom_read_byte(uint8_t *eprombyte);
 void eeprom_write_byte(uint8_t *eprombyte, uint8_t value);
+void stubEepCleanup(void);
+void stubEepInit(void);
 void stubEepReset(void);
+long long stubEepWritesGet(int address);
 
 // Beep stub
 void stubBeep(uint16_t hz, uint8_t msec);
@@ -48,6 +65,15 @@ u08 i2cMasterSendNI(u08 deviceAddr, u08 length, u08* data);
 u08 stubTimeSet(uint8_t sec, uint8_t min, uint8_t hr, uint8_t day,
   uint8_t mon, uint8_t yr);
 
+// Emulator (virtual) monotonic clock and time stubs
+void stubClockGet(struct timespec *ts);
+void stubClockWait(struct timespec *deadline);
+void stubTimeGet(struct timeval *tv);
+u16 stubTimeMsecGet(void);
+void stubTimeWait(suseconds_t wait);
+int stubTimeWarpGet(void);
+void stubTimeWarpSet(int warp);
+
 // UART (debug) output stub
 void stubUartPutChar(void);
 
@@ -56,6 +82,7 @@ void stubUartPutChar(void);
 // Monochron emulator stubs
 char stubEventGet(u08 stats);
 void stubEventInit(u08 startWait, u08 cfgTimeout, u08 emuType);
+u08 stubEventLogSet(u08 mode, char *fileName);
 u08 stubEventQuitGet(void);
 void stubEventReset(void);
 
@@ -59,12 +59,30 @@ static u08 fontByteIdx;
 static u08 fontWidth;
 static u16 fontCharIdx;
 
+#ifdef EMULIN
+// Definition of a structure holding a polygon edge in the edge table used by
+// glcdFillPolygon(). The edge is stored such that x1 <= x2.
+typedef struct _glcdEdge_t
+{
+  u08 x1;
+  u08 y1;
+  u08 x2;
+  u08 y2;
+} glcdEdge_t;
+#endif
+
 // Local function prototypes
 static void glcdBufferBitSet(u08 x, u08 y);
 static void glcdBufferRead(u08 x, u08 yByte, u08 len);
 static u08 glcdFontByteGet(void);
 static u16 glcdFontIdxGet(unsigned char c);
 static u08 glcdFontInfoGet(char c);
+#ifdef EMULIN
+static u08 glcdPolygonMask(glcdEdge_t *edges, u08 edgeCount, u08 x,
+  u08 yByte);
+static u08 glcdPolygonSpan(u08 yStart, u08 yEnd, u08 yByte);
+static u08 glcdPolygonY(glcdEdge_t *edge, s16 x2);
+#endif
 
 //
 // Function: glcdBitmap
@@ -555,6 +573,128 @@ void glcdFillCircle2(u08 xCenter, u08 yCenter, u08 radius, u08 fillType)
   }
 }
 
+#ifdef EMULIN
+//
+// Function: glcdFillPolygon
+//
+// Draw a filled polygon with [points] corners at px[x[i],y[i]] using one of
+// the fill types as supported by glcdFillRectangle2() in ALIGN_AUTO mode.
+// The polygon edges are also painted, using rounded edge pixels rather than
+// the Bresenham pixels of glcdLine(). As such the fill can extend 1 pixel
+// beyond the polygon outline drawn with glcdLine().
+// The polygon is rasterized per y-pixel byte. For each lcd column in a y byte
+// the edges in the edge table (sorted on start x) crossing that column yield
+// the pixel spans inside the polygon using the even-odd rule. The resulting
+// bits are merged with the lcd byte and only changed bytes are written back.
+//
+void glcdFillPolygon(u08 points, u08 *x, u08 *y, u08 fillType)
+{
+  glcdEdge_t edges[GLCD_POLYGON_MAX];
+  glcdEdge_t edge;
+  u08 edgeCount = 0;
+  u08 i, j;
+  u08 xMin = GLCD_XPIXELS - 1;
+  u08 xMax = 0;
+  u08 yMin = GLCD_YPIXELS - 1;
+  u08 yMax = 0;
+  u08 yByte;
+  u08 w;
+  u08 mask;
+  u08 template;
+  u08 lcdByte;
+  s08 firstWrite;
+  s08 lastWrite;
+
+  if (points == 0 || points > GLCD_POLYGON_MAX)
+    return;
+
+  // Build the edge table sorted on start x and get the polygon bounding box
+  for (i = 0; i < points; i++)
+  {
+    j = (i == points - 1 ? 0 : i + 1);
+    if (x[i] <= x[j])
+    {
+      edge.x1 = x[i];
+      edge.y1 = y[i];
+      edge.x2 = x[j];
+      edge.y2 = y[j];
+    }
+    else
+    {
+      edge.x1 = x[j];
+      edge.y1 = y[j];
+      edge.x2 = x[i];
+      edge.y2 = y[i];
+    }
+    for (j = edgeCount; j > 0 && edges[j - 1].x1 > edge.x1; j--)
+      edges[j] = edges[j - 1];
+    edges[j] = edge;
+    edgeCount++;
+
+    xMin = MIN(xMin, x[i]);
+    xMax = MAX(xMax, x[i]);
+    yMin = MIN(yMin, y[i]);
+    yMax = MAX(yMax, y[i]);
+  }
+  w = xMax - xMin + 1;
+
+  // Loop through each affected y-pixel byte
+  for (yByte = yMin / 8; yByte <= yMax / 8; yByte++)
+  {
+    glcdBufferRead(xMin, yByte, w);
+    firstWrite = -1;
+    lastWrite = -1;
+
+    for (i = 0; i < w; i++)
+    {
+      // Get the polygon bits for this lcd byte
+      mask = glcdPolygonMask(edges, edgeCount, xMin + i, yByte);
+      if (mask == 0)
+        continue;
+
+      // Get the template for the lcd byte. They are aligned on px[0,0] to
+      // match glcdFillRectangle2() using ALIGN_AUTO.
+      lcdByte = glcdBuffer[i];
+      if (fillType == FILL_FULL)
+        template = 0xff;
+      else if (fillType == FILL_BLANK)
+        template = 0x00;
+      else if (fillType == FILL_HALF)
+        template = ((xMin + i) & 0x1 ? 0xaa : 0x55);
+      else if (fillType == FILL_THIRDUP)
+        template = pgm_read_byte(pattern3Up + (xMin + i + 2 * yByte) % 3);
+      else if (fillType == FILL_THIRDDOWN)
+        template = pgm_read_byte(pattern3Down + (xMin + i + yByte) % 3);
+      else // fillType == FILL_INVERSE
+        template = ~lcdByte;
+
+      // Depending on the draw color invert the template
+      if (glcdColor == GLCD_OFF && fillType != FILL_INVERSE)
+        template = ~template;
+
+      // Merge the lcd byte and the template while keeping track of the first
+      // and last byte changed
+      template = ((lcdByte & ~mask) | (template & mask));
+      if (template != lcdByte)
+      {
+        glcdBuffer[i] = template;
+        if (firstWrite == -1)
+          firstWrite = i;
+        lastWrite = i;
+      }
+    }
+
+    // Write back the range of changed bytes (if any)
+    if (firstWrite >= 0)
+    {
+      glcdSetAddress(xMin + firstWrite, yByte);
+      for (i = firstWrite; i <= (u08)lastWrite; i++)
+        glcdDataWrite(glcdBuffer[i]);
+    }
+  }
+}
+#endif
+
 //
 // Function: glcdFillRectangle
 //
@@ -744,6 +884,60 @@ void glcdFillRectangle2(u08 x, u08 y, u08 w, u08 h, u08 align, u08 fillType)
   }
 }
 
+#ifdef EMULIN
+//
+// Function: glcdFillTriangle
+//
+// Draw a filled triangle with corners px[x1,y1], px[x2,y2] and px[x3,y3]
+//
+void glcdFillTriangle(u08 x1, u08 y1, u08 x2, u08 y2, u08 x3, u08 y3,
+  u08 fillType)
+{
+  u08 x[3];
+  u08 y[3];
+
+  x[0] = x1;
+  y[0] = y1;
+  x[1] = x2;
+  y[1] = y2;
+  x[2] = x3;
+  y[2] = y3;
+  glcdFillPolygon(3, x, y, fillType);
+}
+#endif
+
+//
+// Function: glcdGetColumnsStr
+//
+// Get the font bitmap columns of a string, including the trailing white space
+// columns, in the foreground color and return its pixel width. The LSB of a
+// column defines the top pixel.
+//
+u08 glcdGetColumnsStr(u08 font, char *data, u08 *columns)
+{
+  u08 width = 0;
+  u08 i;
+  u16 idx;
+
+  fontId = font;
+  while (*data)
+  {
+    idx = glcdFontIdxGet(*data);
+    for (i = 0; i < fontWidth; i++)
+    {
+      if (font == FONT_5X5P)
+        columns[width] = (pgm_read_byte(&Font5x5p[idx + i]) & 0x1f);
+      else
+        columns[width] = pgm_read_byte(&Font5x7[idx + i]);
+      width++;
+    }
+    columns[width] = 0x00;
+    width++;
+    data++;
+  }
+  return width;
+}
+
 //
 // Function: glcdGetWidthStr
 //
@@ -1464,3 +1658,101 @@ static u08 glcdFontInfoGet(char c)
   fontWidth = pgm_read_byte(&Font5x5p[idx]) >> 5;
   return idx;
 }
+
+#ifdef EMULIN
+//
+// Function: glcdPolygonMask
+//
+// Get the polygon bits in the lcd byte at lcd column x in y-pixel byte yByte.
+// The bits consist of the pixels of the edges in the column and the spans
+// between pairs of edge crossings of the column.
+//
+static u08 glcdPolygonMask(glcdEdge_t *edges, u08 edgeCount, u08 x,
+  u08 yByte)
+{
+  u08 cross[GLCD_POLYGON_MAX];
+  u08 crossCount = 0;
+  u08 mask = 0;
+  u08 yStart, yEnd;
+  u08 yCross;
+  u08 i, j;
+
+  // The edge table is sorted on start x so we can stop at the first edge
+  // starting beyond the column
+  for (i = 0; i < edgeCount && edges[i].x1 <= x; i++)
+  {
+    if (edges[i].x2 < x)
+      continue;
+
+    if (edges[i].x1 == edges[i].x2)
+    {
+      // Vertical edge
+      yStart = edges[i].y1;
+      yEnd = edges[i].y2;
+    }
+    else
+    {
+      // Get the edge pixels within half a pixel left and right of the column
+      yStart = glcdPolygonY(&edges[i], MAX(2 * x - 1, 2 * edges[i].x1));
+      yEnd = glcdPolygonY(&edges[i], MIN(2 * x + 1, 2 * edges[i].x2));
+
+      // An edge crosses the column when x1 <= x < x2. Using this half-open
+      // interval a corner shared by two edges is counted properly. Keep the
+      // crossings sorted on y.
+      if (x < edges[i].x2)
+      {
+        yCross = glcdPolygonY(&edges[i], 2 * x);
+        for (j = crossCount; j > 0 && cross[j - 1] > yCross; j--)
+          cross[j] = cross[j - 1];
+        cross[j] = yCross;
+        crossCount++;
+      }
+    }
+    if (yStart <= yEnd)
+      mask = mask | glcdPolygonSpan(yStart, yEnd, yByte);
+    else
+      mask = mask | glcdPolygonSpan(yEnd, yStart, yByte);
+  }
+
+  // Add the spans inside the polygon
+  for (i = 0; i + 1 < crossCount; i = i + 2)
+    mask = mask | glcdPolygonSpan(cross[i], cross[i + 1], yByte);
+
+  return mask;
+}
+
+//
+// Function: glcdPolygonSpan
+//
+// Get the bits of y pixel span [yStart..yEnd] in y-pixel byte yByte
+//
+static u08 glcdPolygonSpan(u08 yStart, u08 yEnd, u08 yByte)
+{
+  u08 yTop = yByte * 8;
+
+  if (yEnd < yTop || yStart > yTop + 7)
+    return 0;
+  if (yStart < yTop)
+    yStart = yTop;
+  if (yEnd > yTop + 7)
+    yEnd = yTop + 7;
+
+  return (0xff >> (7 - (yEnd - yStart))) << (yStart - yTop);
+}
+
+//
+// Function: glcdPolygonY
+//
+// Get the rounded y pixel of an edge at half-pixel x position x2 (= 2 * x)
+//
+static u08 glcdPolygonY(glcdEdge_t *edge, s16 x2)
+{
+  s16 num = ((s16)edge->y2 - edge->y1) * (x2 - 2 * edge->x1);
+  s16 den = 2 * ((s16)edge->x2 - edge->x1);
+
+  if (num >= 0)
+    return edge->y1 + (2 * num + den) / (2 * den);
+  else
+    return edge->y1 - (-2 * num + den) / (2 * den);
+}
+#endif
@@ -25,6 +25,9 @@
 #define ALIGN_BOTTOM	1	// Align on bottom-left pixel
 #define ALIGN_AUTO	2	// Align on (0,0) pixel (overlap)
 
+// Max number of polygon corners (mchron only)
+#define GLCD_POLYGON_MAX	8
+
 // Circle types
 #define CIRCLE_FULL	0	// Full circle
 #define CIRCLE_HALF_E	1	// Half circle on even bits
@@ -75,6 +78,13 @@ void glcdRectangle(u08 x, u08 y, u08 w, u08 h);
 void glcdFillRectangle(u08 x, u08 y, u08 w, u08 h);
 void glcdFillRectangle2(u08 x, u08 y, u08 w, u08 h, u08 align, u08 fillType);
 
+// Draw and fill polygon and triangle (not used in Monochron clocks)
+#ifdef EMULIN
+void glcdFillPolygon(u08 points, u08 *x, u08 *y, u08 fillType);
+void glcdFillTriangle(u08 x1, u08 y1, u08 x2, u08 y2, u08 x3, u08 y3,
+  u08 fillType);
+#endif
+
 // Draw full/dotted/filled circle at [xCenter,yCenter] with [radius]
 void glcdCircle2(u08 xCenter, u08 yCenter, u08 radius, u08 lineType);
 void glcdFillCircle2(u08 xCenter, u08 yCenter, u08 radius, u08 fillType);
@@ -104,6 +114,8 @@ void glcdBitmap16Ra(u08 x, u08 y, u08 w, u08 h, uint16_t *bitmap);
 void glcdBitmap32Pm(u08 x, u08 y, u08 w, u08 h, const uint32_t *bitmap);
 void glcdBitmap32Ra(u08 x, u08 y, u08 w, u08 h, uint32_t *bitmap);
 
+// Get the font bitmap columns and the pixel width of a string
+u08 glcdGetColumnsStr(u08 font, char *data, u08 *columns);
 // Get the pixel width of a string
 u08 glcdGetWidthStr(u08 font, char *data);
 #endif
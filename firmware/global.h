@@ -63,6 +63,14 @@
 // 0 = Off, 1 = On
 #define BACKLIGHT_ADJUST		1
 
+// Lcd frame buffer. Allows drawing an lcd frame off-screen and writing only
+// its changed bytes to the lcd. It requires 2K of ram so it is only available
+// in the emulator, where it is off by default and is switched on via mchron
+// command 'lfb'. In firmware glcdBeginFrame/glcdEndFrame do nothing.
+#ifdef EMULIN
+#define GLCD_FRAME_BUFFER		1
+#endif
+
 // Pin/port definitions for alarm switch
 #define ALARM_PORT			PORTB
 #define ALARM_PIN			PINB
@@ -6,6 +6,7 @@
 #ifndef EMULIN
 #include <avr/interrupt.h>
 #endif
+#include <string.h>
 #include "global.h"
 #include "ks0108conf.h"
 #ifdef EMULIN
@@ -38,13 +39,57 @@ typedef struct _glcdLcdCursor_t
 // The lcd controller and cursor administration
 static glcdLcdCursor_t glcdLcdCursor;
 
+#ifdef GLCD_FRAME_BUFFER
+// When drawing a frame, all lcd data reads and writes are done in an
+// off-screen frame buffer instead of in the lcd controllers. At the end of the
+// frame only the bytes that differ from the current lcd image are written to
+// the lcd, using the auto-increment of the controller x cursor for sequential
+// changed bytes. The lcd image is kept in sync by glcdDataWrite().
+// As firmware has no frame buffer, it is off by default so the lcd traffic
+// models that of firmware.
+static u08 glcdFrame[GLCD_CONTROLLER_YPAGES][GLCD_XPIXELS];
+static u08 glcdFrameLcd[GLCD_CONTROLLER_YPAGES][GLCD_XPIXELS];
+static u08 glcdFrameEnabled = MC_FALSE;	// Is frame buffer switched on
+static u08 glcdFrameLevel = 0;		// Nesting level of begin/end frame
+static u08 glcdFrameSynced = MC_FALSE;	// Is lcd image in sync with lcd
+static u08 glcdFrameReadX;		// Frame controller x read cursor
+static u08 glcdFrameReadDummy;		// Is next frame read a dummy read
+#endif
+
 // Local function prototypes
 static void glcdBusyWait(void);
 static void glcdControlSelect(u08 controller);
+#ifdef GLCD_FRAME_BUFFER
+static void glcdFrameSync(void);
+#endif
 static void glcdNextAddress(void);
 static void glcdSetXAddress(void);
 static void glcdSetYAddress(u08 yAddr);
 
+//
+// Function: glcdBeginFrame
+//
+// Start drawing a frame in the off-screen frame buffer. Frames may be nested;
+// the lcd is only updated at the outermost glcdEndFrame().
+//
+void glcdBeginFrame(void)
+{
+#ifdef GLCD_FRAME_BUFFER
+  if (glcdFrameLevel == 0)
+  {
+    // Draw directly on the lcd when the frame buffer is switched off
+    if (glcdFrameEnabled == MC_FALSE)
+      return;
+
+    // Start the frame from the current lcd image
+    if (glcdFrameSynced == MC_FALSE)
+      glcdFrameSync();
+    memcpy(glcdFrame, glcdFrameLcd, sizeof(glcdFrame));
+  }
+  glcdFrameLevel++;
+#endif
+}
+
 //
 // Function: glcdBusyWait
 //
@@ -173,6 +218,26 @@ u08 glcdDataRead(void)
 
   register u08 data;
 
+#ifdef GLCD_FRAME_BUFFER
+  // When drawing a frame read from the frame buffer, mimicking the dummy read
+  // and the controller x cursor increment of the lcd controller
+  if (glcdFrameLevel > 0)
+  {
+#ifdef EMULIN
+    ctrlFrameAccess(CTRL_METHOD_READ);
+#endif
+    if (glcdFrameReadDummy == MC_TRUE)
+    {
+      glcdFrameReadDummy = MC_FALSE;
+      return 0;
+    }
+    data = glcdFrame[glcdLcdCursor.lcdYAddr][glcdFrameReadX];
+    glcdFrameReadX = (glcdFrameReadX & ~GLCD_CONTROLLER_XPIXMASK) |
+      ((glcdFrameReadX + 1) & GLCD_CONTROLLER_XPIXMASK);
+    return data;
+  }
+#endif
+
   cli();
   glcdBusyWait();
   sbi(GLCD_CTRL_RS_PORT, GLCD_CTRL_RS);
@@ -212,6 +277,31 @@ void glcdDataWrite(u08 data)
       glcdLcdCursor.lcdXAddr, glcdLcdCursor.lcdYAddr, data);
 #endif
 
+#ifdef GLCD_FRAME_BUFFER
+  // When drawing a frame write in the frame buffer only
+  if (glcdFrameLevel > 0)
+  {
+#ifdef EMULIN
+    ctrlFrameAccess(CTRL_METHOD_WRITE);
+#endif
+    glcdFrame[glcdLcdCursor.lcdYAddr][glcdLcdCursor.lcdXAddr] = data;
+    if (glcdLcdCursor.lcdXAddr >= GLCD_XPIXELS - 1)
+      glcdLcdCursor.lcdXAddr =
+        (GLCD_NUM_CONTROLLERS - 1) * GLCD_CONTROLLER_XPIXELS;
+    else
+      glcdLcdCursor.lcdXAddr++;
+#ifdef EMULIN
+    // Mimic the cursor address set when moving to the next controller
+    if ((glcdLcdCursor.lcdXAddr & GLCD_CONTROLLER_XPIXMASK) == 0)
+      ctrlFrameAccess(CTRL_METHOD_CTRL_W);
+#endif
+    return;
+  }
+
+  // Keep the lcd image in sync
+  glcdFrameLcd[glcdLcdCursor.lcdYAddr][glcdLcdCursor.lcdXAddr] = data;
+#endif
+
   cli();
   glcdBusyWait();
   sbi(GLCD_CTRL_RS_PORT, GLCD_CTRL_RS);
@@ -239,6 +329,103 @@ void glcdDataWrite(u08 data)
   glcdNextAddress();
 }
 
+//
+// Function: glcdEndFrame
+//
+// End drawing a frame and write the bytes that differ from the current lcd
+// image to the lcd
+//
+void glcdEndFrame(void)
+{
+#ifdef GLCD_FRAME_BUFFER
+  u08 x;
+  u08 y;
+  u08 run;
+
+  if (glcdFrameLevel == 0 || --glcdFrameLevel > 0)
+    return;
+
+  for (y = 0; y < GLCD_CONTROLLER_YPAGES; y++)
+  {
+    run = MC_FALSE;
+    for (x = 0; x < GLCD_XPIXELS; x++)
+    {
+      if (glcdFrame[y][x] == glcdFrameLcd[y][x])
+      {
+        run = MC_FALSE;
+        continue;
+      }
+
+      // Set the cursor only at the start of a run of changed bytes. In a run
+      // glcdDataWrite() will take care of the controller switch.
+      if (run == MC_FALSE)
+      {
+        glcdSetAddress(x, y);
+        run = MC_TRUE;
+      }
+      glcdDataWrite(glcdFrame[y][x]);
+    }
+  }
+#endif
+}
+
+#ifdef EMULIN
+//
+// Function: glcdFrameEnable
+//
+// Switch the frame buffer on or off. When switched off, a frame being drawn
+// is still completed in the frame buffer.
+//
+void glcdFrameEnable(u08 enable)
+{
+#ifdef GLCD_FRAME_BUFFER
+  glcdFrameEnabled = enable;
+  glcdFrameSynced = MC_FALSE;
+#endif
+}
+#endif
+
+//
+// Function: glcdFrameReset
+//
+// Resync the lcd image with the lcd at the next frame. Use this after lcd
+// data has been written bypassing glcdDataWrite().
+//
+void glcdFrameReset(void)
+{
+#ifdef GLCD_FRAME_BUFFER
+  glcdFrameSynced = MC_FALSE;
+#endif
+}
+
+#ifdef GLCD_FRAME_BUFFER
+//
+// Function: glcdFrameSync
+//
+// Sync the lcd image with the lcd contents
+//
+static void glcdFrameSync(void)
+{
+  u08 x;
+  u08 y;
+
+  for (y = 0; y < GLCD_CONTROLLER_YPAGES; y++)
+  {
+    for (x = 0; x < GLCD_XPIXELS; x++)
+    {
+      // Do a dummy read at the start of a controller
+      if ((x & GLCD_CONTROLLER_XPIXMASK) == 0)
+      {
+        glcdSetAddress(x, y);
+        glcdDataRead();
+      }
+      glcdFrameLcd[y][x] = glcdDataRead();
+    }
+  }
+  glcdFrameSynced = MC_TRUE;
+}
+#endif
+
 //
 // Function: glcdInit
 //
@@ -280,6 +467,12 @@ void glcdInit(void)
   // Init admin of controller y page so it will sync at first cursor request
   for (i = 0; i < GLCD_NUM_CONTROLLERS; i++)
     glcdLcdCursor.ctrlYAddr[i] = MAX_U08;
+
+#ifdef GLCD_FRAME_BUFFER
+  // Sync the lcd image at the first frame to draw
+  glcdFrameLevel = 0;
+  glcdFrameSynced = MC_FALSE;
+#endif
 }
 
 //
@@ -339,6 +532,19 @@ void glcdSetAddress(u08 xAddr, u08 yAddr)
   // The set address functions are setup such that we must set the x position
   // first to get the destination controller and only then set the y position.
   glcdLcdCursor.lcdXAddr = xAddr;
+#ifdef GLCD_FRAME_BUFFER
+  if (glcdFrameLevel > 0)
+  {
+    // When drawing a frame only set the administrative cursor
+#ifdef EMULIN
+    ctrlFrameAccess(CTRL_METHOD_CTRL_W);
+#endif
+    glcdLcdCursor.lcdYAddr = yAddr;
+    glcdFrameReadX = xAddr;
+    glcdFrameReadDummy = MC_TRUE;
+    return;
+  }
+#endif
   glcdSetXAddress();
   glcdSetYAddress(yAddr);
 }
@@ -31,5 +31,11 @@ void glcdDataWrite(u08 data);
 void glcdInit(void);
 
 // Functional oriented functions
+void glcdBeginFrame(void);
+void glcdEndFrame(void);
+#ifdef EMULIN
+void glcdFrameEnable(u08 enable);
+#endif
+void glcdFrameReset(void);
 void glcdSetAddress(u08 xAddr, u08 yAddr);
 #endif
@@ -0,0 +1,523 @@
+//*****************************************************************************
+// Filename : 'sprite.c'
+// Title    : Sprite engine for hd61202/ks0108 displays
+//*****************************************************************************
+
+#include "global.h"
+#include "glcd.h"
+#include "ks0108.h"
+#include "ks0108conf.h"
+#ifdef EMULIN
+#include "emulator/mchronutil.h"
+#endif
+#include "sprite.h"
+
+// This module implements a small sprite engine on top of the low-level lcd
+// api. A sprite is a rectangular bitmap of up to 32 pixels high that may
+// contain multiple frames. The frames are stored side by side in a single
+// bitmap data array, using the same element types and data origins as
+// glcdBitmap(). A sprite is opaque: a set bit is drawn in the foreground color
+// and a cleared bit in the background color.
+// Moving, hiding or changing a sprite does not draw anything right away.
+// Instead, the lcd area no longer covered by the sprite is restored to the
+// background color, and the old and new sprite areas are marked as dirty. At
+// the end of a clock cycle spriteFlush() recomposes the lcd bytes in the dirty
+// areas only once, using all sprites in their z-order, and writes only the
+// lcd bytes that actually change.
+// Since the uncovered area is restored immediately, a clock can still repair
+// its static graphics that were overlapped by the old sprite location in its
+// cycle without them being wiped out later on by the sprite engine.
+
+// Chunk size of the lcd line buffer used for recomposing a dirty area
+#define SPRITE_BUF_SIZE		32
+
+// Definition of a structure that holds a registered sprite
+typedef struct _spriteInfo_t
+{
+  u08 x;		// Sprite x position
+  u08 y;		// Sprite y position
+  u08 w;		// Sprite width
+  u08 h;		// Sprite height (1..32)
+  u08 z;		// Sprite z-order (higher is on top)
+  u08 frame;		// Active sprite frame
+  u08 visible;		// Sprite visibility
+  u08 elmType;		// Bitmap element type
+  u08 origin;		// Bitmap data origin
+  void *bitmap;		// Bitmap frame data
+} spriteInfo_t;
+
+// Definition of a structure that holds a dirty lcd area
+typedef struct _spriteRect_t
+{
+  u08 x;		// Area x position
+  u08 y;		// Area y position
+  u08 w;		// Area width
+  u08 h;		// Area height
+} spriteRect_t;
+
+// External data
+extern volatile uint8_t mcBgColor, mcFgColor;
+
+// The sprite administration where spriteOrder[] holds the sprite ids sorted
+// on ascending z-order
+static spriteInfo_t spriteInfo[SPRITE_MAX];
+static u08 spriteOrder[SPRITE_MAX];
+static u08 spriteCount = 0;
+
+// The dirty lcd areas to be recomposed in spriteFlush()
+static spriteRect_t spriteDirty[SPRITE_DIRTY_MAX];
+static u08 spriteDirtyCount = 0;
+
+// Line buffer for reading a chunk of lcd data of a dirty area
+static u08 spriteBuffer[SPRITE_BUF_SIZE];
+
+// Local function prototypes
+static u08 spriteBitsGet(uint32_t bits, u08 y, u08 yByte);
+static void spriteBufferRead(u08 x, u08 yByte, u08 len);
+static uint32_t spriteColumnGet(spriteInfo_t *sprite, u08 x);
+static void spriteDirtyAdd(u08 x, u08 y, u08 w, u08 h);
+static u08 spriteMaskGet(u08 y, u08 h, u08 yByte);
+static void spriteRectCompose(spriteRect_t *rect);
+static void spriteUncover(spriteInfo_t *sprite, u08 x, u08 y, u08 visible);
+
+//
+// Function: spriteBitmapSet
+//
+// Set the bitmap data of a sprite. As a clock may have changed the contents of
+// a bitmap in ram the sprite is always redrawn upon the next sprite flush.
+//
+void spriteBitmapSet(u08 id, void *bitmap)
+{
+  spriteInfo_t *sprite = &spriteInfo[id];
+
+  if (id >= spriteCount)
+    return;
+
+  sprite->bitmap = bitmap;
+  if (sprite->visible == SPRITE_SHOW)
+    spriteDirtyAdd(sprite->x, sprite->y, sprite->w, sprite->h);
+}
+
+//
+// Function: spriteFlush
+//
+// Recompose the dirty lcd areas using all visible sprites in their z-order
+// and reset the dirty area administration. A clock using sprites calls it
+// once it has been initialized or has completed its cycle.
+//
+void spriteFlush(void)
+{
+  u08 i;
+
+  for (i = 0; i < spriteDirtyCount; i++)
+    spriteRectCompose(&spriteDirty[i]);
+  spriteDirtyCount = 0;
+}
+
+//
+// Function: spriteFrameSet
+//
+// Set the active frame of a sprite
+//
+void spriteFrameSet(u08 id, u08 frame)
+{
+  spriteInfo_t *sprite = &spriteInfo[id];
+
+  if (id >= spriteCount || sprite->frame == frame)
+    return;
+
+  // As a sprite is opaque a new frame covers the same area
+  sprite->frame = frame;
+  if (sprite->visible == SPRITE_SHOW)
+    spriteDirtyAdd(sprite->x, sprite->y, sprite->w, sprite->h);
+}
+
+//
+// Function: spriteMove
+//
+// Move a sprite to a new position
+//
+void spriteMove(u08 id, u08 x, u08 y)
+{
+  spriteInfo_t *sprite = &spriteInfo[id];
+
+  if (id >= spriteCount || (sprite->x == x && sprite->y == y))
+    return;
+
+#ifdef EMULIN
+  // Check if the new sprite position is out of bounds
+  if ((int)x + sprite->w > GLCD_XPIXELS || (int)y + sprite->h > GLCD_YPIXELS)
+    emuCoreDump(CD_GLCD, __func__, id, x, y, 0);
+#endif
+
+  // Restore the area that gets uncovered and mark the new area dirty
+  if (sprite->visible == SPRITE_SHOW)
+  {
+    spriteUncover(sprite, x, y, SPRITE_SHOW);
+    spriteDirtyAdd(x, y, sprite->w, sprite->h);
+  }
+  sprite->x = x;
+  sprite->y = y;
+}
+
+//
+// Function: spriteRegister
+//
+// Register a sprite and return its id. Return SPRITE_NONE when the sprite
+// administration is full. A registered sprite is visible and will be drawn
+// upon the next sprite flush.
+//
+u08 spriteRegister(u08 x, u08 y, u08 w, u08 h, u08 z, u08 elmType,
+  u08 origin, void *bitmap)
+{
+  spriteInfo_t *sprite;
+  u08 id = spriteCount;
+  u08 i;
+
+  if (spriteCount == SPRITE_MAX)
+    return SPRITE_NONE;
+
+#ifdef EMULIN
+  // Check if the sprite does not fit in the lcd or element type
+  if ((int)x + w > GLCD_XPIXELS || (int)y + h > GLCD_YPIXELS || h > 32 ||
+      (elmType == ELM_BYTE && h > 8) || (elmType == ELM_WORD && h > 16))
+    emuCoreDump(CD_GLCD, __func__, id, x, y, h);
+#endif
+
+  // Add the sprite
+  sprite = &spriteInfo[id];
+  sprite->x = x;
+  sprite->y = y;
+  sprite->w = w;
+  sprite->h = h;
+  sprite->z = z;
+  sprite->frame = 0;
+  sprite->visible = SPRITE_SHOW;
+  sprite->elmType = elmType;
+  sprite->origin = origin;
+  sprite->bitmap = bitmap;
+  spriteCount++;
+
+  // Insert the sprite in the z-order list after sprites with the same z-order
+  for (i = id; i > 0 && spriteInfo[spriteOrder[i - 1]].z > z; i--)
+    spriteOrder[i] = spriteOrder[i - 1];
+  spriteOrder[i] = id;
+
+  spriteDirtyAdd(x, y, w, h);
+
+  return id;
+}
+
+//
+// Function: spriteReset
+//
+// Clear all registered sprites and dirty areas without touching the lcd.
+// A clock using sprites calls it prior to registering its sprites.
+//
+void spriteReset(void)
+{
+  spriteCount = 0;
+  spriteDirtyCount = 0;
+}
+
+//
+// Function: spriteVisibleSet
+//
+// Show or hide a sprite
+//
+void spriteVisibleSet(u08 id, u08 visible)
+{
+  spriteInfo_t *sprite = &spriteInfo[id];
+
+  if (id >= spriteCount || sprite->visible == visible)
+    return;
+
+  if (visible == SPRITE_HIDE)
+    spriteUncover(sprite, sprite->x, sprite->y, SPRITE_HIDE);
+  else
+    spriteDirtyAdd(sprite->x, sprite->y, sprite->w, sprite->h);
+  sprite->visible = visible;
+}
+
+//
+// Function: spriteBitsGet
+//
+// Get the lcd byte bits for lcd y byte yByte from bitmap column data that
+// starts at lcd pixel y
+//
+static u08 spriteBitsGet(uint32_t bits, u08 y, u08 yByte)
+{
+  u08 yPixel = yByte * 8;
+
+  if (y >= yPixel)
+  {
+    if (y - yPixel > 7)
+      return 0;
+    return (u08)(bits << (y - yPixel));
+  }
+  else
+  {
+    if (yPixel - y > 31)
+      return 0;
+    return (u08)(bits >> (yPixel - y));
+  }
+}
+
+//
+// Function: spriteBufferRead
+//
+// Read lcd data from a y byte into buffer spriteBuffer[]
+//
+static void spriteBufferRead(u08 x, u08 yByte, u08 len)
+{
+  u08 i;
+
+  for (i = 0; i < len; i++)
+  {
+    // Set cursor and do a dummy read on the first read and the first read
+    // upon switching between controllers
+    if (i == 0 || ((i + x) & GLCD_CONTROLLER_XPIXMASK) == 0)
+    {
+      glcdSetAddress(i + x, yByte);
+      glcdDataRead();
+    }
+    spriteBuffer[i] = glcdDataRead();
+  }
+}
+
+//
+// Function: spriteColumnGet
+//
+// Get the bitmap column data of the active sprite frame at lcd position x
+//
+static uint32_t spriteColumnGet(spriteInfo_t *sprite, u08 x)
+{
+  u16 idx = (u16)sprite->frame * sprite->w + x - sprite->x;
+  uint32_t column;
+
+  if (sprite->elmType == ELM_BYTE)
+  {
+    if (sprite->origin == DATA_PMEM)
+      column = pgm_read_byte((const uint8_t *)sprite->bitmap + idx);
+    else
+      column = ((uint8_t *)sprite->bitmap)[idx];
+  }
+  else if (sprite->elmType == ELM_WORD)
+  {
+    if (sprite->origin == DATA_PMEM)
+      column = pgm_read_word((const uint16_t *)sprite->bitmap + idx);
+    else
+      column = ((uint16_t *)sprite->bitmap)[idx];
+  }
+  else // ELM_DWORD
+  {
+    if (sprite->origin == DATA_PMEM)
+      column = pgm_read_dword((const uint32_t *)sprite->bitmap + idx);
+    else
+      column = ((uint32_t *)sprite->bitmap)[idx];
+  }
+
+  return column;
+}
+
+//
+// Function: spriteDirtyAdd
+//
+// Add an area to the dirty area administration. When the administration is
+// full merge the area with the last dirty area.
+//
+static void spriteDirtyAdd(u08 x, u08 y, u08 w, u08 h)
+{
+  spriteRect_t *rect;
+  u08 i;
+  u08 xEnd;
+  u08 yEnd;
+
+  // Skip the area when it is already covered by a dirty area
+  for (i = 0; i < spriteDirtyCount; i++)
+  {
+    rect = &spriteDirty[i];
+    if (x >= rect->x && y >= rect->y && x + w <= rect->x + rect->w &&
+        y + h <= rect->y + rect->h)
+      return;
+  }
+
+  if (spriteDirtyCount < SPRITE_DIRTY_MAX)
+  {
+    // Add a new dirty area
+    rect = &spriteDirty[spriteDirtyCount];
+    rect->x = x;
+    rect->y = y;
+    rect->w = w;
+    rect->h = h;
+    spriteDirtyCount++;
+  }
+  else
+  {
+    // Merge into the last dirty area
+    rect = &spriteDirty[SPRITE_DIRTY_MAX - 1];
+    xEnd = MAX(x + w, rect->x + rect->w);
+    yEnd = MAX(y + h, rect->y + rect->h);
+    rect->x = MIN(x, rect->x);
+    rect->y = MIN(y, rect->y);
+    rect->w = xEnd - rect->x;
+    rect->h = yEnd - rect->y;
+  }
+}
+
+//
+// Function: spriteMaskGet
+//
+// Get the lcd byte mask for lcd y byte yByte of a vertical pixel range
+//
+static u08 spriteMaskGet(u08 y, u08 h, u08 yByte)
+{
+  u08 yPixel = yByte * 8;
+  u08 start = MAX(y, yPixel);
+  u08 end = MIN(y + h, yPixel + 8);
+
+  if (start >= end)
+    return 0;
+  return (0xff >> (8 - (end - start))) << (start - yPixel);
+}
+
+//
+// Function: spriteRectCompose
+//
+// Recompose the lcd bytes of a dirty area using the visible sprites. Only lcd
+// bytes that change are written, where the lcd cursor is set only at the
+// start of a run of changed bytes.
+//
+static void spriteRectCompose(spriteRect_t *rect)
+{
+  spriteInfo_t *sprite;
+  u08 i, j;
+  u08 x;
+  u08 yByte;
+  u08 len;
+  u08 rectMask;
+  u08 mask;
+  u08 bits;
+  u08 lcdByte;
+  u08 inRun;
+  u08 covered;
+
+  for (yByte = rect->y / 8; yByte <= (rect->y + rect->h - 1) / 8; yByte++)
+  {
+    rectMask = spriteMaskGet(rect->y, rect->h, yByte);
+    for (x = rect->x; x < rect->x + rect->w; x = x + len)
+    {
+      len = MIN(SPRITE_BUF_SIZE, rect->x + rect->w - x);
+
+      // Skip the chunk when no visible sprite covers it
+      covered = MC_FALSE;
+      for (j = 0; j < spriteCount; j++)
+      {
+        sprite = &spriteInfo[j];
+        if (sprite->visible == SPRITE_SHOW && x < sprite->x + sprite->w &&
+            sprite->x < x + len &&
+            (spriteMaskGet(sprite->y, sprite->h, yByte) & rectMask) != 0)
+        {
+          covered = MC_TRUE;
+          break;
+        }
+      }
+      if (covered == MC_FALSE)
+        continue;
+
+      // Compose each lcd byte in the chunk bottom-up in z-order
+      spriteBufferRead(x, yByte, len);
+      inRun = MC_FALSE;
+      for (i = 0; i < len; i++)
+      {
+        lcdByte = spriteBuffer[i];
+        for (j = 0; j < spriteCount; j++)
+        {
+          sprite = &spriteInfo[spriteOrder[j]];
+          if (sprite->visible == SPRITE_HIDE || x + i < sprite->x ||
+              x + i >= sprite->x + sprite->w)
+            continue;
+          mask = spriteMaskGet(sprite->y, sprite->h, yByte) & rectMask;
+          if (mask == 0)
+            continue;
+          bits = spriteBitsGet(spriteColumnGet(sprite, x + i), sprite->y,
+            yByte);
+          if (mcFgColor == GLCD_OFF)
+            bits = ~bits;
+          lcdByte = (lcdByte & ~mask) | (bits & mask);
+        }
+
+        // Write a changed lcd byte
+        if (lcdByte != spriteBuffer[i])
+        {
+          if (inRun == MC_FALSE)
+          {
+            glcdSetAddress(x + i, yByte);
+            inRun = MC_TRUE;
+          }
+          glcdDataWrite(lcdByte);
+        }
+        else
+        {
+          inRun = MC_FALSE;
+        }
+      }
+    }
+  }
+}
+
+//
+// Function: spriteUncover
+//
+// Restore the lcd area of a sprite that is no longer covered by that sprite
+// when it is moved to [x,y] or is hidden, and mark its old area as dirty so
+// overlapping sprites get recomposed
+//
+static void spriteUncover(spriteInfo_t *sprite, u08 x, u08 y, u08 visible)
+{
+  u08 i;
+  u08 xPos;
+  u08 yByte;
+  u08 oldMask;
+  u08 newMask;
+  u08 clearMask;
+  u08 lcdByte;
+  u08 newByte;
+
+  for (yByte = sprite->y / 8; yByte <= (sprite->y + sprite->h - 1) / 8;
+      yByte++)
+  {
+    oldMask = spriteMaskGet(sprite->y, sprite->h, yByte);
+    if (visible == SPRITE_SHOW)
+      newMask = spriteMaskGet(y, sprite->h, yByte);
+    else
+      newMask = 0;
+    for (i = 0; i < sprite->w; i++)
+    {
+      // Get the pixels no longer covered by the sprite
+      xPos = sprite->x + i;
+      if (xPos >= x && xPos < x + sprite->w)
+        clearMask = oldMask & ~newMask;
+      else
+        clearMask = oldMask;
+      if (clearMask == 0)
+        continue;
+
+      // Restore the pixels to the background color
+      glcdSetAddress(xPos, yByte);
+      glcdDataRead();
+      lcdByte = glcdDataRead();
+      if (mcBgColor == GLCD_OFF)
+        newByte = lcdByte & ~clearMask;
+      else
+        newByte = lcdByte | clearMask;
+      if (newByte != lcdByte)
+      {
+        glcdSetAddress(xPos, yByte);
+        glcdDataWrite(newByte);
+      }
+    }
+  }
+
+  spriteDirtyAdd(sprite->x, sprite->y, sprite->w, sprite->h);
+}
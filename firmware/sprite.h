@@ -0,0 +1,37 @@
+//*****************************************************************************
+// Filename : 'sprite.h'
+// Title    : Sprite engine for hd61202/ks0108 displays
+//*****************************************************************************
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include "avrlibtypes.h"
+
+// Max number of registered sprites and dirty areas per clock cycle
+#define SPRITE_MAX		4
+#define SPRITE_DIRTY_MAX	(SPRITE_MAX * 2)
+
+// Sprite id returned when no more sprites can be registered
+#define SPRITE_NONE		255
+
+// Sprite visibility
+#define SPRITE_HIDE		0
+#define SPRITE_SHOW		1
+
+// Reset the sprite administration
+void spriteReset(void);
+
+// Register a sprite, returning its sprite id
+u08 spriteRegister(u08 x, u08 y, u08 w, u08 h, u08 z, u08 elmType,
+  u08 origin, void *bitmap);
+
+// Change sprite bitmap, position, frame and visibility
+void spriteBitmapSet(u08 id, void *bitmap);
+void spriteFrameSet(u08 id, u08 frame);
+void spriteMove(u08 id, u08 x, u08 y);
+void spriteVisibleSet(u08 id, u08 visible);
+
+// Recompose all dirty sprite areas on the lcd
+void spriteFlush(void);
+#endif
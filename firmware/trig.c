@@ -0,0 +1,125 @@
+//*****************************************************************************
+// Filename : 'trig.c'
+// Title    : Fixed-point sine/cosine functions for MONOCHRON clocks
+//*****************************************************************************
+
+#include "global.h"
+#include "trig.h"
+
+// This module replaces the float sin() and cos() functions that are emulated
+// in software on the Atmega328p. The sine values of the first quadrant are
+// stored in a progmem table in 64 steps of 256 binary angle units. Values
+// between two table entries are linearly interpolated, resulting in a max
+// error of approx 1E-4. The other quadrants are derived from the first one.
+// The table values are scaled by 32768, so sin(pi/2) is stored as 0x8000.
+// This allows trigSinMul() and trigCosMul() to multiply a value by exactly 1
+// or -1, whereas trigSin() and trigCos() saturate to 0x7fff in Q1.15.
+
+// The number of angle units per table entry
+#define TRIG_STEP_BITS		8
+
+// Sine values for the first quadrant
+static const uint16_t __attribute__ ((progmem)) trigSinTable[] =
+{
+  0x0000, 0x0324, 0x0648, 0x096b, 0x0c8c, 0x0fab, 0x12c8, 0x15e2,
+  0x18f9, 0x1c0c, 0x1f1a, 0x2224, 0x2528, 0x2827, 0x2b1f, 0x2e11,
+  0x30fc, 0x33df, 0x36ba, 0x398d, 0x3c57, 0x3f17, 0x41ce, 0x447b,
+  0x471d, 0x49b4, 0x4c40, 0x4ec0, 0x5134, 0x539b, 0x55f6, 0x5843,
+  0x5a82, 0x5cb4, 0x5ed7, 0x60ec, 0x62f2, 0x64e9, 0x66d0, 0x68a7,
+  0x6a6e, 0x6c24, 0x6dca, 0x6f5f, 0x70e3, 0x7255, 0x73b6, 0x7505,
+  0x7642, 0x776c, 0x7885, 0x798a, 0x7a7d, 0x7b5d, 0x7c2a, 0x7ce4,
+  0x7d8a, 0x7e1e, 0x7e9d, 0x7f0a, 0x7f62, 0x7fa7, 0x7fd9, 0x7ff6,
+  0x8000
+};
+
+// Local function prototypes
+static u16 trigSinAbs(u16 angle);
+
+//
+// Function: trigCos
+//
+// Get the cosine of an angle in Q1.15 fixed point
+//
+s16 trigCos(u16 angle)
+{
+  return trigSin(angle + (u16)(TRIG_ANGLE_FULL / 4));
+}
+
+//
+// Function: trigCosMul
+//
+// Get value * cosine of an angle, truncated towards zero
+//
+s16 trigCosMul(u16 angle, s16 value)
+{
+  return trigSinMul(angle + (u16)(TRIG_ANGLE_FULL / 4), value);
+}
+
+//
+// Function: trigSin
+//
+// Get the sine of an angle in Q1.15 fixed point
+//
+s16 trigSin(u16 angle)
+{
+  u16 sinAbs = trigSinAbs(angle);
+
+  if (sinAbs > 0x7fff)
+    sinAbs = 0x7fff;
+  if (angle & 0x8000)
+    return -(s16)sinAbs;
+  else
+    return (s16)sinAbs;
+}
+
+//
+// Function: trigSinAbs
+//
+// Get the absolute sine value of an angle scaled by 32768 (0..0x8000)
+//
+static u16 trigSinAbs(u16 angle)
+{
+  u08 idx;
+  u08 frac;
+  u16 sin0, sin1;
+
+  // Map the angle onto the first quadrant
+  angle = angle & 0x7fff;
+  if (angle > 0x4000)
+    angle = 0x8000 - angle;
+
+  // Get the table value and interpolate with the next one when needed
+  idx = angle >> TRIG_STEP_BITS;
+  frac = angle & ((1 << TRIG_STEP_BITS) - 1);
+  sin0 = pgm_read_word(&trigSinTable[idx]);
+  if (frac == 0)
+    return sin0;
+  sin1 = pgm_read_word(&trigSinTable[idx + 1]);
+  return sin0 + (u16)(((u32)(sin1 - sin0) * frac +
+    (1 << (TRIG_STEP_BITS - 1))) >> TRIG_STEP_BITS);
+}
+
+//
+// Function: trigSinMul
+//
+// Get value * sine of an angle, truncated towards zero
+//
+s16 trigSinMul(u16 angle, s16 value)
+{
+  u16 result;
+  u08 negative = MC_FALSE;
+
+  if (value < 0)
+  {
+    value = -value;
+    negative = MC_TRUE;
+  }
+  if (angle & 0x8000)
+    negative = !negative;
+
+  result = (u16)(((u32)value * trigSinAbs(angle)) >> 15);
+  if (negative == MC_TRUE)
+    return -(s16)result;
+  else
+    return (s16)result;
+}
@@ -0,0 +1,33 @@
+//*****************************************************************************
+// Filename : 'trig.h'
+// Title    : Fixed-point sine/cosine functions for MONOCHRON clocks
+//*****************************************************************************
+
+#ifndef TRIG_H
+#define TRIG_H
+
+#include "avrlibtypes.h"
+
+// An angle is a binary angle where a full circle is 65536 units, so it wraps
+// naturally in an u16. Angle 0 points upwards and increments clockwise when
+// used as dx = sin(angle) * r and dy = -cos(angle) * r on the lcd.
+#define TRIG_ANGLE_FULL		65536UL
+
+// Get the binary angle of n steps in a circle divided in steps
+#define TRIG_ANGLE(n, steps) \
+  ((u16)((TRIG_ANGLE_FULL * (n) + (steps) / 2) / (steps)))
+
+// Convert a constant to Q8.8 fixed point and a Q8.8 value to an integer
+// (truncated towards zero like a (s08) cast of a float)
+#define TRIG_Q88(f)		((s16)((f) * 256))
+#define TRIG_Q88_INT(q)		((s08)((q) / 256))
+
+// Get sine/cosine in Q1.15 fixed point
+s16 trigSin(u16 angle);
+s16 trigCos(u16 angle);
+
+// Get value * sine/cosine (truncated towards zero) in the fixed-point format
+// of value, being an integer, Q8.8 or anything else
+s16 trigSinMul(u16 angle, s16 value);
+s16 trigCosMul(u16 angle, s16 value);
+#endif